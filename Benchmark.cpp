@@ -0,0 +1,401 @@
+/* Benchmark.cpp
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Script for benchmarking the queries of string dictionaries (ranked or not)
+ * built with the library of Compressed String Dictionaries (libCSD). Every
+ * query is timed with the wall clock, and the throughput and the latency
+ * percentiles are reported for an increasing number of threads, as CSV or
+ * JSON.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _BENCHMARK_CPP
+#define _BENCHMARK_CPP
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/StringDictionary.h"
+#include "src/RankedStringDictionary.h"
+
+#define RUNS 3
+#define TOPK 10
+
+// Queries which can be benchmarked
+enum Operation {LOCATE, EXTRACT, LOCATEPREFIX, EXTRACTPREFIX, LOCATESUBSTR, EXTRACTSUBSTR, TOPKLOCATEPREFIX, TOPKEXTRACTPREFIX, TOPKINTERVAL};
+
+// The dictionary and the patterns of a benchmark
+struct Workload
+{
+	StringDictionary *dict;		// The dictionary (NULL if it is ranked)
+	RankedStringDictionary *rdict;	// The ranked dictionary (NULL if it is not)
+	Operation op;			// The query
+	const char *name;		// Name of the query in the report
+	uint k;				// Number of results of the top-k queries
+
+	vector<uchar*> strings;		// Patterns of the string queries
+	vector<uint> lengths;		// Their lengths
+	vector<size_t> ids;		// IDs of the extractions (beginnings of the intervals)
+	size_t intervalLen;		// Length of the intervals
+
+	size_t patterns() {return (op==EXTRACT || op==TOPKINTERVAL) ? ids.size() : strings.size();}
+};
+
+// Measures of a thread
+struct Measures
+{
+	vector<double> latencies;	// Latency of each query (in microseconds)
+	size_t results;			// Number of results retrieved
+	chrono::steady_clock::time_point start, end;	// Wall time of the measured runs
+};
+
+
+void checkDict()
+{
+	cerr << endl;
+	cerr << " ******************************************************************************** " << endl;
+	cerr << " *** Checks the given file because it does not represent any valid dictionary *** " << endl;
+	cerr << " ******************************************************************************** " << endl;
+	cerr << endl;
+}
+
+void checkFile()
+{
+	cerr << endl;
+	cerr << " ****************************************************************** " << endl;
+	cerr << " *** Checks the given path because it does not contain any file *** " << endl;
+	cerr << " ****************************************************************** " << endl;
+	cerr << endl;
+}
+
+void useBenchmark()
+{
+	cerr << endl;
+	cerr << " ******************************************************************************** " << endl;
+	cerr << " *** Benchmark script for the library of Compressed String Dictionaries (libCSD). *** " << endl;
+	cerr << " ******************************************************************************** " << endl;
+	cerr << endl;
+	cerr << " ----- benchmark <kind> <op> <in> <file> [<threads>] [<runs>] [<format>]" << endl;
+	cerr << endl;
+	cerr << " <kind> n : dictionary built with Build." << endl;
+	cerr << " <kind> r : ranked dictionary built with RankedBuild." << endl;
+	cerr << "    followed by 's' (e.g. rs), the RePair rule summaries are built on loading." << endl;
+	cerr << " <op> l : LOCATE (<file> of strings)." << endl;
+	cerr << " <op> e : EXTRACT (<file> of IDs)." << endl;
+	cerr << " <op> pl : LOCATE PREFIX (<file> of prefixes)." << endl;
+	cerr << " <op> pe : EXTRACT PREFIX (<file> of prefixes)." << endl;
+	cerr << " <op> sl : LOCATE SUBSTRING (<file> of substrings)." << endl;
+	cerr << " <op> se : EXTRACT SUBSTRING (<file> of substrings)." << endl;
+	cerr << " <op> pkl[<k>] : TOP K LOCATE PREFIX, only ranked (<file> of prefixes; k = " << TOPK << " by default)." << endl;
+	cerr << " <op> pke[<k>] : TOP K EXTRACT PREFIX, only ranked (<file> of prefixes; k = " << TOPK << " by default)." << endl;
+	cerr << " <op> i[<k>] : TOP K EXTRACT INTERVAL, only ranked (<file> of intervals; k = " << TOPK << " by default)." << endl;
+	cerr << " <in> : input file containing the compressed string dictionary." << endl;
+	cerr << " <file> : file from which the patterns are loaded (generated by Test or RankedTest)." << endl;
+	cerr << " <threads> : the queries are run with 1, 2, 4... up to <threads> threads (1 by default)." << endl;
+	cerr << " <runs> : times each thread runs all the patterns, after a warm-up run (" << RUNS << " by default)." << endl;
+	cerr << " <format> : 'csv' (by default) or 'json'." << endl;
+	cerr << " The threads share the dictionary, whose queries only read it." << endl;
+	cerr << endl;
+}
+
+bool parseOperation(char *opt, Workload *w)
+{
+	const char *suffix = NULL;
+
+	if (strcmp(opt, "l") == 0) { w->op = LOCATE; w->name = "locate"; }
+	else if (strcmp(opt, "e") == 0) { w->op = EXTRACT; w->name = "extract"; }
+	else if (strcmp(opt, "pl") == 0) { w->op = LOCATEPREFIX; w->name = "locatePrefix"; }
+	else if (strcmp(opt, "pe") == 0) { w->op = EXTRACTPREFIX; w->name = "extractPrefix"; }
+	else if (strcmp(opt, "sl") == 0) { w->op = LOCATESUBSTR; w->name = "locateSubstr"; }
+	else if (strcmp(opt, "se") == 0) { w->op = EXTRACTSUBSTR; w->name = "extractSubstr"; }
+	else if (strncmp(opt, "pkl", 3) == 0) { w->op = TOPKLOCATEPREFIX; w->name = "locateRankedPrefix"; suffix = opt+3; }
+	else if (strncmp(opt, "pke", 3) == 0) { w->op = TOPKEXTRACTPREFIX; w->name = "extractRankedPrefix"; suffix = opt+3; }
+	else if (opt[0] == 'i') { w->op = TOPKINTERVAL; w->name = "extractRankedInterval"; suffix = opt+1; }
+	else return false;
+
+	w->k = TOPK;
+	if (suffix != NULL && *suffix != '\0') w->k = atoi(suffix);
+	return w->k > 0;
+}
+
+bool loadPatterns(Workload *w, char *in)
+{
+	ifstream inPatterns(in);
+	if (!inPatterns.good()) return false;
+
+	uint maxlength = (w->rdict != NULL) ? w->rdict->maxLength() : w->dict->maxLength();
+	if (maxlength < 256) maxlength = 256;
+	char *line = new char[maxlength+1];
+
+	if (w->op == TOPKINTERVAL)
+	{
+		inPatterns.getline(line, maxlength);
+		w->intervalLen = atol(line);
+	}
+
+	while (true)
+	{
+		inPatterns.getline(line, maxlength);
+		uint len = strlen(line);
+
+		if (len == 0) break;
+
+		if (w->op == EXTRACT || w->op == TOPKINTERVAL) w->ids.push_back(atol(line));
+		else
+		{
+			uchar *str = new uchar[len+1];
+			memcpy(str, line, len+1);
+			w->strings.push_back(str);
+			w->lengths.push_back(len);
+		}
+	}
+
+	delete [] line;
+	inPatterns.close();
+	return w->patterns() > 0;
+}
+
+// Counts (and releases) the strings of an iterator
+template <typename Iterator> size_t drainStrings(Iterator *it)
+{
+	size_t results = 0;
+	if (it == NULL) return 0;
+
+	while (it->hasNext())
+	{
+		uint strLen;
+		uchar *str = it->next(&strLen);
+		if (str != NULL) delete [] str;
+		results++;
+	}
+
+	delete it;
+	return results;
+}
+
+// Counts the IDs of an iterator
+template <typename Iterator> size_t drainIds(Iterator *it)
+{
+	size_t results = 0;
+	if (it == NULL) return 0;
+
+	while (it->hasNext())
+	{
+		it->next();
+		results++;
+	}
+
+	delete it;
+	return results;
+}
+
+// Runs the j-th query of a workload, retrieving the number of results
+size_t query(Workload *w, size_t j)
+{
+	uint strLen;
+
+	if (w->rdict != NULL)
+	{
+		RankedStringDictionary *dict = w->rdict;
+		switch (w->op)
+		{
+			case LOCATE: return (dict->locate(w->strings[j], w->lengths[j]) != NORESULT) ? 1 : 0;
+			case EXTRACT:
+			{
+				uchar *str = dict->extract(w->ids[j], &strLen);
+				if (str == NULL) return 0;
+				delete [] str;
+				return 1;
+			}
+			case LOCATEPREFIX: return drainIds(dict->locatePrefix(w->strings[j], w->lengths[j]));
+			case EXTRACTPREFIX: return drainStrings(dict->extractPrefix(w->strings[j], w->lengths[j]));
+			case LOCATESUBSTR: return drainIds(dict->locateSubstr(w->strings[j], w->lengths[j]));
+			case EXTRACTSUBSTR: return drainStrings(dict->extractSubstr(w->strings[j], w->lengths[j]));
+			case TOPKLOCATEPREFIX: return drainIds(dict->locateRankedPrefix(w->strings[j], w->lengths[j], w->k));
+			case TOPKEXTRACTPREFIX: return drainStrings(dict->extractRankedPrefix(w->strings[j], w->lengths[j], w->k));
+			case TOPKINTERVAL: return drainStrings(dict->extractRankedInterval(w->ids[j], w->intervalLen, w->k));
+		}
+	}
+	else
+	{
+		StringDictionary *dict = w->dict;
+		switch (w->op)
+		{
+			case LOCATE: return (dict->locate(w->strings[j], w->lengths[j]) != NORESULT) ? 1 : 0;
+			case EXTRACT:
+			{
+				uchar *str = dict->extract(w->ids[j], &strLen);
+				if (str == NULL) return 0;
+				delete [] str;
+				return 1;
+			}
+			case LOCATEPREFIX: return drainIds(dict->locatePrefix(w->strings[j], w->lengths[j]));
+			case EXTRACTPREFIX: return drainStrings(dict->extractPrefix(w->strings[j], w->lengths[j]));
+			case LOCATESUBSTR: return drainIds(dict->locateSubstr(w->strings[j], w->lengths[j]));
+			case EXTRACTSUBSTR: return drainStrings(dict->extractSubstr(w->strings[j], w->lengths[j]));
+			default: return 0;
+		}
+	}
+	return 0;
+}
+
+// Runs all the patterns of a workload <runs> times (after a warm-up run),
+// starting at a different pattern in each thread
+void worker(Workload *w, size_t first, uint runs, Measures *m)
+{
+	size_t patterns = w->patterns();
+	m->results = 0;
+	m->latencies.reserve(patterns*runs);
+
+	for (size_t j=0; j<patterns; j++)
+		query(w, (first+j)%patterns);
+
+	m->start = chrono::steady_clock::now();
+	for (uint r=0; r<runs; r++)
+	{
+		for (size_t j=0; j<patterns; j++)
+		{
+			chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+			m->results += query(w, (first+j)%patterns);
+			chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+			m->latencies.push_back(chrono::duration<double, micro>(t1-t0).count());
+		}
+	}
+	m->end = chrono::steady_clock::now();
+}
+
+// Retrieves the p-quantile (nearest rank) of sorted latencies
+double percentile(vector<double> &latencies, double p)
+{
+	size_t rank = (size_t)ceil(p*latencies.size());
+	if (rank > 0) rank--;
+	return latencies[min(rank, latencies.size()-1)];
+}
+
+void runBenchmark(Workload *w, const char *dictName, uint maxThreads, uint runs, bool json)
+{
+	vector<uint> threadCounts;
+	for (uint t=1; t<maxThreads; t*=2) threadCounts.push_back(t);
+	threadCounts.push_back(maxThreads);
+
+	if (json) cout << "[" << endl;
+	else cout << "dictionary,operation,k,threads,queries,results,seconds,throughput,mean_us,p50_us,p99_us,p999_us,max_us" << endl;
+
+	for (uint c=0; c<threadCounts.size(); c++)
+	{
+		uint threads = threadCounts[c];
+		vector<Measures> measures(threads);
+		vector<thread> workers;
+
+		for (uint t=1; t<threads; t++)
+			workers.push_back(thread(worker, w, (w->patterns()*t)/threads, runs, &measures[t]));
+		worker(w, 0, runs, &measures[0]);
+		for (uint t=0; t<workers.size(); t++)
+			workers[t].join();
+
+		// The wall time goes from the first thread ending its warm-up run to the last one finishing
+		vector<double> latencies;
+		size_t results = 0;
+		double busy = 0;
+		chrono::steady_clock::time_point start = measures[0].start, end = measures[0].end;
+		for (uint t=0; t<threads; t++)
+		{
+			latencies.insert(latencies.end(), measures[t].latencies.begin(), measures[t].latencies.end());
+			results += measures[t].results;
+			start = min(start, measures[t].start);
+			end = max(end, measures[t].end);
+		}
+		for (size_t i=0; i<latencies.size(); i++) busy += latencies[i];
+		sort(latencies.begin(), latencies.end());
+
+		size_t queries = latencies.size();
+		double mean = busy/queries;
+		double measured = chrono::duration<double>(end-start).count();
+		double throughput = queries/measured;
+
+		if (json)
+		{
+			cout << "  {\"dictionary\": \"" << dictName << "\", \"operation\": \"" << w->name << "\", \"k\": " << w->k;
+			cout << ", \"threads\": " << threads << ", \"queries\": " << queries << ", \"results\": " << results;
+			cout << ", \"seconds\": " << measured << ", \"throughput\": " << throughput;
+			cout << ", \"mean_us\": " << mean << ", \"p50_us\": " << percentile(latencies, 0.5);
+			cout << ", \"p99_us\": " << percentile(latencies, 0.99) << ", \"p999_us\": " << percentile(latencies, 0.999);
+			cout << ", \"max_us\": " << latencies.back() << "}" << ((c+1 < threadCounts.size()) ? "," : "") << endl;
+		}
+		else
+		{
+			cout << dictName << "," << w->name << "," << w->k << "," << threads << "," << queries << "," << results << ",";
+			cout << measured << "," << throughput << "," << mean << "," << percentile(latencies, 0.5) << ",";
+			cout << percentile(latencies, 0.99) << "," << percentile(latencies, 0.999) << "," << latencies.back() << endl;
+		}
+	}
+
+	if (json) cout << "]" << endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+	if ((argc < 5) || (argc > 8)) { useBenchmark(); return 0; }
+
+	Workload w;
+	w.dict = NULL;
+	w.rdict = NULL;
+	w.intervalLen = 0;
+	if (!parseOperation(argv[2], &w)) { useBenchmark(); return 0; }
+
+	uint threads = (argc > 5) ? atoi(argv[5]) : 1;
+	uint runs = (argc > 6) ? atoi(argv[6]) : RUNS;
+	bool json = (argc > 7) && (strcmp(argv[7], "json") == 0);
+	if (threads < 1) threads = 1;
+	if (runs < 1) runs = 1;
+
+	ifstream in(argv[3]);
+	if (!in.good()) { checkFile(); return 0; }
+	in.close();
+
+	RePairOptions options;
+	options.summaries = (argv[1][1] == 's');
+
+	if (argv[1][0] == 'r') w.rdict = RankedStringDictionary::loadMapped(argv[3], options);
+	else if (w.op < TOPKLOCATEPREFIX) w.dict = StringDictionary::loadMapped(argv[3], options);
+	else { cerr << "The top k queries are only provided by ranked dictionaries" << endl; return 0; }
+	if ((w.dict == NULL) && (w.rdict == NULL)) { checkDict(); return 0; }
+
+	if (loadPatterns(&w, argv[4])) runBenchmark(&w, argv[3], threads, runs, json);
+	else checkFile();
+
+	for (size_t i=0; i<w.strings.size(); i++) delete [] w.strings[i];
+	delete w.dict;
+	delete w.rdict;
+}
+
+#endif  /* _BENCHMARK_CPP */
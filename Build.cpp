@@ -35,6 +35,7 @@ using namespace std;
 #include "src/StringDictionary.h"
 #include "src/iterators/IteratorDictStringPlain.h"
 #include "src/utils/LogSequence.h"
+#include "src/utils/MemoryUsage.h"
 
 
 void checkDict()
@@ -63,7 +64,13 @@ void useBuild()
 	cerr << " *** BUILD script for indexing string dictionaries in compressed space. *** " << endl;
 	cerr << " ************************************************************************** " << endl;
 	cerr << endl;
-	cerr << " ----- ./Build <type> <parameters> <in> <out>" << endl;
+	cerr << " ----- ./Build [-h<rules>] [-d<height>] [-l<length>] [-f<freq>] [-t<threads>] [-m<MB>] <type> <parameters> <in> <out>" << endl;
+	cerr << " -h<rules> : caches the expansion of the <rules> most referenced RePair rules (optional, e.g. -h4096)." << endl;
+	cerr << " -d<height> : builds RePair rules of at most <height> levels (optional, e.g. -d16)." << endl;
+	cerr << " -l<length> : builds RePair rules expanding to at most <length> symbols (optional, e.g. -l64)." << endl;
+	cerr << " -f<freq> : only replaces RePair pairs occurring at least <freq> times (optional, e.g. -f4)." << endl;
+	cerr << " -t<threads> : compresses RePair sequences in blocks with <threads> threads (optional, e.g. -t8)." << endl;
+	cerr << " -m<MB> : compresses RePair sequences within a memory budget of <MB> megabytes, which only covers RePair (optional, e.g. -m65536)." << endl;
 
 	cerr << " type: 1 => Build HASH dictionary" << endl;
 	cerr << " \t <compress_table> : '1' plain (HASH); '2' compressed (HASHB); '3' re-compressed (HASHBB)." << endl;
@@ -120,9 +127,27 @@ void useBuild()
 int 
 main(int argc, char* argv[])
 {
+	RePairOptions options;
+
+	while ((argc > 1) && (argv[1][0] == '-'))
+	{
+		switch (argv[1][1])
+		{
+			case 'h': options.hotRules = atoi(argv[1]+2); break;
+			case 'd': options.maxHeight = atoi(argv[1]+2); break;
+			case 'l': options.maxLength = atoi(argv[1]+2); break;
+			case 'f': options.minFreq = atoi(argv[1]+2); break;
+			case 't': options.threads = atoi(argv[1]+2); break;
+			case 'm': options.memoryBudget = (size_t)atoll(argv[1]+2) << 20; break;
+			default: useBuild(); return 0;
+		}
+		argc--; argv++;
+	}
+
 	if (argc > 1)
 	{
 		int type = atoi(argv[1]);
+		MemoryUsage::setReport(true);
 
 		switch (type)
 		{
@@ -162,45 +187,39 @@ main(int argc, char* argv[])
 			{
 				if (argc != 7) { useBuild(); break; }
 
-				ifstream in(argv[5]);
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[5]);
 
-				if (in.good())
+				if (it->good())
 				{
-
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint compresst = atoi(argv[2]);
 					uint overhead = atoi(argv[4]);
 
-					uchar *str = loadValue<uchar>(in, lenStr+1);
-					str[lenStr] = '\0';
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					StringDictionary *dict = NULL;
 					string filename = string(argv[6]);
 
 					if (argv[3][0] == 'h')
 					{
 						// Huffman compression
-						dict = new StringDictionaryHASHHF(it, lenStr, overhead, compresst);
+						dict = new StringDictionaryHASHHF(it, it->size(), overhead, compresst);
 						filename += string(".hashhf");
 					}
 					else
 					{
 						// RePair compression
-						dict = new StringDictionaryHASHRPF(it, lenStr, overhead, compresst);
+						if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+						dict = new StringDictionaryHASHRPF(it, it->size(), overhead, compresst, options);
 						filename += string(".hashrpf");
 					}
 
+					if (!dict->good()) { delete dict; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -209,43 +228,38 @@ main(int argc, char* argv[])
 			{
 				if (argc != 6) { useBuild(); break; }
 
-				ifstream in(argv[4]);
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[4]);
 
-				if (in.good())
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint overhead = atoi(argv[3]);
 
-					uchar *str = loadValue<uchar>(in, lenStr+1);
-					str[lenStr] = '\0';
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					StringDictionary *dict = NULL;
 					string filename = string(argv[5]);
 
 					if (argv[2][0] == 'h')
 					{
 						// Huffman compression
-						dict = new StringDictionaryHASHUFFDAC(it, lenStr, overhead);
+						dict = new StringDictionaryHASHUFFDAC(it, it->size(), overhead);
 						filename += string(".hashuffdac");
 					}
 					else
 					{
 						// RePair compression
-						dict = new StringDictionaryHASHRPDAC(it, lenStr, overhead);
+						if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+						dict = new StringDictionaryHASHRPDAC(it, it->size(), overhead, options);
 						filename += string(".hashrpdac");
 					}
 
+					if (!dict->good()) { delete dict; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -254,19 +268,11 @@ main(int argc, char* argv[])
 			{
 				if (argc != 6) { useBuild(); break; }
 
-				ifstream in(argv[4]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[4]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint bucketsize = atoi(argv[3]);
 
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					StringDictionary *dict = NULL;
 					string filename = string(argv[5]);
 
@@ -279,7 +285,8 @@ main(int argc, char* argv[])
 					else if (argv[2][0] == 'r')
 					{
 						// RePair compression
-						dict = new StringDictionaryRPFC(it, bucketsize);
+						if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+						dict = new StringDictionaryRPFC(it, bucketsize, options);
 						filename += string(".rpfc");
 					}
 					else
@@ -289,12 +296,15 @@ main(int argc, char* argv[])
 						return 0;
 					}
 
+					if (!dict->good()) { delete dict; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -303,19 +313,11 @@ main(int argc, char* argv[])
 			{
 				if (argc != 6) { useBuild(); break; }
 
-				ifstream in(argv[4]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[4]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint bucketsize = atoi(argv[3]);
 
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					StringDictionary *dict = NULL;
 					string filename = string(argv[5]);
 
@@ -340,7 +342,8 @@ main(int argc, char* argv[])
 						case 'r':
 						{
 							// RePair compression
-							dict = new StringDictionaryRPHTFC(it, bucketsize);
+							if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+							dict = new StringDictionaryRPHTFC(it, bucketsize, options);
 							filename += string(".rphtfc");
 							break;
 						}
@@ -353,12 +356,15 @@ main(int argc, char* argv[])
 						}
 					}
 
+					if (!dict->good()) { delete dict; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -367,26 +373,22 @@ main(int argc, char* argv[])
 			{
 				if (argc != 4) { useBuild(); break; }
 
-				ifstream in(argv[2]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
-					uchar *str = loadValue<uchar>(in, lenStr);
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
-					in.close();
-
-					StringDictionary *dict = new StringDictionaryRPDAC(it);
+					if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+					StringDictionary *dict = new StringDictionaryRPDAC(it, options);
 					string filename = string(argv[3])+string(".rpdac");
 
+					if (!dict->good()) { delete dict; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
  					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -395,17 +397,9 @@ main(int argc, char* argv[])
 			{
 				if (argc != 7) { useBuild(); break; }
 
-				ifstream in(argv[5]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[5]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					StringDictionary *dict = NULL;
 					string filename;
 
@@ -434,12 +428,14 @@ main(int argc, char* argv[])
 						break;
 					}
 
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
  					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
@@ -452,7 +448,7 @@ main(int argc, char* argv[])
 				if (in.good())
 				{
 					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
+					size_t lenStr = in.tellg()/sizeof(uchar);
 					in.seekg(0,ios_base::beg);
 
 					uchar *str = loadValue<uchar>(in, lenStr);
@@ -484,9 +480,11 @@ main(int argc, char* argv[])
 						break;
 					}
 
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
  					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 				}
 				else checkFile();
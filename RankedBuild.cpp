@@ -33,6 +33,7 @@ using namespace std;
 #include "src/RankedStringDictionary.h"
 #include "src/iterators/IteratorDictStringPlain.h"
 #include "src/utils/LogSequence.h"
+#include "src/utils/MemoryUsage.h"
 
 
 void checkDict()
@@ -61,11 +62,18 @@ void useBuild()
 	cerr << " *** BUILD script for indexing ranked string dictionaries in compressed space. *** " << endl;
 	cerr << " ************************************************************************** " << endl;
 	cerr << endl;
-	cerr << " ----- ./RankedBuild <type> <parameters> <in> <out>" << endl;
+	cerr << " ----- ./RankedBuild [-h<rules>] [-d<height>] [-l<length>] [-f<freq>] [-t<threads>] [-m<MB>] <type> <parameters> <in> <out>" << endl;
+	cerr << " -h<rules> : caches the expansion of the <rules> most referenced RePair rules (optional, e.g. -h4096)." << endl;
+	cerr << " -d<height> : builds RePair rules of at most <height> levels (optional, e.g. -d16)." << endl;
+	cerr << " -l<length> : builds RePair rules expanding to at most <length> symbols (optional, e.g. -l64)." << endl;
+	cerr << " -f<freq> : only replaces RePair pairs occurring at least <freq> times (optional, e.g. -f4)." << endl;
+	cerr << " -t<threads> : compresses RePair sequences in blocks with <threads> threads (optional, e.g. -t8)." << endl;
+	cerr << " -m<MB> : compresses RePair sequences within a memory budget of <MB> megabytes, which only covers RePair (optional, e.g. -m65536)." << endl;
 
 	cerr << " type: 1 => Build SIMPLE RANKED PFC dictionary" << endl;
 	cerr << " \t <compress> : 'p' for plain (uncompressed) representation; 'r' for RePair compression" << endl;
 	cerr << " \t <bucketsize> : number of strings per bucket." << endl;
+	cerr << " \t [<top>] : number of most popular IDs also stored uncompressed (optional, 0 by default)." << endl;
 	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
 	cerr << " \t <out> : output file for storing the dictionary." << endl;
 	cerr << endl;
@@ -74,17 +82,20 @@ void useBuild()
 	cerr << " \t <compress> : tecnique used for internal string compression." << endl;
 	cerr << " \t              't' for HuTucker; 'h' for Huffman; 'r' for RePair compression." << endl;
 	cerr << " \t <bucketsize> : number of strings per bucket." << endl;
+	cerr << " \t [<top>] : number of most popular IDs also stored uncompressed (optional, 0 by default)." << endl;
 	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
 	cerr << " \t <out> : output file for storing the dictionary." << endl;
 	cerr << endl;
 
 	cerr << " type: 3 => Build SIMPLE RANKED RPDAC dictionary" << endl;
+	cerr << " \t [<top>] : number of most popular IDs also stored uncompressed (optional, 0 by default)." << endl;
 	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
 	cerr << " \t <out> : output file for storing the dictionary." << endl;
 	cerr << endl;
 	
 	cerr << " type: 4 => Build RANKED HASRPDAC dictionary" << endl;
 	cerr << " \t <overhead> : hash table overhead (in percentage)." << endl;
+	cerr << " \t [<top>] : number of most popular IDs also stored uncompressed (optional, 0 by default)." << endl;
 	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
 	cerr << " \t <out> : output file for storing the dictionary." << endl;
 	cerr << endl;
@@ -92,18 +103,52 @@ void useBuild()
 	
 	cerr << " type: 5 => Build RANKED RPDAC dictionary" << endl;
 	cerr << " \t <bucketsize> : number of strings per bucket." << endl;
+	cerr << " \t [<threads>] : number of threads used for building (optional, 1 by default)." << endl;
+	cerr << " \t [<top>] : number of most popular IDs also stored uncompressed (optional, 0 by default; requires <threads>)." << endl;
+	cerr << " \t [<sample>] : one of every <sample> bucket headers is stored uncompressed for the searches (optional, 0 by default; requires <top>)." << endl;
 	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
 	cerr << " \t <out> : output file for storing the dictionary." << endl;
 	cerr << endl;
+	
+	
+	cerr << " type: 6 => Build RANKED RMQ dictionary" << endl;
+	cerr << " \t <in> : input file containing the set of '\\0'-delimited strings." << endl;
+	cerr << " \t <out> : output file for storing the dictionary." << endl;
+	cerr << endl;
+	
+	
+	cerr << " type: 7 => Re-rank a RANKED RPDAC dictionary (without compressing the strings again)" << endl;
+	cerr << " \t <dict> : file containing the RANKED RPDAC dictionary." << endl;
+	cerr << " \t <ids> : text file with the new ID of each string (one per line, in the order of the current IDs)." << endl;
+	cerr << " \t <out> : output file for storing the dictionary." << endl;
+	cerr << endl;
 }
 
 
 int
 main(int argc, char* argv[])
 {
+	RePairOptions options;
+
+	while ((argc > 1) && (argv[1][0] == '-'))
+	{
+		switch (argv[1][1])
+		{
+			case 'h': options.hotRules = atoi(argv[1]+2); break;
+			case 'd': options.maxHeight = atoi(argv[1]+2); break;
+			case 'l': options.maxLength = atoi(argv[1]+2); break;
+			case 'f': options.minFreq = atoi(argv[1]+2); break;
+			case 't': options.threads = atoi(argv[1]+2); break;
+			case 'm': options.memoryBudget = (size_t)atoll(argv[1]+2) << 20; break;
+			default: useBuild(); return 0;
+		}
+		argc--; argv++;
+	}
+
 	if (argc > 1)
 	{
 		int type = atoi(argv[1]);
+		MemoryUsage::setReport(true);
 
 		switch (type)
 		{
@@ -141,164 +186,223 @@ main(int argc, char* argv[])
 
 			case 1: //simplePFC
 			{
-				if (argc != 6) { useBuild(); break; }
+				if ((argc != 6) && (argc != 7)) { useBuild(); break; }
+				uint top = 0;
+				if (argc == 7) top = atoi(argv[4]);
 
-				ifstream in(argv[4]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[argc-2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint bucketsize = atoi(argv[3]);
 
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					RankedStringDictionary *dict = NULL;
-					string filename = string(argv[5]);
+					string filename = string(argv[argc-1]);
 
-                    dict = new RankedStringDictionarySimple(it, bucketsize, 1, argv[2][0]);
+					if ((argv[2][0] == 'r') && !RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+                    dict = new RankedStringDictionarySimple(it, bucketsize, 1, argv[2][0], top, options);
                     filename += string(".RDS");
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 					delete it;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
 
 			case 2: //simpleHTFC
 			{
-				if (argc != 6) { useBuild(); break; }
+				if ((argc != 6) && (argc != 7)) { useBuild(); break; }
+				uint top = 0;
+				if (argc == 7) top = atoi(argv[4]);
 
-				ifstream in(argv[4]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[argc-2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
 					uint bucketsize = atoi(argv[3]);
 
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					RankedStringDictionary *dict = NULL;
-					string filename = string(argv[5]);
+					string filename = string(argv[argc-1]);
 
-                    dict = new RankedStringDictionarySimple(it, bucketsize, 2, argv[2][0]);
+					if ((argv[2][0] == 'r') && !RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+                    dict = new RankedStringDictionarySimple(it, bucketsize, 2, argv[2][0], top, options);
                     filename += string(".RDS");
 
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 					delete it;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
 
 			case 3: //simpleRPDAC
 			{
-				if (argc != 4) { useBuild(); break; }
+				if ((argc != 4) && (argc != 5)) { useBuild(); break; }
+				uint top = 0;
+				if (argc == 5) top = atoi(argv[2]);
 
-				ifstream in(argv[2]);
-				if (in.good())
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[argc-2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					RankedStringDictionary *dict = NULL;
-					string filename = string(argv[3]);
+					string filename = string(argv[argc-1]);
 
 					uchar aux = ' ';
 					uint auxbucketsize = 0;
-                    dict = new RankedStringDictionarySimple(it, auxbucketsize, 3, aux);
+					if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+                    dict = new RankedStringDictionarySimple(it, auxbucketsize, 3, aux, top, options);
                     filename += string(".RDS");
 
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 					delete it;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
 			
 			case 4: //HASHRPDAC
 			{
-				if (argc != 5) { useBuild(); break; }
-				ifstream in(argv[3]);
-				if (in.good())
+				if ((argc != 5) && (argc != 6)) { useBuild(); break; }
+				uint top = 0;
+				if (argc == 6) top = atoi(argv[3]);
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[argc-2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					RankedStringDictionary *dict = NULL;
-					string filename = string(argv[4]);
+					string filename = string(argv[argc-1]);
 					uint overhead = atoi(argv[2]);
 
 					uchar aux = ' ';
-                    dict = new RankedStringDictionarySimple(it, overhead, 4, aux);
+					if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+                    dict = new RankedStringDictionarySimple(it, overhead, 4, aux, top, options);
                     filename += string(".RDS");
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 					delete it;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
 
 				break;
 			}
 			
 			case 5: //RPDAC
 			{
-				if (argc != 5) { useBuild(); break; }
-				ifstream in(argv[3]);
-				if (in.good())
+				if ((argc < 5) || (argc > 8)) { useBuild(); break; }
+				uint threads = 1, top = 0, sample = 0;
+				if (argc >= 6) threads = atoi(argv[3]);
+				if (argc >= 7) top = atoi(argv[4]);
+				if (argc == 8) sample = atoi(argv[5]);
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[argc-2]);
+				if (it->good())
 				{
-					in.seekg(0,ios_base::end);
-					uint lenStr = in.tellg()/sizeof(uchar);
-					in.seekg(0,ios_base::beg);
-					uchar *str = loadValue<uchar>(in, lenStr);
-					in.close();
-					IteratorDictString *it = new IteratorDictStringPlain(str, lenStr);
 					RankedStringDictionary *dict = NULL;
-					string filename = string(argv[4]);
+					string filename = string(argv[argc-1]);
 					uint bucketsize = atoi(argv[2]);
 
-                    dict = new RankedStringDictionaryRPDAC(it, bucketsize);
+					if (!RePair::fitsBudget(it->size(), options)) { delete it; return 1; }
+                    dict = new RankedStringDictionaryRPDAC(it, bucketsize, threads, top, sample, options);
                     filename += string(".RDRPDAC");
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
 					ofstream out((char*)filename.c_str());
-					dict->save(out);
+					dict->saveMapped(out);
 					out.close();
+					MemoryUsage::phase("save");
 					delete dict;
 					delete it;
 				}
-				else checkFile();
+				else { checkFile(); delete it; }
+
+				break;
+			}
+
+			case 6: //RMQ
+			{
+				if (argc != 4) { useBuild(); break; }
+				IteratorDictStringMapped *it = new IteratorDictStringMapped(argv[2]);
+				if (it->good())
+				{
+					RankedStringDictionary *dict = NULL;
+					string filename = string(argv[3]);
+
+					dict = new RankedStringDictionaryRMQ(it, options);
+					filename += string(".RDRMQ");
+					if (!dict->good()) { delete dict; delete it; return 1; }
+					MemoryUsage::phase("dictionary");
+					ofstream out((char*)filename.c_str());
+					dict->saveMapped(out);
+					out.close();
+					MemoryUsage::phase("save");
+					delete dict;
+					delete it;
+				}
+				else { checkFile(); delete it; }
 
 				break;
 			}
 
+			case 7: //re-rank RPDAC
+			{
+				if (argc != 5) { useBuild(); break; }
+				ifstream in(argv[2]);
+				if (!in.good()) { checkFile(); break; }
+				RankedStringDictionary *dict = RankedStringDictionary::load(in);
+				in.close();
+				RankedStringDictionaryRPDAC *rdict = dynamic_cast<RankedStringDictionaryRPDAC*>(dict);
+				if (rdict == NULL)
+				{
+					cerr << "Only RANKED RPDAC dictionaries can be re-ranked" << endl;
+					delete dict;
+					break;
+				}
+
+				ifstream inIds(argv[3]);
+				if (!inIds.good()) { checkFile(); delete dict; break; }
+				size_t n = dict->numElements();
+				size_t *newIds = new size_t[n];
+				for (size_t i=0; i<n; i++)
+					if (!(inIds >> newIds[i])) newIds[i] = 0;
+				inIds.close();
+
+				if (rdict->rerank(newIds))
+				{
+					string filename = string(argv[4]);
+					filename += string(".RDRPDAC");
+					MemoryUsage::phase("dictionary");
+					ofstream out((char*)filename.c_str());
+					dict->saveMapped(out);
+					out.close();
+					MemoryUsage::phase("save");
+				}
+				delete [] newIds;
+				delete dict;
+				break;
+			}
+
 			default:
 			{
 				useBuild();
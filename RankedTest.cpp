@@ -69,14 +69,22 @@ void useTest()
 	cerr << endl;
 	cerr << " <mode> r : Run the given test." << endl;
 	cerr << "    <opt> l : LOCATE test." << endl;
+	cerr << "    <opt> lb : LOCATE test searching all the patterns in a single batch (only RPDAC)." << endl;
 	cerr << "    <opt> e : EXTRACT test." << endl;
+	cerr << "    <opt> ei : EXTRACT test decoding into a reused buffer." << endl;
 	cerr << "    <opt> pl : LOCATE PREFIX test." << endl;
 	cerr << "    <opt> pe : EXTRACT PREFIX test." << endl;
 	cerr << "    <opt> pkl : TOP K LOCATE PREFIX test (K = 2, 4, 8, 16, 32, 64 & 128)." << endl;
 	cerr << "    <opt> pke : TOP K EXTRACT PREFIX test (K = 2, 4, 8, 16, 32, 64 & 128)." << endl;
+	cerr << "    <opt> pks : TOP K LOCATE PREFIX test typing each pattern char by char in a session (only RPDAC)." << endl;
+	cerr << "    <opt> pkc : TOP K EXTRACT PREFIX test reusing a query context (only RPDAC)." << endl;
 	cerr << "    <opt> i : TOP K EXTRACT INTERVAL test (K = 2, 4, 8, 16, 32, 64 & 128)." << endl;
 	cerr << "    <opt> sl : LOCATE SUBSTRING test." << endl;
 	cerr << "    <opt> se : EXTRACT SUBSTRING test." << endl;
+	cerr << " <mode> c : Compare the TOP K LOCATE PREFIX times (K = 2, 4, 8, 16, 32, 64 & 128) and results of two dictionaries." << endl;
+	cerr << "    <opt> file containing the second dictionary (e.g. RMQ against RPDAC)." << endl;
+	cerr << " <mode> x : Export all the strings to <file> (one per line)." << endl;
+	cerr << "    <opt> i<threads> (in ID order) or l<threads> (in alphabetical order), e.g. l4." << endl;
 	cerr << " <mode> g : Generate the basic testbed." << endl;
 	cerr << "    <opt> number of patterns to be generated." << endl;
 	cerr << " <mode> p : Generate the prefix testbed." << endl;
@@ -90,6 +98,26 @@ void useTest()
 	cerr << endl;
 }
 
+void writeString(size_t index, uchar *str, uint strLen, void *data)
+{
+	ofstream *out = (ofstream*)data;
+	if (str != NULL) out->write((char*)str, strLen);
+	out->put('\n');
+}
+
+void runExport(RankedStringDictionary *dict, bool lexicographic, uint threads, char* file)
+{
+	ofstream out(file);
+	if (!out.good()) { checkFile(); return; }
+
+	double t0 = getTime ();
+	bool exported = dict->exportTable(writeString, &out, lexicographic, threads);
+	double t1 = (getTime () - t0);
+	out.close();
+
+	if (exported) cout << dict->numElements() << " strings exported in " << (t1*SEC_TIME_DIVIDER) << " " << SEC_TIME_UNIT << endl;
+}
+
 void runLocate(RankedStringDictionary *dict, char* in)
 {
 	ifstream inStrings(in);
@@ -141,7 +169,61 @@ void runLocate(RankedStringDictionary *dict, char* in)
 	for (uint i=0; i<patterns; i++) delete [] strings[i];
 }
 
-void runExtract(RankedStringDictionary *dict, char* in)
+void runLocateBatch(RankedStringDictionary *dict, char* in)
+{
+	RankedStringDictionaryRPDAC *rdict = dynamic_cast<RankedStringDictionaryRPDAC*>(dict);
+	if (rdict == NULL)
+	{
+		cerr << "This dictionary does not provide batched locates" << endl;
+		return;
+	}
+
+	ifstream inStrings(in);
+
+	vector<uchar*> strings;
+	vector<uint> lengths;
+	uint maxlength = dict->maxLength()+1;
+
+	while (true)
+	{
+		uchar *str = new uchar[maxlength+1];
+		inStrings.getline((char*)str, maxlength);
+		uint len = strlen((char*)str);
+
+		if (len == 0) { delete [] str; break; }
+
+		strings.push_back(str);
+		lengths.push_back(len);
+
+	}
+
+	inStrings.close();
+
+	uint patterns = strings.size();
+	size_t *ids = new size_t[patterns];
+	double t0, t1, total=0;
+
+	for (uint i=1; i<=RUNS; i++)
+	{
+		t0 = getTime ();
+		rdict->locateBatch(strings.data(), lengths.data(), patterns, ids);
+
+		t1 = (getTime () - t0);
+		total += t1;
+
+		sleep(5);
+	}
+
+	double avgrun = total/RUNS;
+	double avgpattern = avgrun/patterns;
+
+	cout << (avgpattern*MCSEC_TIME_DIVIDER) << endl;
+	
+	delete [] ids;
+	for (uint i=0; i<patterns; i++) delete [] strings[i];
+}
+
+void runExtract(RankedStringDictionary *dict, char* in, bool into=false)
 {
 	ifstream inIds(in);
 	vector<uint> ids;
@@ -161,14 +243,22 @@ void runExtract(RankedStringDictionary *dict, char* in)
 	double t0, t1, total=0;
 	uint strLen;
 
+	// The strings can be extracted into a single buffer
+	size_t capacity = dict->extractCapacity();
+	uchar *buffer = new uchar[capacity];
+
 	for (uint i=1; i<=RUNS; i++)
 	{
 		t0 = getTime ();
 
 		for (uint j=1; j<patterns; j++)
 		{
-			uchar *str = dict->extract(ids[j], &strLen);
-			delete [] str;
+			if (into) dict->extractInto(ids[j], buffer, capacity);
+			else
+			{
+				uchar *str = dict->extract(ids[j], &strLen);
+				delete [] str;
+			}
 		}
 
 		t1 = (getTime () - t0);
@@ -186,6 +276,8 @@ void runExtract(RankedStringDictionary *dict, char* in)
 	//cout << ";;;" << (avgrun*SEC_TIME_DIVIDER);
 	//cout << ";;;" << (avgpattern*MCSEC_TIME_DIVIDER) << " " << MCSEC_TIME_UNIT << endl;
 	cout << avgpattern*MCSEC_TIME_DIVIDER << endl;
+
+	delete [] buffer;
 }
 
 void runLocatePrefix(RankedStringDictionary *dict, char* in)
@@ -378,6 +470,156 @@ void runTopKLocatePrefix(RankedStringDictionary *dict, char* in)
 }
 
 
+void runCompareTopK(RankedStringDictionary *dict, RankedStringDictionary *other, char* in)
+{
+	ifstream inStrings(in);
+
+	vector<uchar*> strings;
+	vector<uint> lengths;
+	uint maxlength = max(dict->maxLength(), other->maxLength());
+
+	while (true)
+	{
+		uchar *str = new uchar[maxlength+1];
+		inStrings.getline((char*)str, maxlength);
+		uint len = strlen((char*)str);
+
+		if (len == 0) { delete [] str; break; }
+
+		strings.push_back(str);
+		lengths.push_back(len);
+
+	}
+
+	uint patterns = strings.size();
+	RankedStringDictionary *dicts[2] = {dict, other};
+
+	//Repeat for k=2,4,8,16,32,64,128
+	uint k=1;
+	while(k<128)
+	{
+		k*=2;
+		double times[2];
+		for (uint d=0; d<2; d++)
+		{
+			double t0, total=0;
+			for (uint i=1; i<=RUNS; i++)
+			{
+				t0 = getTime ();
+				for (uint j=0; j<patterns; j++)
+				{
+					IteratorRankedDictID *it = dicts[d]->locateRankedPrefix(strings[j], lengths[j], k);
+					if (it == NULL) continue;
+					while (it->hasNext()) it->next();
+					delete it;
+				}
+				total += (getTime () - t0);
+			}
+			times[d] = total/RUNS/patterns;
+		}
+
+		//both dictionaries must return the same IDs
+		size_t mismatches = 0;
+		for (uint j=0; j<patterns; j++)
+		{
+			IteratorRankedDictID *it1 = dict->locateRankedPrefix(strings[j], lengths[j], k);
+			IteratorRankedDictID *it2 = other->locateRankedPrefix(strings[j], lengths[j], k);
+			bool next1 = (it1 != NULL) && it1->hasNext();
+			bool next2 = (it2 != NULL) && it2->hasNext();
+			while (next1 && next2)
+			{
+				if (it1->next() != it2->next()) { mismatches++; break; }
+				next1 = it1->hasNext();
+				next2 = it2->hasNext();
+			}
+			if (next1 != next2) mismatches++;
+			delete it1;
+			delete it2;
+		}
+
+		cout << "K="<<k;
+		cout << ";;;" << (times[0]*MCSEC_TIME_DIVIDER) << " ; " << (times[1]*MCSEC_TIME_DIVIDER) << " ; " << MCSEC_TIME_UNIT;
+		cout << " ; speedup ; " << (times[0]/times[1]) << " ; mismatches ; " << mismatches << endl;
+	}
+
+	for (uint i=0; i<patterns; i++) delete [] strings[i];
+}
+
+void runTopKSessionPrefix(RankedStringDictionary *dict, char* in)
+{
+	RankedStringDictionaryRPDAC *rdict = dynamic_cast<RankedStringDictionaryRPDAC*>(dict);
+	if (rdict == NULL)
+	{
+		cerr << "This dictionary does not provide prefix sessions" << endl;
+		return;
+	}
+
+	ifstream inStrings(in);
+
+	vector<uchar*> strings;
+	vector<uint> lengths;
+	uint maxlength = dict->maxLength();
+
+	while (true)
+	{
+		uchar *str = new uchar[maxlength+1];
+		inStrings.getline((char*)str, maxlength);
+		uint len = strlen((char*)str);
+
+		if (len == 0) { delete [] str; break; }
+
+		strings.push_back(str);
+		lengths.push_back(len);
+
+	}
+
+	uint patterns = strings.size();
+	double t0, t1, total=0;
+	size_t keystrokes;
+
+	//Repeat for k=2,4,8,16,32,64,128
+	uint k=1;
+	while(k<128)
+	{
+		k*=2;
+		total=0;
+		for (uint i=1; i<=RUNS; i++)
+		{
+			keystrokes = 0;
+			t0 = getTime ();
+
+			for (uint j=0; j<patterns; j++)
+			{
+				//each pattern is typed char by char in its own session
+				RankedPrefixSession session;
+				for (uint l=1; l<=lengths[j]; l++)
+				{
+					IteratorRankedDictID *it = rdict->locateRankedPrefix(&session, strings[j], l, k);
+
+					while (it->hasNext()) it->next();
+
+					delete it;
+					keystrokes++;
+				}
+			}
+
+			t1 = (getTime () - t0);
+			total += t1;
+
+			sleep(5);
+		}
+
+		double avgrun = total/RUNS;
+		double avgkeystroke = avgrun/keystrokes;
+
+		cout << "K="<<k;
+		cout << ";;;" << (avgkeystroke*MCSEC_TIME_DIVIDER) << " ; " << MCSEC_TIME_UNIT << " per keystroke ; keystrokes ; "<<keystrokes<<endl;
+	}
+
+	for (uint i=0; i<patterns; i++) delete [] strings[i];
+}
+
+
 void runTopKExtractPrefix(RankedStringDictionary *dict, char* in)
 {
 	ifstream inStrings(in);
@@ -450,17 +692,96 @@ void runTopKExtractPrefix(RankedStringDictionary *dict, char* in)
 }
 
 
+void runTopKContextPrefix(RankedStringDictionary *dict, char* in)
+{
+	RankedStringDictionaryRPDAC *rdict = dynamic_cast<RankedStringDictionaryRPDAC*>(dict);
+	if (rdict == NULL)
+	{
+		cerr << "This dictionary does not provide query contexts" << endl;
+		return;
+	}
+	RankedQueryContext context;
+
+	ifstream inStrings(in);
+
+	vector<uchar*> strings;
+	vector<uint> lengths;
+	uint maxlength = dict->maxLength();
+
+	while (true)
+	{
+		uchar *str = new uchar[maxlength+1];
+		inStrings.getline((char*)str, maxlength);
+		uint len = strlen((char*)str);
+
+		if (len == 0) { delete [] str; break; }
+
+		strings.push_back(str);
+		lengths.push_back(len);
+
+	}
+
+	uint patterns = strings.size();
+	double t0, t1, total=0;
+	size_t extracted;
+	
+	//Repeat for k=2,4,8,16,32,64,128
+	uint k=1;
+	while(k<128)
+	{
+		k*=2;
+		for (uint i=1; i<=RUNS; i++)
+		{
+			extracted = 0;
+			t0 = getTime ();
+
+			for (uint j=0; j<patterns; j++)
+			{
+
+				IteratorRankedDictString *it = rdict->extractRankedPrefix(NULL, strings[j], lengths[j], k, &context);
+			
+				while (it->hasNext())
+				{
+					uint strLen;
+					it->next(&strLen); //the string is in the context
+					extracted++;
+				}
+				
+				delete it;
+			}
+
+			t1 = (getTime () - t0);
+			//cout << (t1*SEC_TIME_DIVIDER) << " ";
+			total += t1;
+
+			sleep(5);
+		}
+		
+		double avgrun = total/RUNS;
+		double avgpattern = avgrun/extracted;
+
+		cout << "K="<<k;
+		//cout << ";;;" << (total*SEC_TIME_DIVIDER);
+		//cout << ";;;" << (avgrun*SEC_TIME_DIVIDER);
+		cout << ";;;" << (avgpattern*MCSEC_TIME_DIVIDER) << " ; " << MCSEC_TIME_UNIT << " ; extracted ; "<<extracted<<endl;
+		//cout << " " << (avgpattern*MCSEC_TIME_DIVIDER) << "  " << extracted << endl<<endl;
+	}
+	
+	for (uint i=0; i<patterns; i++) delete [] strings[i];
+}
+
+
 void runTopKExtractInterval(RankedStringDictionary *dict, char* in)
 {
 	ifstream inStrings(in);
 
-	vector<uint> beginnings;
+	vector<size_t> beginnings;
 	vector<uint> lengths;
 	uint maxlength = dict->maxLength();
 
 	char *intervalLenStr = new char[maxlength+1];
 	inStrings.getline((char*)intervalLenStr, maxlength);
-	uint intervalLen = atoi(intervalLenStr);
+	size_t intervalLen = atol(intervalLenStr);
 	delete [] intervalLenStr;
 	while (true)
 	{
@@ -470,7 +791,7 @@ void runTopKExtractInterval(RankedStringDictionary *dict, char* in)
 
 		if (len == 0) { delete [] str; break; }
 
-		beginnings.push_back(atoi(str));
+		beginnings.push_back(atol(str));
 		lengths.push_back(len);
 		delete [] str;
 
@@ -829,7 +1150,7 @@ main(int argc, char* argv[])
 		ifstream in(argv[3]);
 		if (in.good())
 		{
-			RankedStringDictionary *dict = RankedStringDictionary::load(in);
+			RankedStringDictionary *dict = RankedStringDictionary::loadMapped(argv[3]);
 			in.close();
 			if (dict == NULL) { checkDict(); exit(0); }
 
@@ -847,13 +1168,16 @@ main(int argc, char* argv[])
 					{
 						case 'l':
 						{
-							runLocate(dict, argv[4]);
+							if (argv[2][1] == 'b')
+								runLocateBatch(dict, argv[4]);
+							else
+								runLocate(dict, argv[4]);
 							break;
 						}
 
 						case 'e':
 						{
-							runExtract(dict, argv[4]);
+							runExtract(dict, argv[4], argv[2][1] == 'i');
 							break;
 						}
 
@@ -865,6 +1189,10 @@ main(int argc, char* argv[])
 								runExtractPrefix(dict, argv[4]);
 							else if(argv[2][2] == 'l')
 								runTopKLocatePrefix(dict,argv[4]);
+							else if(argv[2][2] == 's')
+								runTopKSessionPrefix(dict,argv[4]);
+							else if(argv[2][2] == 'c')
+								runTopKContextPrefix(dict,argv[4]);
 							else
 								runTopKExtractPrefix(dict,argv[4]);
 
@@ -896,6 +1224,26 @@ main(int argc, char* argv[])
 					break;
 				}
 
+				case 'c':
+				{
+					ifstream inOther(argv[2]);
+					if (!inOther.good()) { checkFile(); break; }
+					RankedStringDictionary *other = RankedStringDictionary::load(inOther);
+					inOther.close();
+					if (other == NULL) { checkDict(); break; }
+
+					runCompareTopK(dict, other, argv[4]);
+					delete other;
+					break;
+				}
+
+				case 'x':
+				{
+					uint threads = atoi(argv[2]+1);
+					runExport(dict, argv[2][0] == 'l', (threads > 0) ? threads : 1, argv[4]);
+					break;
+				}
+
 				case 'g':
 				{
 					uint patterns = atoi(argv[2]);
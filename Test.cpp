@@ -72,6 +72,8 @@ void useTest()
 	cerr << " <mode> r : Run the given test." << endl;
 	cerr << "    <opt> l : LOCATE test." << endl;
 	cerr << "    <opt> e : EXTRACT test." << endl;
+	cerr << "    <opt> ei : EXTRACT test decoding into a reused buffer." << endl;
+	cerr << "    <opt> eb : EXTRACT test decoding all the IDs in a single batch." << endl;
 	cerr << "    <opt> pl : LOCATE PREFIX test." << endl;
 	cerr << "    <opt> pe : EXTRACT PREFIX test." << endl;
 	cerr << "    <opt> sl : LOCATE SUBSTRING test." << endl;
@@ -138,7 +140,7 @@ void runLocate(StringDictionary *dict, char* in)
 	for (uint i=0; i<patterns; i++) delete [] strings[i];	
 }
 
-void runExtract(StringDictionary *dict, char* in)
+void runExtract(StringDictionary *dict, char* in, bool into=false)
 {
 	ifstream inIds(in);
 	vector<uint> ids;
@@ -158,14 +160,22 @@ void runExtract(StringDictionary *dict, char* in)
 	double t0, t1, total=0;
 	uint strLen;
 
+	// The strings can be extracted into a single buffer
+	size_t capacity = dict->extractCapacity();
+	uchar *buffer = new uchar[capacity];
+
 	for (uint i=1; i<=RUNS; i++)
 	{
 		t0 = getTime ();
 
 		for (uint j=1; j<patterns; j++)
 		{
-			uchar *str = dict->extract(ids[j], &strLen);
-			delete [] str;
+			if (into) dict->extractInto(ids[j], buffer, capacity);
+			else
+			{
+				uchar *str = dict->extract(ids[j], &strLen);
+				delete [] str;
+			}
 		}
 
 		t1 = (getTime () - t0);
@@ -182,6 +192,54 @@ void runExtract(StringDictionary *dict, char* in)
 	cout << ";;;" << (total*SEC_TIME_DIVIDER);
 	cout << ";;;" << (avgrun*SEC_TIME_DIVIDER);
 	cout << ";;;" << (avgpattern*MCSEC_TIME_DIVIDER) << " " << MCSEC_TIME_UNIT << endl;
+
+	delete [] buffer;
+}
+
+void countString(size_t index, uchar *str, uint strLen, void *data)
+{
+	*((size_t*)data) += strLen;
+}
+
+void runExtractBatch(StringDictionary *dict, char* in)
+{
+	ifstream inIds(in);
+	vector<size_t> ids;
+	char line[256];
+
+	while (true)
+	{
+		inIds.getline(line, 256);
+		size_t len = strlen(line);
+
+		if (len == 0) break;
+
+		ids.push_back(atoi(line));
+	}
+
+	uint patterns = ids.size();
+	double t0, t1, total=0;
+	size_t chars = 0;
+
+	for (uint i=1; i<=RUNS; i++)
+	{
+		t0 = getTime ();
+		dict->extractBatch(ids.data(), patterns, countString, &chars);
+
+		t1 = (getTime () - t0);
+		cout << (t1*SEC_TIME_DIVIDER) << " ";
+		total += t1;
+
+		sleep(5);
+	}
+
+	double avgrun = total/RUNS;
+	double avgpattern = avgrun/patterns;
+
+	cout << dict->getSize() << ";";
+	cout << ";;;" << (total*SEC_TIME_DIVIDER);
+	cout << ";;;" << (avgrun*SEC_TIME_DIVIDER);
+	cout << ";;;" << (avgpattern*MCSEC_TIME_DIVIDER) << " " << MCSEC_TIME_UNIT << endl;
 }
 
 void runLocatePrefix(StringDictionary *dict, char* in)
@@ -591,7 +649,7 @@ main(int argc, char* argv[])
 
 		if (in.good())
 		{
-			StringDictionary *dict = StringDictionary::load(in);
+			StringDictionary *dict = StringDictionary::loadMapped(argv[3]);
 			in.close();
 
 			if (dict == NULL) { checkDict(); exit(0); }
@@ -616,7 +674,10 @@ main(int argc, char* argv[])
 
 						case 'e':
 						{
-							runExtract(dict, argv[4]);
+							if (argv[2][1] == 'b')
+								runExtractBatch(dict, argv[4]);
+							else
+								runExtract(dict, argv[4], argv[2][1] == 'i');
 							break;
 						}
 
@@ -26,8 +26,15 @@
 
 #include "SSA.h"
 
+	// Bits needed to store v (libcds bits takes a uint)
+	static uint widthOf(size_t v) {
+		uint w = 0;
+		while(v) { w++; v >>= 1; }
+		return w;
+	}
+
 
-	SSA::SSA(uchar *text, uint n, bool free_text, uint samplesuff) {
+	SSA::SSA(uchar *text, size_t n, bool free_text, uint samplesuff) {
 		assert(n>0);
 
 		// Initial values and default constructors
@@ -68,7 +75,7 @@
 		if(_sbb!=NULL)
 			delete _sbb;
 		if(suff_sample!=NULL)
-			delete [] suff_sample;
+			delete suff_sample;
 		if(sampled!=NULL)
 			delete sampled;
 		if(alphabet!=NULL)
@@ -79,14 +86,15 @@
 
 
 	void SSA::save(ofstream & fp) {
-		saveValue(fp, n);
+		saveValue<uint32_t>(fp, WIDE);
+		saveValue<uint64_t>(fp, n);
 		saveValue(fp, maxV);
-		saveValue(fp, occ, maxV+1);
+		saveValue<uint64_t>(fp, occ, maxV+1);
 		bwt->save(fp);
 		saveValue(fp, samplesuff);
 
 		if(samplesuff > 0){
-			saveValue(fp, suff_sample, (n+1)/samplesuff+1);
+			suff_sample->save(fp);
 			sampled->save(fp);
 		}
 		saveValue(fp, alphabet, 256);
@@ -94,14 +102,31 @@
 
 	SSA * SSA::load(ifstream & fp){
 		SSA *fm = new SSA();
-		fm->n = loadValue<uint>(fp);
+		uint32_t first = loadValue<uint32_t>(fp);
+		bool wide = (first == WIDE);
+
+		// The 32-bit format stores n, occ and the sampled suffixes in uints
+		fm->n = wide ? loadValue<uint64_t>(fp) : first;
 		fm->maxV = loadValue<uint>(fp);
-		fm->occ = loadValue<uint>(fp, fm->maxV+1);
+		if(wide) fm->occ = loadValue<uint64_t>(fp, fm->maxV+1);
+		else {
+			uint *occ = loadValue<uint>(fp, fm->maxV+1);
+			fm->occ = new size_t[fm->maxV+1];
+			for(uint i=0;i<fm->maxV+1;i++) fm->occ[i] = occ[i];
+			delete [] occ;
+		}
 		fm->bwt = Sequence::load(fp); 
 		fm->samplesuff = loadValue<uint>(fp);
 
 		if(fm->samplesuff > 0){
-			fm->suff_sample = loadValue<uint>(fp, (fm->n+1)/fm->samplesuff+1);	
+			if(wide) fm->suff_sample = new LogSequence(fp);
+			else {
+				size_t samples = (fm->n+1)/fm->samplesuff+1;
+				uint *suff = loadValue<uint>(fp, samples);
+				fm->suff_sample = new LogSequence(widthOf(fm->n+1), samples);
+				for(size_t i=0;i<samples;i++) fm->suff_sample->setField(i, suff[i]);
+				delete [] suff;
+			}
 			fm->sampled = BitSequence::load(fp);
 		}
 		fm->alphabet = loadValue<bool>(fp,256);
@@ -111,7 +136,7 @@
 		return fm;
 	}
 
-	uint SSA::length() {
+	size_t SSA::length() {
 		return n;
 	}
 
@@ -122,6 +147,8 @@
 		_bwt = NULL;
 		sampled = NULL;
 		suff_sample = NULL;
+		occ = NULL;
+		alphabet = NULL;
 
 		_seq=NULL;
 		_ssb=NULL;
@@ -129,15 +156,15 @@
 	}
 
 
-	uint SSA::size() {
-		uint size = bwt->getSize();
+	size_t SSA::size() {
+		size_t size = bwt->getSize();
 		if(samplesuff > 0){
-			size += sizeof(uint)*(1+n/samplesuff);
+			size += suff_sample->getSize();
 			size += sampled->getSize();
 		}
 		size += sizeof(bool)*(256);
 		size += sizeof(SSA);
-		size += (1+maxV)*sizeof(uint);
+		size += (1+maxV)*sizeof(size_t);
 
 		return size;
 	}
@@ -151,10 +178,10 @@
 		cout << " bwt         : " << bwt->getSize() << endl;
 
 		if(samplesuff > 0){
-			cout << " suff sample : " << sizeof(uint)*(1+n/samplesuff) << endl;
+			cout << " suff sample : " << suff_sample->getSize() << endl;
 			cout << " sampled: " << sampled->getSize() << endl;
 		}
-		cout << " occ         : " << (maxV+1)*sizeof(uint) << endl;
+		cout << " occ         : " << (maxV+1)*sizeof(size_t) << endl;
 		cout << endl;
 	}
 
@@ -192,17 +219,17 @@
 		bwt = (_ssb->build(_bwt,n+1));
 
 		maxV = 0;
-		for(uint i=0;i<n+1;i++){
+		for(size_t i=0;i<n+1;i++){
 			alphabet[_bwt[i]]=true;
 			maxV = max(_bwt[i],maxV);
 		}
 		maxV++;
 
-		occ = new uint[maxV+1];
+		occ = new size_t[maxV+1];
 		for(uint i=0;i<maxV+1;i++)
 			occ[i]=0;
 
-		for(uint i=0;i<=n;i++)
+		for(size_t i=0;i<=n;i++)
 			occ[_bwt[i]+1]++;
 
 		for(uint i=1;i<=maxV;i++)
@@ -226,20 +253,20 @@
 			delete [] _bwt;
 		_bwt = new uint[n+2];
 		build_sa();
-		for(uint i=0;i<n+1;i++) {
+		for(size_t i=0;i<n+1;i++) {
 			if(_sa[i]==0) _bwt[i]=0;
 			else _bwt[i] = _seq[_sa[i]-1];
 		}
 	
 		if (samplesuff > 0)
 		{
-			uint j=0;
-			uint * sampled_vector = new uint[uint_len(n+2,1)];
-			suff_sample = new uint[(n+1)/samplesuff+1];
-			for(uint i=0;i<uint_len(n+1,1);i++) sampled_vector[i] = 0;
-			for(uint i=0;i<n+1;i++) {
+			size_t j=0;
+			uint * sampled_vector = new uint[(n+2)/W+1];
+			suff_sample = new LogSequence(widthOf(n+1), (n+1)/samplesuff+1);
+			for(size_t i=0;i<(n+2)/W+1;i++) sampled_vector[i] = 0;
+			for(size_t i=0;i<n+1;i++) {
 				if(_sa[i]%samplesuff==0) {
-					suff_sample[j++]=(uint)_sa[i];
+					suff_sample->setField(j++, _sa[i]);
 					bitset(sampled_vector,i);
 				}
 			}
@@ -264,14 +291,14 @@
 		delete suffix;
 		assert(_sa[0]==n);
 		for(ulong i=0;i<n;i++)
-			assert(cmp((uint)_sa[i],(uint)_sa[i+1])<=0);
+			assert(cmp(_sa[i],_sa[i+1])<=0);
 	}
 
-	uint SSA::locate_id(uchar * pattern, uint m) {
+	size_t SSA::locate_id(uchar * pattern, uint m) {
 		ulong i=m-1;
 		uint c = pattern[i];
-		uint sp = occ[c];
-		uint ep = occ[c+1]-1;
+		size_t sp = occ[c];
+		size_t ep = occ[c+1]-1;
 		while (sp<=ep && i>=1) {
 			c = pattern[--i];
 			if(!alphabet[c]){
@@ -287,13 +314,13 @@
 			return 0;
 	}
 
-	uint
+	size_t
 	SSA::locateP(uchar * pattern, uint m, size_t *left, size_t *right, size_t elements)
 	{
 		ulong i=m-1;
 		uint c = pattern[i];
-		uint sp = occ[c];
-		uint ep = occ[c+1]-1;
+		size_t sp = occ[c];
+		size_t ep = occ[c+1]-1;
 		while (sp<=ep && i>=1) {
 			c = pattern[--i];
 			if(!alphabet[c]){
@@ -313,15 +340,15 @@
 		else return 0;
 	}
 
-	uint SSA::locate(uchar * pattern, uint m, size_t **occs){
+	size_t SSA::locate(uchar * pattern, uint m, size_t **occs){
 		if(samplesuff == 0){
 			*occs = NULL;
 			return 0;
 		}
 		ulong i=m-1;
 		uint c = pattern[i];
-		uint sp = occ[c];
-		uint ep = occ[c+1]-1;
+		size_t sp = occ[c];
+		size_t ep = occ[c+1]-1;
 		while (sp<=ep && i>=1) {
 			c = pattern[--i];
 			if(!alphabet[c]){
@@ -332,10 +359,11 @@
 		}
 
 		if (sp<=ep) {
-			uint matches = ep-sp+1;
+			size_t matches = ep-sp+1;
 			*occs = new size_t[matches+1];
-			uint i = sp;
-			uint j,dist;
+			size_t i = sp;
+			size_t j;
+			uint dist;
 			size_t rank_tmp;
 
 			while(i<=ep)
@@ -355,7 +383,7 @@
 					dist++;
 				}
 
-				if (c != 1) (*occs)[i-sp] = suff_sample[sampled->rank1(j)-1];
+				if (c != 1) (*occs)[i-sp] = suff_sample->getField(sampled->rank1(j)-1);
 				else (*occs)[i-sp] = rank_tmp-1;
 
 				c = 0; i++;
@@ -369,15 +397,20 @@
 	}
 
 
-	uint SSA::LF(uint i){
+	size_t SSA::LF(size_t i){
 		size_t rank_tmp;
 		uint c = bwt->access(i, rank_tmp);
 		return rank_tmp -1 + occ[c];
 	}
 
-	uchar * SSA::extract_id(uint id, uint *strLen, uint max_len){
+	uchar * SSA::extract_id(size_t id, uint *strLen, uint max_len){
 		uchar *res = new uchar[max_len+2];
-		uint i = id;
+		extract_id(id, res, strLen, max_len);
+		return res;
+	}
+
+	void SSA::extract_id(size_t id, uchar *res, uint *strLen, uint max_len){
+		size_t i = id;
 		uint pos = max_len+1;
 		res[pos] = '\0';
 		pos--;
@@ -396,10 +429,9 @@
 		for(uint j=0; j<(*strLen);j++)
 			res[j] = res[pos+j];
 		res[(*strLen)] = '\0';
-		return res;
 	}
 
-	int SSA::cmp(uint i, uint j) {
+	int SSA::cmp(size_t i, size_t j) {
 		while(i<n && j<n) {
 			if(_seq[i]!=_seq[j])
 				return (int)_seq[i]-_seq[j];
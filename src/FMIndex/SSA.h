@@ -35,13 +35,14 @@
 #include <algorithm>
 
 #include "SuffixArray.h"
+#include "../utils/LogSequence.h"
 
 using namespace std;
 using namespace cds_static;
 
 	class SSA{
 		public:
-			SSA(uchar * seq, uint n, bool free_text=false, uint samplesuff=0);
+			SSA(uchar * seq, size_t n, bool free_text=false, uint samplesuff=0);
 			SSA();
 			~SSA();
 
@@ -50,28 +51,31 @@ using namespace cds_static;
 
 			bool build_index();
 
-			uint size();
+			size_t size();
 			void print_stats();
-			uint length();
+			size_t length();
 
-			uint LF(uint i);
-			uint locate_id(uchar * pattern, uint m);
-			uint locate(uchar * pattern, uint m, size_t **occs);
-			uint locateP(uchar * pattern, uint m, size_t *left, size_t *right, size_t last);
+			size_t LF(size_t i);
+			size_t locate_id(uchar * pattern, uint m);
+			size_t locate(uchar * pattern, uint m, size_t **occs);
+			size_t locateP(uchar * pattern, uint m, size_t *left, size_t *right, size_t last);
 
-			uchar * extract_id(uint id, uint *strLen, uint max_len);
+			uchar * extract_id(size_t id, uint *strLen, uint max_len);
+			void extract_id(size_t id, uchar *res, uint *strLen, uint max_len);
 			static SSA * load(ifstream & fp);
 			void save(ofstream & fp);
 
 		protected:
-			uint n;
+			static const uint32_t WIDE = 0xFFFFFFFF;	// Marks the 64-bit format (it replaces n, which is never 2^32-1 in the 32-bit one)
+
+			size_t n;
 			Sequence * bwt;
 
 			BitSequence * sampled;
-			uint * suff_sample;
+			LogSequence * suff_sample;	// Sampled suffixes (log(n) bits each)
 			uint samplesuff;			// Suffix sampling
 
-			uint * occ;
+			size_t * occ;
 			uint maxV;
 			bool built;
 			bool free_text;
@@ -87,7 +91,7 @@ using namespace cds_static;
 
 			void build_bwt();
 			void build_sa();
-			int cmp(uint i, uint j);
+			int cmp(size_t i, size_t j);
 
 		friend class StringDictionaryFMINDEX;
 	};
@@ -85,8 +85,8 @@
 		b_ht = new BitSequenceRG(bitmap, tsize, 20);
 
 		delete [] bitmap;
-		delete [] hashtable;
-		delete [] enclength;
+		delete [] hashtable; hashtable = NULL;
+		delete [] enclength; enclength = NULL;
 	}
 
 	void
@@ -87,6 +87,12 @@ class Hash
 			 */
 			virtual size_t getValuePos(size_t i)=0;
 
+			/* Prefetches the data read by getValue(i), if it can be
+			 * located without reading (nothing by default).
+			 * @i: key position in the hash table.
+			 */
+			virtual void prefetchValue(size_t i) {}
+
 			/* Abstract method which obtains the hash table size.
 			 * @returns the hash table size.
 			 */
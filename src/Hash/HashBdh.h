@@ -72,6 +72,11 @@ class HashBdh: public Hash{
 		 */
 		size_t getValuePos(size_t i);
 
+		/* Prefetches the entry read by getValue(i).
+		 * @i: key position in the hash table.
+		 */
+		void prefetchValue(size_t i) { hash->prefetch(i-1); }
+
 		/* Obtains the hash table size.
 		 * @returns the hash table size.
 		 */
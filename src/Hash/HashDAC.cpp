@@ -40,6 +40,7 @@ HashDAC::HashDAC(size_t tsize)
 	this->tsize = nearest_prime(tsize);
 	n = 0;
 
+	b_ht = NULL;
 	hashtable = new size_t[this->tsize];
 
 	uint i;
@@ -95,6 +96,7 @@ HashDAC::finish(size_t length)
 
 	delete [] bitmap;
 	delete [] hashtable;
+	hashtable = NULL;
 }
 
 void
@@ -178,4 +180,5 @@ HashDAC::scmp(size_t pos, uchar *w, size_t len)
 HashDAC::~HashDAC()
 {
 	if (b_ht != NULL) delete b_ht;
+	if (hashtable != NULL) delete [] hashtable;
 }
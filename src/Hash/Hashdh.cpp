@@ -32,6 +32,7 @@
 	{
 		tsize=0;
 		hashtable=NULL;
+		enclength=NULL;
 		hash = NULL;
 		b_ht = NULL;
 	}
@@ -41,6 +42,8 @@
 		tsize = nearest_prime(_tsize);
 		n = 0;
 
+		hash = NULL;
+		b_ht = NULL;
 		hashtable = new size_t[tsize];
 		enclength = new size_t[tsize];
 
@@ -118,4 +121,7 @@
 	{
 		if (hash != NULL) delete hash;
 		if (b_ht != NULL) delete b_ht;
+		// The auxiliar tables remain if the hash was not finished
+		if (hashtable != NULL) delete [] hashtable;
+		if (enclength != NULL) delete [] enclength;
 	}
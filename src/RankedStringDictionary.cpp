@@ -23,21 +23,255 @@
  *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
  */
 
+#include <thread>
 #include "RankedStringDictionary.h"
 
-RankedStringDictionary* RankedStringDictionary::load(ifstream & fp)
+RankedStringDictionary* RankedStringDictionary::load(ifstream & fp, const RePairOptions &options)
 {
 	size_t r = loadValue<uint32_t>(fp);
 
+	if(r == MappedFile::MAGIC) return loadLayout(fp, NULL, options, true);
+
 	switch(r)
 	{
-		case RDS: return RankedStringDictionarySimple::load(fp);
-		case RDRPDAC: return RankedStringDictionaryRPDAC::load(fp);
+		case RDS: return RankedStringDictionarySimple::load(fp, options);
+		case RDRPDAC: return RankedStringDictionaryRPDAC::load(fp, options);
+		case RDRMQ: return RankedStringDictionaryRMQ::load(fp, options);
 	}
 
 	return NULL;
 }
 
+RankedStringDictionary* RankedStringDictionary::create(uint32_t type)
+{
+	switch(type)
+	{
+		case RDS: return new RankedStringDictionarySimple();
+		case RDRPDAC: return new RankedStringDictionaryRPDAC();
+		case RDRMQ: return new RankedStringDictionaryRMQ();
+	}
+
+	return NULL;
+}
+
+RankedStringDictionary* RankedStringDictionary::loadLayout(ifstream &in, const char *path, const RePairOptions &options, bool verify)
+{
+	RankedStringDictionary *dict = NULL;
+	uint32_t version = MappedFile::readHeader(in);
+	SectionTable table;
+
+	if(version==1) dict = load(in, options); //the dictionary follows the header
+	else if(version==2 && table.read(in) && table.open(in, 0, verify))
+	{
+		if(table.size()==1) dict = load(in, options); //the whole dictionary is one section
+		else
+		{
+			dict = create(loadValue<uint32_t>(in));
+			bool *loaded = new bool[table.size()];
+			loaded[0] = (dict!=NULL) && (dict->numSections()==table.size()) && dict->loadSection(0, in, options);
+
+			//the other sections are independent: with the path each one is loaded by a thread with its own stream
+			vector<thread> threads;
+			for(uint s=1; s<table.size(); s++)
+			{
+				loaded[s] = false;
+				if(!loaded[0]) continue;
+				if(path!=NULL) threads.push_back(thread(loadSectionThread, dict, &table, s, path, &in, &options, verify, &loaded[s]));
+				else loaded[s] = table.open(in, s, verify) && dict->loadSection(s, in, options);
+			}
+			for(uint t=0; t<threads.size(); t++)
+				threads[t].join();
+
+			for(uint s=0; s<table.size(); s++)
+			{
+				if(loaded[s]) continue;
+				cerr << "The section " << s << " of the dictionary cannot be loaded" << endl;
+				if(dict!=NULL) delete dict;
+				dict = NULL;
+				break;
+			}
+			delete [] loaded;
+		}
+	}
+
+	MappedFile::detach(in);
+	return dict;
+}
+
+void RankedStringDictionary::loadSectionThread(RankedStringDictionary *dict, SectionTable *table, uint section, const char *path, ifstream *from, const RePairOptions *options, bool verify, bool *loaded)
+{
+	ifstream in(path, ios::binary);
+	MappedFile::follow(in, *from);
+	*loaded = table->open(in, section, verify) && dict->loadSection(section, in, *options);
+	MappedFile::detach(in);
+}
+
+void RankedStringDictionary::saveMapped(ofstream &out)
+{
+	if(!good())
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+
+	uint sections = numSections();
+	SectionTable table(sections);
+
+	MappedFile::writeHeader(out);
+	table.reserve(out);
+	for(uint s=0; s<sections; s++)
+	{
+		table.begin(out, s);
+		saveSection(s, out);
+		table.end(out, s);
+	}
+	table.write(out);
+	MappedFile::detach(out);
+}
+
+RankedStringDictionary* RankedStringDictionary::loadMapped(const char *path, const RePairOptions &options, bool verify)
+{
+	MappedFile *file = new MappedFile(path);
+	if(!file->good())
+	{
+		delete file;
+		return NULL;
+	}
+
+	ifstream in(path, ios::binary);
+	MappedFile::attach(in, file);
+	RankedStringDictionary *dict;
+	if(loadValue<uint32_t>(in) == MappedFile::MAGIC) dict = loadLayout(in, path, options, verify);
+	else
+	{
+		in.seekg(0);
+		dict = load(in, options);
+	}
+	MappedFile::detach(in);
+	in.close();
+
+	if(dict == NULL) delete file;
+	else dict->mapping = file;
+	return dict;
+}
+
+RankedStringDictionary::~RankedStringDictionary()
+{
+	//the arrays pointing into the mapping are left by the destructors of the subclasses
+	if(mapping != NULL) delete mapping;
+}
+
+uint RankedStringDictionary::numSections()
+{
+	return 1;
+}
+
+void RankedStringDictionary::saveSection(uint section, ofstream &out)
+{
+	save(out);
+}
+
+bool RankedStringDictionary::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	return false;
+}
+
+uint RankedStringDictionary::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if(id==0 || id>elements) return 0;
+
+	uint strLen;
+	uchar *str = extract(id, &strLen);
+	if(str==NULL) return 0;
+
+	if(strLen<cap)
+	{
+		memcpy(buf, str, strLen);
+		buf[strLen] = '\0';
+	}
+	delete [] str;
+	return strLen;
+}
+
+size_t RankedStringDictionary::extractCapacity()
+{
+	return maxlength+1;
+}
+
+bool RankedStringDictionary::exportTable(ExtractCallback callback, void *data, bool lexicographic, uint threads)
+{
+	if(threads<1) threads=1;
+	vector<RankedTableBlock> blocks(threads);
+
+	//in each round, every thread decodes TABLECHUNK consecutive strings
+	for(size_t first=1; first<=elements; first+=threads*TABLECHUNK)
+	{
+		for(uint t=0; t<threads; t++)
+		{
+			size_t from = first+t*TABLECHUNK;
+			blocks[t].reset(from, (from>elements) ? 0 : min((size_t)TABLECHUNK, (size_t)elements-from+1));
+		}
+
+		vector<thread> workers;
+		for(uint t=1; t<threads && blocks[t].getCount()>0; t++)
+			workers.push_back(thread(decodeBlock, this, lexicographic, &blocks[t]));
+		decodeBlock(this, lexicographic, &blocks[0]);
+		for(uint t=0; t<workers.size(); t++)
+			workers[t].join();
+
+		for(uint t=0; t<threads; t++)
+		{
+			if(!blocks[t].valid)
+			{
+				cerr << "This dictionary does not provide table extraction in this order" << endl;
+				return false;
+			}
+			blocks[t].emit(callback, data);
+		}
+	}
+
+	return true;
+}
+
+void RankedStringDictionary::decodeBlock(RankedStringDictionary *dict, bool lexicographic, RankedTableBlock *block)
+{
+	block->valid = dict->decodeTable(lexicographic, block);
+}
+
+bool RankedStringDictionary::decodeTable(bool lexicographic, RankedTableBlock *block)
+{
+	if(lexicographic) return false;
+
+	size_t capacity = extractCapacity();
+	for(size_t slot=0; slot<block->getCount(); slot++)
+	{
+		uchar *s = block->reserve(capacity);
+		block->commit(slot, extractInto(block->getFirst()+slot, s, capacity));
+	}
+	return true;
+}
+
+//copies each string of the table to a vector
+static void collectString(size_t index, uchar *str, uint strLen, void *data)
+{
+	uchar *s = new uchar[strLen+1];
+	if(str!=NULL) memcpy(s, str, strLen);
+	s[strLen] = '\0';
+	((vector<uchar*>*)data)->push_back(s);
+}
+
+IteratorRankedDictString* RankedStringDictionary::tableIterator()
+{
+	vector<uchar*> strings;
+	if(!exportTable(collectString, &strings, true))
+	{
+		for(uint i=0; i<strings.size(); i++)
+			delete [] strings[i];
+		return NULL;
+	}
+	return new IteratorRankedDictStringVector(&strings, strings.size());
+}
+
 uint RankedStringDictionary::maxLength()
 {
 	return maxlength;
@@ -35,11 +35,15 @@ using namespace cds_utils;
 #include "iterators/IteratorRankedDictID.h"
 #include "iterators/IteratorRankedDictString.h"
 #include "utils/Utils.h"
+#include "utils/MappedFile.h"
+#include "utils/SectionTable.h"
+#include "RePair/RePair.h"
+#include "ranked/RankedTableBlock.h"
 
 struct dictItem
 {
     uchar* itemText;
-    uint itemId;
+    size_t itemId;
 };
 
 
@@ -52,7 +56,7 @@ class RankedStringDictionary
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the dictionary).
 		*/
-		virtual uint locate(uchar *str, uint strLen)=0;
+		virtual size_t locate(uchar *str, uint strLen)=0;
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -62,6 +66,26 @@ class RankedStringDictionary
 		*/
 		virtual uchar* extract(size_t id, uint *strLen)=0;
 
+		/** Obtains the string associated with the given ID into a
+		    buffer given by the caller. The string is decoded in place
+		    if the buffer has (at least) extractCapacity() bytes;
+		    otherwise it is extracted apart and copied if it fits (by
+		    default, extract is always used).
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary). The buffer contains the '\0'-terminated
+		      string only if the length is lower than cap.
+		*/
+		virtual uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		virtual size_t extractCapacity();
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -82,7 +106,7 @@ class RankedStringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		virtual uint locateRank(uint rank)=0;
+		virtual size_t locateRank(size_t rank)=0;
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -105,7 +129,7 @@ class RankedStringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		virtual uchar* extractRank(uint rank, uint *strLen)=0;
+		virtual uchar* extractRank(size_t rank, uint *strLen)=0;
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -113,6 +137,22 @@ class RankedStringDictionary
 		*/
 		virtual IteratorRankedDictString* extractTable()=0;
 
+		/** Decodes all the strings in the dictionary and gives them to
+		    a sink, in ID order or in alphabetical order. Each thread
+		    decodes consecutive ranges of the table in its own block of
+		    memory, and the blocks are given to the sink in order (by
+		    the calling thread), so no string is allocated.
+		    @param callback: function called for each string with its
+		      ID (or its alphabetical position); the string is only
+		      valid during the call.
+		    @param data: user data given to the callback.
+		    @param lexicographic: true for alphabetical order, false
+		      for ID order.
+		    @param threads: number of threads decoding the table.
+		    @returns false if the dictionary does not provide the order.
+		*/
+		bool exportTable(ExtractCallback callback, void *data, bool lexicographic=false, uint threads=1);
+
 		/** Computes the size of the structure in bytes.
 		    @returns the dictionary size in bytes.
 		*/
@@ -129,6 +169,14 @@ class RankedStringDictionary
 		*/
 		size_t numElements();
 
+		/** Checks if the dictionary was built: the construction fails
+		    (reporting it to stderr) if the strings cannot be compressed.
+		    A dictionary that was not built is empty: it locates and
+		    extracts nothing, and it cannot be saved.
+		    @returns false if it could not be built.
+		*/
+		virtual bool good() { return true; }
+
 		/** Stores the dictionary into an ofstream.
 		    @param out: the oftstream.
 		*/
@@ -136,9 +184,36 @@ class RankedStringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static RankedStringDictionary *load(ifstream &in);
+		static RankedStringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
+
+		/** Stores the dictionary into an ofstream in the mapped layout
+		    (a header, a directory with the offset, length and checksum
+		    of each section, and the arrays aligned), so it can be loaded
+		    with loadMapped. It is also read by load, which checks the
+		    checksums.
+		    @param out: the oftstream.
+		*/
+		void saveMapped(ofstream &out);
+
+		/** Loads a dictionary mapping its file in memory: the arrays of
+		    the sequences and strings point into the mapping (shared by
+		    all the processes mapping the file) instead of being read.
+		    The sections are loaded in parallel. A file without the
+		    mapped layout is read as by load.
+		    @param path: the file.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @param verify: true to check the checksums of the sections
+		      (which reads every page of the file); otherwise only their
+		      bounds are checked.
+		    @returns the loaded dictionary (NULL if it cannot be loaded
+		      or it is corrupt).
+		*/
+		static RankedStringDictionary *loadMapped(const char *path, const RePairOptions &options=RePairOptions(), bool verify=false);
 
 		
 		/** Locates the first k IDs of those elements prefixed by the given
@@ -166,18 +241,88 @@ class RankedStringDictionary
 			@param k: the maximun number of elements to return
 		    @returns an iterator for direct scanning of all the strings.
 		*/
-		virtual IteratorRankedDictString* extractRankedInterval(uint beginning, uint len, uint k)=0;
+		virtual IteratorRankedDictString* extractRankedInterval(size_t beginning, size_t len, uint k)=0;
 
 
 		
 		/** Generic destructor. */
-		virtual ~RankedStringDictionary() {};
+		virtual ~RankedStringDictionary();
 
 
 	protected:
+		RankedStringDictionary() : mapping(NULL) {}
+
 		uint32_t type;      //! Dictionary type.
 		uint64_t elements;  //! Number of strings in the dictionary.
 		uint32_t maxlength; //! Length of the largest string in the dictionary.
+		MappedFile *mapping; //! Mapping of the file it was loaded from (NULL if it was read).
+
+		static const size_t TABLECHUNK = 1<<14; //strings decoded by each thread in a round of exportTable
+
+		/** Decodes the strings of a block of the table (by default,
+		    with extractInto, only in ID order).
+		    @param lexicographic: true for alphabetical order, false
+		      for ID order.
+		    @param block: the block, with the range to be decoded.
+		    @returns false if the dictionary does not provide the order.
+		*/
+		virtual bool decodeTable(bool lexicographic, RankedTableBlock *block);
+
+		/** Extracts all the strings in alphabetical order (with
+		    exportTable), for extractTable.
+		    @returns an iterator for direct scanning of all the strings
+		      (NULL if the dictionary does not provide the order).
+		*/
+		IteratorRankedDictString* tableIterator();
+
+		//decodes a block of the table (run by the threads of exportTable)
+		static void decodeBlock(RankedStringDictionary *dict, bool lexicographic, RankedTableBlock *block);
+
+		/** Retrieves the number of sections of the dictionary in the
+		    mapped layout: independent components, which are loaded in
+		    parallel. By default, the whole dictionary is one section.
+		    @returns the number of sections.
+		*/
+		virtual uint numSections();
+
+		/** Stores a section of the dictionary (save stores all of them,
+		    so the first one starts with the type).
+		    @param section: the section.
+		    @param out: the oftstream.
+		*/
+		virtual void saveSection(uint section, ofstream &out);
+
+		/** Loads a section into the dictionary (the type of the first
+		    one has been read).
+		    @param section: the section.
+		    @param in: the ifstream, at the start of the section.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @returns false if it cannot be loaded.
+		*/
+		virtual bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
+		/** Creates an empty dictionary of a type, for loading its
+		    sections.
+		    @param type: the dictionary type.
+		    @returns the dictionary (NULL if the type is not valid).
+		*/
+		static RankedStringDictionary *create(uint32_t type);
+
+		/** Loads a dictionary in the mapped layout (after its magic
+		    number).
+		    @param in: the ifstream.
+		    @param path: the file, so the sections are loaded in parallel
+		      with a stream each (NULL to load them with in).
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @param verify: true to check the checksums of the sections.
+		    @returns the loaded dictionary (NULL if error).
+		*/
+		static RankedStringDictionary *loadLayout(ifstream &in, const char *path, const RePairOptions &options, bool verify);
+
+		//loads a section (verifying it if requested) with its own stream (run by the threads of loadLayout)
+		static void loadSectionThread(RankedStringDictionary *dict, SectionTable *table, uint section, const char *path, ifstream *from, const RePairOptions *options, bool verify, bool *loaded);
 		
 		
 		bool static sorting(dictItem item1, dictItem item2)
@@ -192,6 +337,7 @@ class RankedStringDictionary
 
 #include "RankedStringDictionarySimple.h"
 #include "RankedStringDictionaryRPDAC.h"
+#include "RankedStringDictionaryRMQ.h"
 
 #endif
 
@@ -0,0 +1,483 @@
+/* RankedStringDictionaryRMQ.cpp
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * This class implements a Compressed Ranked String Dictionary which stores
+ * the strings sorted in a RePair+DAC dictionary, the ID of each string by
+ * alphabetical position and a range minimum query structure over it.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#include "RankedStringDictionaryRMQ.h"
+
+
+
+RankedStringDictionaryRMQ::RankedStringDictionaryRMQ()
+{
+	this->type = RDRMQ;
+	this->elements = 0;
+	this->maxlength = 0;
+	this->strings = NULL;
+	this->ids = NULL;
+	this->positions = NULL;
+	this->rmq = NULL;
+}
+
+RankedStringDictionaryRMQ::RankedStringDictionaryRMQ(IteratorDictString *it, const RePairOptions &options)
+{
+	this->type = RDRMQ;
+	this->maxlength = 0;
+	this->elements = 0;
+
+	//Create a struct list containing the text and the ID of each element of the dictionary
+	vector<dictItem> itemsList;
+
+	//Insert the items in the list using the iterator
+	uchar* strCurrent=NULL;
+	uint lenCurrent=0;
+	size_t id=0;
+	while(it->hasNext())
+	{
+		id++;
+		strCurrent = it->next(&lenCurrent);
+		if (lenCurrent >= maxlength) maxlength = lenCurrent+1; //set the maxlength
+		dictItem item;
+		item.itemId=id;
+		item.itemText = strCurrent;
+
+		itemsList.push_back(item);
+	}
+
+	this->elements=itemsList.size();
+
+
+	//order the list using a class
+	sort(itemsList.begin(), itemsList.end(), sorting);
+
+
+	//the ID of each alphabetical position and its inverse
+	uint bitsIds = bits(elements+1);
+	ids = new LogSequence(bitsIds, elements);
+	positions = new LogSequence(bitsIds, elements);
+	for (size_t i=0; i<elements; i++)
+	{
+		ids->setField(i, itemsList[i].itemId);
+		positions->setField(itemsList[i].itemId-1, i+1);
+	}
+	rmq = new RankedRMQ(ids);
+
+
+	//create the String Dictionary with the strings ordered
+	vector<uchar*> elemsStr;
+	for (uint i=0; i<itemsList.size();i++)
+	{
+		elemsStr.push_back(itemsList[i].itemText);
+	}
+	IteratorDictString *iter = new IteratorDictStringVector(&elemsStr, elements); //create the iterator
+	strings = new StringDictionaryRPDAC(iter, options);
+	if(!strings->good()) //the strings cannot be compressed: the dictionary is left empty
+		elements = 0;
+}
+
+
+
+
+
+
+
+size_t RankedStringDictionaryRMQ::locate(uchar *str, uint strLen)
+{
+	size_t orderedPos = strings->locate(str, strLen);
+	if(orderedPos == NORESULT) //if the string it's not in the dictionary orderedPos=0
+		return NORESULT;
+
+	return ids->getField(orderedPos-1);
+}
+
+
+
+
+
+uchar* RankedStringDictionaryRMQ::extract(size_t id, uint *strLen)
+{
+	//if the id its higher than the number of elements return NULL
+	if(id==0 || id>elements)
+	{
+		*strLen = 0;
+		return NULL;
+	}
+	return strings->extract(positions->getField(id-1), strLen);
+}
+
+
+
+
+
+uint RankedStringDictionaryRMQ::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if(id==0 || id>elements)
+		return 0;
+	return strings->extractInto(positions->getField(id-1), buf, cap);
+}
+
+
+
+
+
+size_t RankedStringDictionaryRMQ::extractCapacity()
+{
+	return strings->extractCapacity();
+}
+
+
+
+
+
+IteratorRankedDictID* RankedStringDictionaryRMQ::locatePrefix(uchar *str, uint strLen)
+{
+	size_t left, right;
+	if(!prefixRange(str, strLen, &left, &right))
+		return NULL;
+
+	size_t *prefixIds = new size_t[right-left+1];
+	for(size_t i=left; i<=right; i++)
+		prefixIds[i-left] = ids->getField(i-1);
+
+	return new IteratorRankedDictIDNoContiguous(prefixIds, right-left+1);
+}
+
+
+
+
+
+
+IteratorRankedDictID* RankedStringDictionaryRMQ::locateSubstr(uchar *str, uint strLen)
+{
+	cerr << "This dictionary does not provide substring location" << endl;
+	return NULL;
+}
+
+
+
+
+
+
+size_t RankedStringDictionaryRMQ::locateRank(size_t rank)
+{
+	return rank;
+}
+
+
+
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractPrefix(uchar *str, uint strLen)
+{
+	size_t left, right;
+	if(!prefixRange(str, strLen, &left, &right))
+		return NULL;
+
+	vector<uchar*> prefixStrings;
+	uint strl;
+	for(size_t i=left; i<=right; i++)
+		prefixStrings.push_back(strings->extract(i, &strl));
+
+	return new IteratorRankedDictStringVector(&prefixStrings, right-left+1);
+}
+
+
+
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractSubstr(uchar *str, uint strLen)
+{
+	cerr << "This dictionary does not provide substring extraction" << endl;
+	return NULL;
+}
+
+
+
+
+
+
+uchar* RankedStringDictionaryRMQ::extractRank(size_t rank, uint *strLen)
+{
+	return extract(rank, strLen);
+}
+
+
+
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractTable()
+{
+	return tableIterator();
+}
+
+
+
+
+
+bool RankedStringDictionaryRMQ::decodeTable(bool lexicographic, RankedTableBlock *block)
+{
+	size_t count = block->getCount();
+	size_t *alphaPositions = new size_t[count];
+	for(size_t slot=0; slot<count; slot++)
+		alphaPositions[slot] = lexicographic ? block->getFirst()+slot : positions->getField(block->getFirst()+slot-1);
+	strings->extractBatch(alphaPositions, count, RankedTableBlock::store, block);
+
+	delete [] alphaPositions;
+	return true;
+}
+
+
+
+
+
+
+bool RankedStringDictionaryRMQ::good()
+{
+	return strings!=NULL && strings->good();
+}
+
+size_t RankedStringDictionaryRMQ::getSize()
+{
+	if(strings==NULL) return sizeof(RankedStringDictionaryRMQ);
+	return strings->getSize() + ids->getSize() + positions->getSize() + rmq->getSize() + sizeof(RankedStringDictionaryRMQ);
+}
+
+
+
+
+
+
+void RankedStringDictionaryRMQ::save(ofstream &out)
+{
+	if(!good())
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+	
+	//the sections are stored back to back
+	for(uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
+}
+
+
+
+
+
+
+RankedStringDictionary * RankedStringDictionaryRMQ::load(ifstream &in, const RePairOptions &options)
+{
+	RankedStringDictionaryRMQ * dict = new RankedStringDictionaryRMQ();
+	for(uint s=0; s<SECTIONS; s++)
+	{
+		if(!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
+	return dict;
+}
+
+
+
+
+
+
+uint RankedStringDictionaryRMQ::numSections()
+{
+	return SECTIONS;
+}
+
+
+
+
+
+
+void RankedStringDictionaryRMQ::saveSection(uint section, ofstream &out)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			break;
+		}
+		case 1: strings->save(out); break;
+		case 2:
+		{
+			ids->save(out);
+			positions->save(out);
+			rmq->save(out);
+			break;
+		}
+	}
+}
+
+
+
+
+
+
+bool RankedStringDictionaryRMQ::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			type = RDRMQ;
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			if(loadValue<uint32_t>(in)!=RPDAC)
+				return false;
+			strings = (StringDictionaryRPDAC*)StringDictionaryRPDAC::load(in, options);
+			return strings!=NULL;
+		}
+		case 2:
+		{
+			ids = new LogSequence(in); //the LogSequence doesn't have load, it has a constructor with the in file
+			positions = new LogSequence(in);
+			rmq = RankedRMQ::load(in, ids);
+			return in.good();
+		}
+	}
+	return false;
+}
+
+
+
+
+
+
+IteratorRankedDictID* RankedStringDictionaryRMQ::locateRankedPrefix(uchar *str, uint strLen, uint k)
+{
+	size_t left, right;
+	if(!prefixRange(str, strLen, &left, &right))
+		return NULL;
+
+	size_t *topk = topK(left, right, &k);
+	return new IteratorRankedDictIDNoContiguous(topk, k);
+}
+
+
+
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractRankedPrefix(uchar *str, uint strLen, uint k)
+{
+	size_t left, right;
+	if(!prefixRange(str, strLen, &left, &right))
+		return NULL;
+
+	return extractTopK(left, right, k);
+}
+
+
+
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractRankedInterval(size_t beginning, size_t len, uint k)
+{
+	if(len==0 || beginning==0 || beginning>elements)
+		return NULL;
+	if(len>elements-beginning+1) len=elements-beginning+1;
+	size_t last = beginning+len-1;
+
+	return extractTopK(beginning, last, k);
+}
+
+
+
+
+
+
+RankedStringDictionaryRMQ::~RankedStringDictionaryRMQ()
+{
+	if(strings!=NULL) delete strings;
+	if(rmq!=NULL) delete rmq;
+	if(ids!=NULL) delete ids;
+	if(positions!=NULL) delete positions;
+}
+
+
+
+
+
+
+bool RankedStringDictionaryRMQ::prefixRange(uchar *str, uint strLen, size_t *left, size_t *right)
+{
+	IteratorDictIDContiguous *it = (IteratorDictIDContiguous*)strings->locatePrefix(str, strLen);
+	*left = it->getLeftLimit();
+	*right = it->getRightLimit();
+	delete it;
+
+	return *left!=NORESULT && *left<=*right;
+}
+
+
+
+
+
+
+size_t* RankedStringDictionaryRMQ::topK(size_t left, size_t right, uint *k)
+{
+	size_t *topk = new size_t[*k];
+	*k = rmq->topK(left-1, right-1, *k, topk);
+	return topk;
+}
+
+
+
+IteratorRankedDictString* RankedStringDictionaryRMQ::extractTopK(size_t left, size_t right, uint k)
+{
+	//the positions of the k smallest IDs are obtained with them, so the strings are extracted without the inverse
+	size_t *topk = new size_t[k];
+	size_t *topkPositions = new size_t[k];
+	k = rmq->topK(left-1, right-1, k, topk, topkPositions);
+
+	//the strings are extracted together, so each bucket is decoded once
+	for(uint i=0; i<k; i++)
+		topkPositions[i]++;
+	uchar **batch = new uchar*[k];
+	uint *lens = new uint[k];
+	strings->extractBatch(topkPositions, k, batch, lens);
+	vector<uchar*> topkStrings(batch, batch+k);
+
+	delete [] topk;
+	delete [] topkPositions;
+	delete [] batch;
+	delete [] lens;
+	return new IteratorRankedDictStringVector(&topkStrings, k);
+}
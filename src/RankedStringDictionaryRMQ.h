@@ -0,0 +1,228 @@
+/* RankedStringDictionaryRMQ.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * This class implements a Compressed Ranked String Dictionary which stores
+ * the strings sorted in a RePair+DAC dictionary, the ID of each string by
+ * alphabetical position and a range minimum query structure over it, so
+ * the top k queries obtain the k smallest IDs of a range directly.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+
+
+#ifndef _RANKEDSTRINGDICTIONARYRMQ_H
+#define _RANKEDSTRINGDICTIONARYRMQ_H
+
+#include <iostream>
+#include "RankedStringDictionary.h"
+#include "StringDictionary.h"
+#include <libcdsBasics.h>
+#include <vector>
+#include "iterators/IteratorDictString.h"
+#include "utils/LogSequence.h"
+#include "ranked/RankedRMQ.h"
+
+using namespace std;
+using namespace cds_utils;
+
+
+
+
+
+class RankedStringDictionaryRMQ : public RankedStringDictionary
+{
+	public:
+		/** Generic Constructor. */
+		RankedStringDictionaryRMQ();
+
+		/** Class Constructor.
+		    @param it: iterator scanning the original set of strings.
+		    @param options: options of the RePair compression.
+		*/
+		RankedStringDictionaryRMQ(IteratorDictString *it, const RePairOptions &options=RePairOptions());
+
+		/** Retrieves the ID corresponding to the given string.
+		    @param str: the string to be searched.
+		    @param strLen: the string length.
+		    @returns the ID (or NORESULT if it is not in the dictionary).
+		*/
+		size_t locate(uchar *str, uint strLen);
+
+		/** Obtains the string associated with the given ID.
+		    @param id: the ID to be extracted.
+		    @param strLen: pointer to the extracted string length.
+		    @returns the requested string (or NULL if it is not in the
+		      dictionary).
+		 */
+		uchar* extract(size_t id, uint *strLen);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Locates all IDs of those elements prefixed by the given
+		    string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+		    @returns an iterator for direct scanning of all the IDs.
+		*/
+		IteratorRankedDictID* locatePrefix(uchar *str, uint strLen);
+
+		/** Locates all IDs of those elements containing the given
+		    substring.
+		    @param str: the substring to be searched.
+		    @param strLen: the substring length.
+		    @returns an iterator for direct scanning of all the IDs.
+		*/
+		IteratorRankedDictID* locateSubstr(uchar *str, uint strLen);
+
+		/** Retrieves the ID with rank k according to its alphabetical order.
+		    @param rank: the alphabetical ranking.
+		    @returns the ID.
+		*/
+		size_t locateRank(size_t rank);
+
+		/** Extracts all elements prefixed by the given string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractPrefix(uchar *str, uint strLen);
+
+		/** Extracts all elements containing by the given substring.
+		    @param str: the substring to be searched.
+		    @param strLen: the substring length.
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractSubstr(uchar *str, uint strLen);
+
+		/** Obtains the string  with rank k according to its
+		    alphabetical order.
+		    @param id: the ID to be extracted.
+		    @param strLen: pointer to the extracted string length.
+		    @returns the requested string (or NULL if it is not in the
+		      dictionary).
+		*/
+		uchar* extractRank(size_t rank, uint *strLen);
+
+		/** Extracts all strings in the dictionary sorted in
+		    alphabetical order.
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractTable();
+
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
+		/** Computes the size of the structure in bytes: the strings, the
+		    IDs by alphabetical position and their inverse (log(n) bits
+		    each, as the permutation of the other ranked dictionaries:
+		    the IDs are the values of the RMQ and the inverse locates
+		    the string of an ID), and the RMQ (less than 1 bit per ID).
+		    @returns the dictionary size in bytes.
+		*/
+		size_t getSize();
+
+		/** Stores the dictionary into an ofstream.
+		    @param out: the oftstream.
+		*/
+		void save(ofstream &out);
+
+		/** Loads a dictionary from an ifstream.
+		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @returns the loaded dictionary.
+		*/
+		static RankedStringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
+
+		/** Locates the first k IDs of those elements prefixed by the given
+		    string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+			@param k: the maximun number of elements to return
+		    @returns an iterator for direct scanning of all the IDs.
+		*/
+		IteratorRankedDictID* locateRankedPrefix(uchar *str, uint strLen, uint k);
+
+		/** Extracts the first k strings of those elements prefixed by the given
+		    string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+			@param k: the maximun number of elements to return
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractRankedPrefix(uchar *str, uint strLen, uint k);
+
+		/** Extracts the first (ranked) k strings of those elements in the closed interval given
+		    string.
+			@param beginning: The first element of the interval
+			@param len: The length of the interval
+			@param k: the maximun number of elements to return
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractRankedInterval(size_t beginning, size_t len, uint k);
+
+		/** Generic destructor. */
+		~RankedStringDictionaryRMQ();
+
+	protected:
+		StringDictionaryRPDAC * strings; //the strings in alphabetical order
+		LogSequence * ids; //ID of the string in each alphabetical position
+		LogSequence * positions; //alphabetical position (from 1) of each ID
+		RankedRMQ * rmq; //range minimum queries over the IDs
+
+		//finds the alphabetical positions [left, right] (from 1) of the strings with the prefix (false if there are none)
+		inline bool prefixRange(uchar *str, uint strLen, size_t *left, size_t *right);
+
+		//obtains the first k IDs of the alphabetical positions [left, right] (k is updated with the IDs found)
+		inline size_t* topK(size_t left, size_t right, uint *k);
+
+		//extracts the strings of the k smallest IDs in the alphabetical positions [left, right] (from 1)
+		inline IteratorRankedDictString* extractTopK(size_t left, size_t right, uint k);
+
+		//decodes a block of the table of exportTable (extracting its alphabetical positions in a batch)
+		bool decodeTable(bool lexicographic, RankedTableBlock *block);
+
+		//sections of the mapped layout: 0 the sizes, 1 the strings and 2 the ID sequences with the RMQ (which refers to ids)
+		static const uint SECTIONS = 3;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+};
+
+#endif
@@ -39,17 +39,22 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC()
 	this->rp=NULL;
 	this->H=NULL;
 	this->P=NULL;
+	this->top=NULL;
+	this->sample=NULL;
 }
 
-RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it, uint bucketsize)
+RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it, uint bucketsize, uint threads, uint topT, uint sampleRate, const RePairOptions &options)
 {
 	this->type = RDRPDAC;
 	this->maxlength = 0;
 	this->rp = NULL;
 	this->H = NULL;
 	this->P = NULL;
+	this->top = NULL;
+	this->sample = NULL;
 	this->bucketsize = bucketsize;
 	this->numBuckets = 0;
+	if(threads<1) threads=1;
 
 	//Create a struct list containing the text and the ID of each element of the dictionary
 	vector<dictItem> itemsList;
@@ -57,8 +62,8 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 	//Insert the items in the list using the iterator
 	uchar* strCurrent=NULL;
 	uint lenCurrent=0;
-	uint id=0;
-	uint mBytes=it->size();
+	size_t id=0;
+	size_t mBytes=it->size();
 	while(it->hasNext())
 	{
         id++;
@@ -73,71 +78,45 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 
 
 	this->elements=itemsList.size();
+	MemoryUsage::phase("strings");
 
 
-	//order the list using a class
-	sort(itemsList.begin(), itemsList.end(), sorting);
+	//order the list lexicographically (in parallel if there are several threads)
+	sortItems(&itemsList, threads);
+	MemoryUsage::phase("sorting");
 
+	this->numBuckets = floor((elements-1)/bucketsize)+1; //same as ceil(elements/bucketsize)
 	
-	// Create P
-	uint * bucketNumber = new uint[elements];
-	uint pos = 0;
+	//P is built from the bucket of each ID
+	uint * bucketNumber = new uint[elements]; //indexed by ID (the values are bucket numbers, the symbols of P)
+	size_t pos = 0;
 	for (std::vector<dictItem>::iterator it = itemsList.begin() ; it != itemsList.end(); it++)
     {
-        uint rankedPos = it->itemId; //get the ID of the element
+        size_t rankedPos = it->itemId; //get the ID of the element
 		bucketNumber[rankedPos-1] = floor(pos/bucketsize)+1; //same as ceil((pos+1)/bucketsize)
         pos++;
     }
 
-	P = new WaveletTreeNoptrs(bucketNumber, elements, new BitSequenceBuilder375(), new MapperNone());
-	//P = new WaveletTreeNoptrs(bucketNumber, elements, new BitSequenceBuilderRG(20), new MapperNone());
-	
-	delete [] bucketNumber;
-	
+	//P only depends on the bucket numbers, so it is built while the buckets are reordered and compressed
+	thread builderP(buildP, this, bucketNumber);
 
-	this->numBuckets = floor((elements-1)/bucketsize)+1; //same as ceil(elements/bucketsize)
-
-	//Reorder the inside the buckets and get H 
-	/**MEJOR CON UN SORT**/
+	//Reorder the inside the buckets by ID and get H (each thread sorts a range of buckets)
 	size_t * headers = new size_t[numBuckets];
-	uint * finalOrder = new uint[elements]; //for saving the permutation between the lexicographically position and the final one
-	for(uint i=0; i<numBuckets-1; i++) //for each bucket (except the last one)
-	{
-		for(uint j=0; j<bucketsize; j++) //for each element of the bucket
-		{
-			uint aux = 0;
-			for(uint k=0; k<bucketsize; k++) //for each element of the bucket
-			{
-				//compare the IDs (the smallest one will be first)
-				if(itemsList[i*bucketsize+j].itemId > itemsList[i*bucketsize+k].itemId)
-					aux++;
-			}
-			//insert the actual element in the correct position
-			finalOrder[i*bucketsize+aux] = i*bucketsize+j;
-			//if it is the first element (lexicographically) store the position in the header array
-			if(j==0)
-				headers[i] = aux+1;
-		}
-	}
-	//reorder the last bucket
-	for(uint position = (numBuckets-1)*bucketsize; position<elements; position++) //for each element of the bucket
-	{
-		uint aux = 0;
-		for(uint k=(numBuckets-1)*bucketsize; k<elements; k++) //for each element of the bucket
-		{
-			if(itemsList[position].itemId > itemsList[k].itemId)
-				aux++;
-		}
-		finalOrder[(numBuckets-1)*bucketsize+aux] = position;
-		if(position == (numBuckets-1)*bucketsize)
-			headers[numBuckets-1] = aux+1;
-	}
+	size_t * finalOrder = new size_t[elements]; //for saving the permutation between the lexicographically position and the final one
+	uint bucketsPerThread = (numBuckets+threads-1)/threads;
+	vector<thread> reorders;
+	for(uint t=1; t<threads && t*bucketsPerThread<numBuckets; t++)
+		reorders.push_back(thread(reorderBuckets, &itemsList, bucketsize, t*bucketsPerThread, min(numBuckets, (t+1)*bucketsPerThread), finalOrder, headers));
+	reorderBuckets(&itemsList, bucketsize, 0, min(numBuckets, bucketsPerThread), finalOrder, headers);
+	for(uint t=0; t<reorders.size(); t++)
+		reorders[t].join();
 	
 	
 	//Make the logsecuence H
 	vector<size_t> headersList(headers, headers+numBuckets);
 	H = new LogSequence(&headersList, bits(numBuckets));
 	delete [] headers;
+	MemoryUsage::phase("buckets");
 	
 	
 	//Create the RPDAC
@@ -145,7 +124,7 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 	uint currentLen=0;
 	size_t processed = 0;
 	int *dict = new int[mBytes];
-	for(uint i=0; i<elements; i++)
+	for(size_t i=0; i<elements; i++)
 	{
 		current = itemsList[finalOrder[i]].itemText;
 		currentLen = strlen((char*)current);
@@ -156,12 +135,26 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 	}
 	
 	delete [] finalOrder;
-	rp = new RePair(dict, processed, 0);
+	vector<dictItem>().swap(itemsList); //the strings are in dict from now on
+	rp = new RePair(dict, processed, 0, options);
+	MemoryUsage::phase("RePair");
+	if(!rp->good())
+	{
+		//the strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] dict;
+		builderP.join();
+		delete [] bucketNumber;
+		elements = 0; numBuckets = 0;
+		return;
+	}
 	
 	
-	// Compacting the sequence (a -i value is inserted after the i-th string).
-	int *cdict = new int[processed];
-	uint io = 0, ic = 0, strings = 0;
+	// Compacting the sequence (a -1 value is inserted after each string).
+	// It is compacted in place: ic never overtakes io, so every value is
+	// read before its position is overwritten.
+	int *cdict = dict;
+	size_t io = 0, ic = 0;
 	uint maxseq = 0, currentseq = 0;
 
 	while (io<processed)
@@ -172,9 +165,7 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 			{
 				if (currentseq > maxseq) maxseq = currentseq;
 
-				strings++;
-
-				cdict[ic] = -strings;
+				cdict[ic] = -1;
 				io++; ic++;
 				currentseq = 0;
 			}
@@ -187,31 +178,57 @@ RankedStringDictionaryRPDAC::RankedStringDictionaryRPDAC(IteratorDictString *it,
 		}
 		else
 		{
-			if (io < processed) io = -(dict[io]+1);
+			if (io < processed) io = RePair::skipReplaced(dict, io);
 		}
 	}
 
 	// Building the array for the sequence
 	rp->Cdac = new DAC_VLS(cdict, ic-2, bits(rp->rules+rp->terminals), maxseq);
 
-	delete [] cdict;
 	delete [] dict;
+	
+	builderP.join();
+	delete [] bucketNumber;
+	MemoryUsage::phase("DAC");
+	
+	
+	//Store the strings of the first IDs uncompressed
+	if(topT>elements) topT=elements;
+	if(topT>0)
+	{
+		uchar **topStrings = new uchar*[topT];
+		uint topLen;
+		for(uint i=0; i<topT; i++)
+			topStrings[i] = extract(i+1, &topLen);
+		top = new RankedTopTier(topStrings, topT);
+		for(uint i=0; i<topT; i++)
+			delete [] topStrings[i];
+		delete [] topStrings;
+	}
+	
+	//Store a sample of the headers uncompressed
+	setHeaderSample(sampleRate);
 }
 
 
 
-uint RankedStringDictionaryRPDAC::locate(uchar *str, uint strLen)
+size_t RankedStringDictionaryRPDAC::locate(uchar *str, uint strLen)
 {
+	if(rp==NULL) return NORESULT; //the dictionary was left empty
+	
 	/**binary search for finding the bucket in which the element is**/
 	
 	//initialize the limits of the actual part of the search
 	uint left = 0;
 	uint right = numBuckets-1;
-	uint center = floor(numBuckets/2);
+	uint match;
+	if(sample!=NULL && sampleBuckets(str, strLen, false, &left, &right, &match)) //the header of a sampled bucket is the string searched
+		return P->select(match+1,H->getField(match))+1;
+	uint center = left + floor((right-left+1)/2);
 	//binary search
 	while(left!=right)
 	{
-		uint headerPosition = bucketsize*center + H->getField(center); //(bucketsize*center) gets the element inmidiatly before the center bucket
+		size_t headerPosition = (size_t)bucketsize*center + H->getField(center); //(bucketsize*center) gets the element inmidiatly before the center bucket
 		int compare = rp->extractStringAndCompareDAC(headerPosition, str, strLen);
 		
 		if(compare > 0) //the searched string is to the left
@@ -234,57 +251,171 @@ uint RankedStringDictionaryRPDAC::locate(uchar *str, uint strLen)
 	//search in the bucket for the string (if not found at the end return -1)
 	for(uint i=1; i<=bucketsize; i++)
 	{
-		uint elemPosition = bucketsize*center + i;
+		size_t elemPosition = (size_t)bucketsize*center + i;
 		int comp = rp->extractStringAndCompareDAC(elemPosition, str, strLen);
 		if(comp == 0) //if we found it return the position
 			return P->select(center+1,i)+1; //(the id of the element searched is P->select(bucketNumber,innerBucketPosition)+1, because P starts from 0
 	}
 	
-	//if we reach this point we have not found the string, so return -1
-	return -1;
+	//if we reach this point we have not found the string
+	return NORESULT;
+}
+
+
+
+void RankedStringDictionaryRPDAC::locateBatch(uchar **strings, uint *lengths, uint n, size_t *ids)
+{
+	if(n==0) return;
+	
+	//the positions of the batch sorted by their strings
+	uint *order = new uint[n];
+	for(uint i=0; i<n; i++)
+	{
+		order[i]=i;
+		ids[i]=NORESULT;
+	}
+	if(rp==NULL) //the dictionary was left empty
+	{
+		delete [] order;
+		return;
+	}
+	BatchOrder batchOrder(strings, lengths);
+	sort(order, order+n, batchOrder);
+	
+	locateGroup(strings, lengths, order, 0, n, 0, numBuckets-1, ids);
+	
+	delete [] order;
+}
+
+
+
+void RankedStringDictionaryRPDAC::locateGroup(uchar **strings, uint *lengths, uint *order, uint lo, uint hi, uint left, uint right, size_t *ids)
+{
+	if(lo>=hi) return;
+	
+	uint len;
+	if(left!=right)
+	{
+		/*the same step of the binary search of locate, but the header is decompressed once for the whole group*/
+		uint center = left + floor((right-left+1)/2);
+		uchar *header = extractPosition((size_t)bucketsize*center + H->getField(center), &len);
+		
+		//the group is sorted: [lo, lower) is to the left, [lower, upper) is the header and [upper, hi) is to the right
+		uint lower = lo, upper;
+		while(lower<hi && compareStrings(header, len, strings[order[lower]], lengths[order[lower]]) > 0)
+			lower++;
+		upper = lower;
+		while(upper<hi && compareStrings(header, len, strings[order[upper]], lengths[order[upper]]) == 0)
+			upper++;
+		delete [] header;
+		
+		if(lower<upper)
+		{
+			size_t id = P->select(center+1,H->getField(center))+1;
+			for(uint i=lower; i<upper; i++)
+				ids[order[i]] = id;
+		}
+		
+		locateGroup(strings, lengths, order, lo, lower, left, center-1, ids);
+		locateGroup(strings, lengths, order, upper, hi, center, right, ids);
+		return;
+	}
+	
+	//all the strings of the group are in the bucket left: each string of the bucket is decompressed once
+	uint elementsInBucket = bucketElements(left);
+	for(uint i=1; i<=elementsInBucket && lo<hi; i++)
+	{
+		uchar *str = extractPosition((size_t)bucketsize*left + i, &len);
+		
+		//binary search of the string in the group
+		uint l = lo, r = hi;
+		while(l<r)
+		{
+			uint c = l+(r-l)/2;
+			if(compareStrings(strings[order[c]], lengths[order[c]], str, len) < 0) l = c+1;
+			else r = c;
+		}
+		
+		if(l<hi && compareStrings(strings[order[l]], lengths[order[l]], str, len) == 0)
+		{
+			size_t id = P->select(left+1,i)+1;
+			while(l<hi && compareStrings(strings[order[l]], lengths[order[l]], str, len) == 0)
+			{
+				ids[order[l]] = id;
+				l++;
+			}
+		}
+		delete [] str;
+	}
 }
 
 
 
 uchar* RankedStringDictionaryRPDAC::extract(size_t id, uint *strLen)
 {
+	return extract(id, strLen, NULL);
+}
+
+
+
+uchar* RankedStringDictionaryRPDAC::extract(size_t id, uint *strLen, RankedQueryContext *context)
+{
+	if(context!=NULL) context->reset();
+	
     //if the id its higher than the number of elements return 0
     if(id>elements || id==0)
     {
-		uchar *s = new uchar[1];
+		uchar *s = RankedQueryContext::alloc<uchar>(context, 1);
 		s[0]='\0';
 		return s;
 	}
+	
+	//the most popular strings are stored uncompressed
+	if(top!=NULL && top->contains(id))
+		return extractString(id, 0, strLen, context);
     
 	id--; //the positions of the sctructures starts from 0
 	//Firstly obtain the bucketNumber and the position inside the bucket
 	size_t bucketPos;
 	uint bucketNumber = P->access(id, bucketPos);
 	//get the position of the element in the RPDAC
-	uint rpPos = bucketsize*(bucketNumber-1) + bucketPos;
+	size_t rpPos = (size_t)bucketsize*(bucketNumber-1) + bucketPos;
 	
 	//extract the string from the RPDAC
-	uint *rules;
-	uint len = rp->Cdac->access(rpPos, &rules);
-	uchar *s = new uchar[maxlength+1];
-			
-	*strLen = 0;
-			
-	for (uint i=0; i<len; i++)
+	return extractPosition(rpPos, strLen, context);
+}
+
+
+
+uint RankedStringDictionaryRPDAC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if(id>elements || id==0)
+		return 0;
+	
+	//the most popular strings are copied from the top tier
+	if(top!=NULL && top->contains(id))
 	{
-		if (rules[i] >= rp->terminals) 
-			(*strLen) += rp->expandRule(rules[i]-rp->terminals, (s+(*strLen)));
-		else
-		{
-			s[*strLen] = (uchar)rules[i];
-			(*strLen)++;
-		}
+		uint strLen;
+		uchar *str = top->access(id, &strLen);
+		if(strLen<cap) memcpy(buf, str, strLen+1);
+		return strLen;
 	}
-			
-	s[*strLen] = (uchar)'\0';
-	delete [] rules;
-			
-	return s;
+	
+	if(cap<extractCapacity())
+		return RankedStringDictionary::extractInto(id, buf, cap);
+	
+	//the string is decoded directly in the buffer
+	id--;
+	size_t bucketPos;
+	uint bucketNumber = P->access(id, bucketPos);
+	return decodePosition((size_t)bucketsize*(bucketNumber-1) + bucketPos, buf);
+}
+
+
+
+size_t RankedStringDictionaryRPDAC::extractCapacity()
+{
+	return maxlength+1;
 }
 
 
@@ -298,9 +429,9 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::locatePrefix(uchar *str, uint
 	
 	//get the ids from the positions
 	size_t * ids = new size_t[numLocated];
-	for(uint i=0; i<numLocated; i++)
+	for(size_t i=0; i<numLocated; i++)
 	{	
-		uint position = prefIt->next();
+		size_t position = prefIt->next();
 		uint bucket = floor((position-1) / bucketsize);
 		uint innerPos = (position % bucketsize);
 		if(innerPos==0) innerPos=bucketsize;
@@ -325,7 +456,7 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::locateSubstr(uchar *str, uint
 
 
 
-uint RankedStringDictionaryRPDAC::locateRank(uint rank)
+size_t RankedStringDictionaryRPDAC::locateRank(size_t rank)
 {
     return rank;
 }
@@ -356,7 +487,7 @@ IteratorRankedDictString* RankedStringDictionaryRPDAC::extractSubstr(uchar *str,
 
 
 
-uchar* RankedStringDictionaryRPDAC::extractRank(uint rank, uint *strLen)
+uchar* RankedStringDictionaryRPDAC::extractRank(size_t rank, uint *strLen)
 {
     return extract(rank, strLen);
 }
@@ -366,16 +497,81 @@ uchar* RankedStringDictionaryRPDAC::extractRank(uint rank, uint *strLen)
 
 IteratorRankedDictString* RankedStringDictionaryRPDAC::extractTable()
 {
-cerr << "This dictionary does not provide table extraction" << endl;
-    return NULL;
+	return tableIterator();
 }
 
 
 
+//orders the strings of a bucket (decoded in slots of the same size) alphabetically
+struct BucketOrder
+{
+	uchar *text;
+	size_t slot;
+	BucketOrder(uchar *_text, size_t _slot) : text(_text), slot(_slot) {}
+	bool operator()(uint i, uint j) { return strcmp((char*)(text+i*slot), (char*)(text+j*slot)) < 0; }
+};
+
+
+
+bool RankedStringDictionaryRPDAC::decodeTable(bool lexicographic, RankedTableBlock *block)
+{
+	size_t first = block->getFirst();
+	size_t count = block->getCount();
+	if(count==0) return true;
+	
+	if(!lexicographic)
+	{
+		//each ID is decoded from its position in the RPDAC
+		for(size_t slot=0; slot<count; slot++)
+		{
+			size_t bucketPos;
+			uint bucketNumber = P->access(first+slot-1, bucketPos);
+			uchar *s = block->reserve(maxlength+1);
+			block->commit(slot, decodePosition((size_t)bucketsize*(bucketNumber-1) + bucketPos, s));
+		}
+		return true;
+	}
+	
+	//the buckets of the range are decoded sequentially; their strings are stored by ID, so each one is sorted
+	size_t slotSize = maxlength+1;
+	vector<uchar> bucketText((size_t)bucketsize*slotSize);
+	vector<uint> lens(bucketsize), order(bucketsize);
+	
+	size_t last = first+count-1;
+	for(size_t b=(first-1)/bucketsize; b<=(last-1)/bucketsize; b++)
+	{
+		uint bucketCount = min((size_t)bucketsize, (size_t)elements-(size_t)b*bucketsize);
+		for(uint i=0; i<bucketCount; i++)
+		{
+			lens[i] = decodePosition((size_t)b*bucketsize+i+1, &bucketText[i*slotSize]);
+			order[i] = i;
+		}
+		sort(order.begin(), order.begin()+bucketCount, BucketOrder(&bucketText[0], slotSize));
+		
+		for(uint r=0; r<bucketCount; r++)
+		{
+			size_t position = (size_t)b*bucketsize+r+1;
+			if(position>=first && position<=last)
+				block->add(position-first, &bucketText[order[r]*slotSize], lens[order[r]]);
+		}
+	}
+	return true;
+}
+
+
+
+
+bool RankedStringDictionaryRPDAC::good()
+{
+	return rp!=NULL;
+}
 
 size_t RankedStringDictionaryRPDAC::getSize()
 {
-    return rp->getSize() + P->getSize() + H->getSize() + sizeof(RankedStringDictionaryRPDAC);
+	size_t topSize = (top!=NULL) ? top->getSize() : 0;
+	size_t sampleSize = (sample!=NULL) ? sample->getSize() : 0;
+	if(rp==NULL) return sizeof(RankedStringDictionaryRPDAC);
+    return rp->getSize() + P->getSize() + H->getSize() + topSize + sampleSize + sizeof(RankedStringDictionaryRPDAC);
 }
 
 
@@ -397,17 +593,15 @@ size_t RankedStringDictionaryRPDAC::numElements()
 
 void RankedStringDictionaryRPDAC::save(ofstream &out)
 {
-	//save type, elements and maxlength (common for every RankedDictionary)
-    saveValue<uint32_t>(out, type);
-    saveValue<uint64_t>(out, elements);
-    saveValue<uint32_t>(out, maxlength);
-	
-	//save bucketsize, number of buckets, RPDAC, P and H (specific of this dictionary)
-    saveValue<uint32_t>(out, bucketsize);
-	saveValue<uint32_t>(out, numBuckets);
-	rp->save(out, RPDAC);
-	P->save(out);
-	H->save(out);
+	if(rp==NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+	
+	//the sections are stored back to back
+	for(uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 	if(rp==NULL) cout<<"NULLrp"<<endl;
 	if(P==NULL) cout<<"NULLP"<<endl;
 	if(H==NULL) cout<<"NULLH"<<endl;
@@ -416,20 +610,17 @@ void RankedStringDictionaryRPDAC::save(ofstream &out)
 
 
 
-RankedStringDictionary * RankedStringDictionaryRPDAC::load(ifstream &in)
+RankedStringDictionary * RankedStringDictionaryRPDAC::load(ifstream &in, const RePairOptions &options)
 {
     RankedStringDictionaryRPDAC * dict = new RankedStringDictionaryRPDAC();
-	//load elements and maxlength (common for every RankedDictionary)
-    dict->type = RDRPDAC;
-    dict->elements = loadValue<uint64_t>(in);
-    dict->maxlength = loadValue<uint32_t>(in);
-	
-	//load bucketsize, number of buckets, RPDAC, P and H (specific of this dictionary)
-	dict->bucketsize = loadValue<uint32_t>(in);
-	dict->numBuckets = loadValue<uint32_t>(in);
-    dict->rp = RePair::load(in);
-	dict->P = WaveletTreeNoptrs::load(in);
-	dict->H = new LogSequence(in); //the LogSequence doesn't have load, it has a constructor with the in file
+	for(uint s=0; s<SECTIONS; s++)
+	{
+		if(!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 	if(dict->rp==NULL) cout<<"NULLrp"<<endl;
 	if(dict->P==NULL) cout<<"NULLP"<<endl;
 	if(dict->H==NULL) cout<<"NULLH"<<endl;
@@ -437,22 +628,134 @@ RankedStringDictionary * RankedStringDictionaryRPDAC::load(ifstream &in)
 }
 
 
+
+
+uint RankedStringDictionaryRPDAC::numSections()
+{
+	return SECTIONS;
+}
+
+
+
+
+void RankedStringDictionaryRPDAC::saveSection(uint section, ofstream &out)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			//save type, elements and maxlength (common for every RankedDictionary)
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+
+			//save bucketsize and number of buckets (specific of this dictionary)
+			saveValue<uint32_t>(out, bucketsize);
+			saveValue<uint32_t>(out, numBuckets);
+			break;
+		}
+		case 1: rp->save(out, RPDAC); break;
+		case 2: P->save(out); break;
+		case 3: H->save(out); break;
+		case 4:
+		{
+			//save the top tier (0 if there is not)
+			if(top!=NULL) top->save(out);
+			else saveValue<uint32_t>(out, 0);
+
+			//save the header sample (0 if there is not)
+			if(sample!=NULL) sample->save(out);
+			else saveValue<uint32_t>(out, 0);
+			break;
+		}
+	}
+}
+
+
+
+
+bool RankedStringDictionaryRPDAC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			//load elements and maxlength (common for every RankedDictionary)
+			type = RDRPDAC;
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+
+			//load bucketsize and number of buckets (specific of this dictionary)
+			bucketsize = loadValue<uint32_t>(in);
+			numBuckets = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1: rp = RePair::load(in, options); return rp!=NULL;
+		case 2: P = WaveletTreeNoptrs::load(in); return P!=NULL;
+		case 3: H = new LogSequence(in); return in.good(); //the LogSequence doesn't have load, it has a constructor with the in file
+		case 4:
+		{
+			//load the top tier (dictionaries saved before it was added end here)
+			if(in.peek()!=EOF)
+			{
+				streampos tierPos = in.tellg();
+				if(loadValue<uint32_t>(in)>0)
+				{
+					in.seekg(tierPos);
+					top = RankedTopTier::load(in);
+				}
+			}
+
+			//load the header sample (dictionaries saved before it was added end here)
+			if(in.peek()!=EOF)
+			{
+				streampos samplePos = in.tellg();
+				if(loadValue<uint32_t>(in)>0)
+				{
+					in.seekg(samplePos);
+					sample = RankedHeaderSample::load(in);
+				}
+			}
+			in.clear(); //peek at the end of the file sets eof
+			return true;
+		}
+	}
+	return false;
+}
+
+
 IteratorRankedDictID* RankedStringDictionaryRPDAC::locateRankedPrefix(uchar *str, uint strLen, uint k)
 {
+	return locateRankedPrefix(NULL, str, strLen, k);
+}
+
+
+IteratorRankedDictID* RankedStringDictionaryRPDAC::locateRankedPrefix(RankedPrefixSession *session, uchar *str, uint strLen, uint k, RankedQueryContext *context)
+{
+	if(context!=NULL) context->reset();
+	bool owner = (context==NULL); //the iterator frees the ids only if they are not in the context
+	
+	//the answer can be in the top tier (the session range remains valid for the next prefixes)
+	if(top!=NULL)
+	{
+		size_t * topIds = RankedQueryContext::alloc<size_t>(context, k);
+		if(top->topKprefix(str, strLen, k, topIds))
+			return new IteratorRankedDictIDNoContiguous(topIds, k, owner);
+		RankedQueryContext::release(context, topIds);
+	}
+	
 	//obtain the ids
 	size_t numLocated=0;
-	size_t ** ids = topKprefix(str, strLen, k, &numLocated);
+	size_t ** ids = topKprefix(str, strLen, k, &numLocated, session, context);
 	
-	size_t * finalIds = new size_t[numLocated];
+	size_t * finalIds = RankedQueryContext::alloc<size_t>(context, numLocated);
 	for(uint i=0; i<numLocated;i++)
 		finalIds[i]=ids[1][i];
 	
-	delete [] ids[0];
-	delete [] ids[1];
-	delete [] ids;
+	deleteTopK(ids, context);
 	
 	/*Create a non contiguous ID iterator*/
-	IteratorRankedDictID* it = new IteratorRankedDictIDNoContiguous(finalIds, numLocated);
+	IteratorRankedDictID* it = new IteratorRankedDictIDNoContiguous(finalIds, numLocated, owner);
 	
 	
     return it;
@@ -462,43 +765,37 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::locateRankedPrefix(uchar *str
 
 IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedPrefix(uchar *str, uint strL, uint k)
 {
+	return extractRankedPrefix(NULL, str, strL, k);
+}
+
+
+IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedPrefix(RankedPrefixSession *session, uchar *str, uint strL, uint k, RankedQueryContext *context)
+{
+	if(context!=NULL) context->reset();
+	vector<uchar*> strings;
+	uint strLen;
+	
+	//the answer can be in the top tier (the session range remains valid for the next prefixes)
+	if(top!=NULL)
+	{
+		size_t * topIds = RankedQueryContext::alloc<size_t>(context, k);
+		bool found = top->topKprefix(str, strL, k, topIds);
+		if(found)
+			for(uint i=0; i<k; i++)
+				strings.push_back(extractString(topIds[i], 0, &strLen, context));
+		RankedQueryContext::release(context, topIds);
+		if(found)
+			return new IteratorRankedDictStringVector(&strings, k);
+	}
+	
 	//obtain the ids
 	size_t numLocated=0;
-	size_t ** ids = topKprefix(str, strL, k, &numLocated);
+	size_t ** ids = topKprefix(str, strL, k, &numLocated, session, context);
 	
 	//for each id obtain the string
-	vector<uchar*> strings;
 	for(uint i=0; i<numLocated; i++)
-	{
-		//extract the string from the RPDAC
-		uint *rules;
-		uint len = rp->Cdac->access(ids[0][i], &rules);
-		uchar *s = new uchar[maxlength+1];
-			
-		uint strLen = 0;
-			
-		for (uint i=0; i<len; i++)
-		{
-			if (rules[i] >= rp->terminals) 
-				strLen += rp->expandRule(rules[i]-rp->terminals, (s+strLen));
-			else
-			{
-				s[strLen] = (uchar)rules[i];
-				strLen++;
-			}
-		}
-			
-		s[strLen] = (uchar)'\0';
-		delete [] rules;
-			
-		strings.push_back(s);
-	}
-	if(ids!=NULL)
-	{
-		delete [] ids[0];
-		delete [] ids[1];
-		delete [] ids;
-	}
+		strings.push_back(extractString(ids[1][i], ids[0][i], &strLen, context));
+	deleteTopK(ids, context);
 	
 	IteratorRankedDictString* it = new IteratorRankedDictStringVector(&strings, numLocated);
 	
@@ -507,59 +804,291 @@ IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedPrefix(uchar
 
 
 
-IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedInterval(uint beginning, uint len, uint k)
+IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedInterval(size_t beginning, size_t len, uint k)
 {
+	return extractRankedInterval(beginning, len, k, NULL);
+}
+
+
+IteratorRankedDictString* RankedStringDictionaryRPDAC::extractRankedInterval(size_t beginning, size_t len, uint k, RankedQueryContext *context)
+{
+	if(context!=NULL) context->reset();
+	vector<uchar*> strings;
+	if(rp==NULL) //the dictionary was left empty
+		return new IteratorRankedDictStringVector(&strings, 0);
+	
 	//obtain the ids
-	size_t ** ids = topKInterval(beginning, len, k);
+	size_t ** ids = topKInterval(beginning, len, k, context);
 	
 	if(len<k)
 		k=len;
 	
 	//for each id obtain the string
-	vector<uchar*> strings;
+	uint strLen;
 	for(uint i=0; i<k; i++)
+		strings.push_back(extractString(ids[1][i], ids[0][i], &strLen, context));
+	deleteTopK(ids, context);
+	
+	IteratorRankedDictString* it = new IteratorRankedDictStringVector(&strings, k);
+	
+	return it;
+}
+
+
+IteratorRankedDictIDTopK* RankedStringDictionaryRPDAC::locateRankedPrefixLazy(uchar *str, uint strLen, RankedTopKToken *resume)
+{
+	RankedTopKFrontier *frontier = prefixFrontier(str, strLen, resume);
+	if(frontier==NULL) return NULL;
+	return new IteratorRankedDictIDTopK(this, frontier);
+}
+
+
+IteratorRankedDictStringTopK* RankedStringDictionaryRPDAC::extractRankedPrefixLazy(uchar *str, uint strLen, RankedTopKToken *resume)
+{
+	IteratorRankedDictIDTopK *ids = locateRankedPrefixLazy(str, strLen, resume);
+	if(ids==NULL) return NULL;
+	return new IteratorRankedDictStringTopK(this, ids);
+}
+
+
+IteratorRankedDictStringTopK* RankedStringDictionaryRPDAC::extractRankedIntervalLazy(size_t beginning, size_t len, RankedTopKToken *resume)
+{
+	RankedTopKFrontier *frontier = intervalFrontier(beginning, len, resume);
+	if(frontier==NULL) return NULL;
+	IteratorRankedDictIDTopK *ids = new IteratorRankedDictIDTopK(this, frontier);
+	return new IteratorRankedDictStringTopK(this, ids);
+}
+
+
+RankedStringDictionaryRPDAC::~RankedStringDictionaryRPDAC()
+{
+	if(rp!=NULL) delete rp;
+	if(P!=NULL) delete P;
+	if(H!=NULL) delete H;
+	if(top!=NULL) delete top;
+	if(sample!=NULL) delete sample;
+}
+
+
+
+void RankedStringDictionaryRPDAC::setHeaderSample(uint rate)
+{
+	if(sample!=NULL) delete sample;
+	sample = NULL;
+	if(rate==0 || numBuckets==0) return;
+	
+	uint n = (numBuckets-1)/rate+1;
+	uchar **headers = new uchar*[n];
+	uint len;
+	for(uint i=0; i<n; i++)
 	{
-		//extract the string from the RPDAC
-		uint *rules;
-		uint len = rp->Cdac->access(ids[0][i], &rules);
-		uchar *s = new uchar[maxlength+1];
-			
-		uint strLen = 0;
-			
-		for (uint i=0; i<len; i++)
+		uint bucket = i*rate;
+		headers[i] = extractPosition((size_t)bucketsize*bucket + H->getField(bucket), &len);
+	}
+	sample = new RankedHeaderSample(headers, n, rate);
+	for(uint i=0; i<n; i++)
+		delete [] headers[i];
+	delete [] headers;
+}
+
+
+
+bool RankedStringDictionaryRPDAC::rerank(size_t *newIds)
+{
+	if(rp==NULL)
+	{
+		cerr << "The dictionary was not built and cannot be reranked" << endl;
+		return false;
+	}
+	
+	//check that the new IDs are a permutation
+	vector<bool> used(elements, false);
+	for(size_t i=0; i<elements; i++)
+	{
+		if(newIds[i]==0 || newIds[i]>elements || used[newIds[i]-1])
 		{
-			if (rules[i] >= rp->terminals) 
-				strLen += rp->expandRule(rules[i]-rp->terminals, (s+strLen));
-			else
-			{
-				s[strLen] = (uchar)rules[i];
-				strLen++;
-			}
+			cerr << "The new IDs are not a permutation of 1.." << elements << endl;
+			return false;
 		}
+		used[newIds[i]-1] = true;
+	}
+	
+	/*new order inside each bucket (by the new IDs) and new headers*/
+	uint * bucketNumber = new uint[elements]; //indexed by ID (the values are bucket numbers, the symbols of P)
+	uint * oldInPos = new uint[elements]; //inner position (in the current sequence) of each new position
+	size_t * headers = new size_t[numBuckets];
+	vector< pair<size_t,uint> > bucket; //(new ID, current inner position) of the strings in the bucket
+	bucket.reserve(bucketsize);
+	for(uint b=0; b<numBuckets; b++)
+	{
+		uint elementsInBucket = bucketElements(b);
+		bucket.clear();
+		for(uint i=1; i<=elementsInBucket; i++)
+		{
+			size_t newId = newIds[P->select(b+1,i)]; //P->select(b+1,i)+1 is the current ID
+			bucket.push_back(pair<size_t,uint>(newId, i));
+			bucketNumber[newId-1] = b+1;
+		}
+		
+		//the smallest ID will be first
+		sort(bucket.begin(), bucket.end());
+		
+		uint header = H->getField(b);
+		for(uint j=0; j<bucket.size(); j++)
+		{
+			oldInPos[(size_t)b*bucketsize+j] = bucket[j].second;
+			if(bucket[j].second==header)
+				headers[b] = j+1;
+		}
+	}
+	
+	//P only depends on the bucket numbers, so it is built while the DAC sequence is encoded
+	delete P;
+	thread builderP(buildP, this, bucketNumber);
+	
+	vector<size_t> headersList(headers, headers+numBuckets);
+	delete H;
+	H = new LogSequence(&headersList, bits(numBuckets));
+	delete [] headers;
+	
+	
+	/*encode the sequences of rules of the strings in their new order (with the same format as the constructor)*/
+	vector<int> cdict;
+	uint maxseq = 0;
+	for(uint b=0; b<numBuckets; b++)
+	{
+		uint elementsInBucket = bucketElements(b);
+		for(uint j=0; j<elementsInBucket; j++)
+		{
+			uint *rules;
+			uint len = rp->Cdac->access((size_t)b*bucketsize+oldInPos[(size_t)b*bucketsize+j], &rules);
+			for(uint r=0; r<len; r++)
+				cdict.push_back(rules[r]);
+			delete [] rules;
 			
-		s[strLen] = (uchar)'\0';
-		delete [] rules;
-			
-		strings.push_back(s);
+			if(len > maxseq) maxseq = len;
+			cdict.push_back(-1);
+		}
 	}
-	if(ids!=NULL)
+	delete [] oldInPos;
+	
+	delete rp->Cdac;
+	rp->Cdac = new DAC_VLS(&cdict[0], cdict.size()-2, bits(rp->rules+rp->terminals), maxseq);
+	
+	builderP.join();
+	delete [] bucketNumber;
+	
+	
+	//the top tier contains other strings now
+	if(top!=NULL)
 	{
-		delete [] ids[0];
-		delete [] ids[1];
-		delete [] ids;
+		uint topT = top->size();
+		delete top;
+		top = NULL;
+		
+		uchar **topStrings = new uchar*[topT];
+		uint topLen;
+		for(uint i=0; i<topT; i++)
+			topStrings[i] = extract(i+1, &topLen);
+		top = new RankedTopTier(topStrings, topT);
+		for(uint i=0; i<topT; i++)
+			delete [] topStrings[i];
+		delete [] topStrings;
 	}
 	
-	IteratorRankedDictString* it = new IteratorRankedDictStringVector(&strings, k);
+	return true;
+}
+
+
+
+bool RankedStringDictionaryRPDAC::sampleBuckets(uchar *str, uint strLen, bool prefix, uint *left, uint *right, uint *match)
+{
+	uint less, lessEqual;
+	sample->bounds(str, strLen, prefix, &less, &lessEqual);
+	size_t rate = sample->getRate();
 	
-	return it;
+	if(lessEqual>less) //a sampled header is equal to the string (or prefixed by it)
+	{
+		*match = (prefix) ? less*rate : (lessEqual-1)*rate;
+		if(*match<*left || *match>*right) return false; //out of the range (the range is not narrowed)
+		if(less>0 && (less-1)*rate>*left) *left = (less-1)*rate;
+		if(lessEqual*rate-1<*right) *right = lessEqual*rate-1;
+		return true;
+	}
+	
+	//the searched buckets are between two consecutive sampled headers
+	size_t sampleLeft = (less>0) ? (less-1)*rate : 0;
+	size_t sampleRight = (less>0) ? less*rate-1 : 0;
+	if(sampleLeft>*left && sampleLeft<=*right) *left = sampleLeft;
+	if(sampleRight<*right && sampleRight>=*left) *right = sampleRight;
+	return false;
 }
 
 
-RankedStringDictionaryRPDAC::~RankedStringDictionaryRPDAC()
+
+uchar* RankedStringDictionaryRPDAC::extractPosition(size_t rpPos, uint *strLen, RankedQueryContext *context)
 {
-	if(rp!=NULL) delete rp;
-	if(P!=NULL) delete P;
-	if(H!=NULL) delete H;
+	uchar *s = RankedQueryContext::alloc<uchar>(context, maxlength+1);
+	*strLen = decodePosition(rpPos, s);
+	return s;
+}
+
+
+
+uint RankedStringDictionaryRPDAC::decodePosition(size_t rpPos, uchar *s)
+{
+	uint strLen = 0;
+	
+	if(rpPos == 0 || rpPos > elements)
+	{
+		cerr << "[ERROR] The position " << rpPos << " is not in the RPDAC (1 to " << elements << ")" << endl;
+		s[0] = (uchar)'\0';
+		return 0;
+	}
+	
+	//the rules are read one by one from the DAC levels (without obtaining the whole sequence)
+	uint l = 0;
+	size_t pos = rpPos;
+	while (pos != DAC_VLS::END)
+	{
+		uint rule = rp->Cdac->access_next(l, &pos);
+		if (rule >= rp->terminals) 
+			strLen += rp->expandRule(rule-rp->terminals, (s+strLen));
+		else
+		{
+			s[strLen] = (uchar)rule;
+			strLen++;
+		}
+		l++;
+	}
+			
+	s[strLen] = (uchar)'\0';
+			
+	return strLen;
+}
+
+
+
+uchar* RankedStringDictionaryRPDAC::extractString(size_t id, size_t rpPos, uint *strLen, RankedQueryContext *context)
+{
+	if(top!=NULL && top->contains(id))
+	{
+		uchar *str = top->access(id, strLen);
+		uchar *s = RankedQueryContext::alloc<uchar>(context, *strLen+1);
+		memcpy(s, str, *strLen+1);
+		return s;
+	}
+	return extractPosition(rpPos, strLen, context);
+}
+
+
+
+void RankedStringDictionaryRPDAC::deleteTopK(size_t **ids, RankedQueryContext *context)
+{
+	if(ids==NULL) return;
+	RankedQueryContext::release(context, ids[0]);
+	RankedQueryContext::release(context, ids[1]);
+	RankedQueryContext::release(context, ids);
 }
 
 
@@ -568,18 +1097,28 @@ RankedStringDictionaryRPDAC::~RankedStringDictionaryRPDAC()
 
 IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint strLen, size_t* numLocated)
 {
+	if(rp==NULL) //the dictionary was left empty
+	{
+		*numLocated = 0;
+		return NULL;
+	}
+	
 	/*Search for the first and last buckets containing the prefix*/
 	
 	//find any bucket containing the prefix (using binary search)
 	//initialize the limits of the actual part of the search
 	uint left = 0;
 	uint right = numBuckets-1;
-	uint center = floor(numBuckets/2);
+	uint center;
 	bool found = false;
+	if(sample!=NULL && sampleBuckets(str, strLen, true, &left, &right, &center)) //the header of a sampled bucket matches the prefix
+		found = true;
+	else
+		center = left + floor((right-left+1)/2);
 	//start the binary search
 	while(!found && left!=right)
 	{
-		uint headerPosition = bucketsize*center + H->getField(center); //(bucketsize*center-1) gets the element inmidiatly before the center bucket
+		size_t headerPosition = (size_t)bucketsize*center + H->getField(center); //(bucketsize*center-1) gets the element inmidiatly before the center bucket
 		int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
 		
 		if(compare > 0) //the searched prefix is to the left
@@ -610,7 +1149,7 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint s
 		else actBucketSize=bucketsize;
 		for(uint i=1; i<=actBucketSize; i++)
 		{
-			uint actPos = bucketsize*center + i;
+			size_t actPos = (size_t)bucketsize*center + i;
 			uint comp = rp->extractPrefixAndCompareDAC(actPos, str, strLen);
 			if(comp==0) //found an element with the prefix, so store its ID
 			{
@@ -629,16 +1168,16 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint s
 		uint first = 0;
 		uint last = numBuckets-1;
 		
-		ids = new size_t[(last-first+1)*bucketsize];
+		ids = new size_t[(size_t)(last-first+1)*bucketsize];
 		
 
 		//search the first bucket
 		uint L = 0;
-		uint R = center-1;
+		uint R = (center>0) ? center-1 : 0;
 		uint C = floor((R-L+1)/2);
 		while(L<R)
 		{
-			uint headerPosition = bucketsize*C + H->getField(C);
+			size_t headerPosition = (size_t)bucketsize*C + H->getField(C);
 			int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
 			if(compare == 0) //the first bucket is to the left
 				R=C-1;
@@ -656,7 +1195,7 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint s
 		C=floor((R-L+1)/2)+L;
 		while(L<R)
 		{
-			uint headerPosition = bucketsize*C + H->getField(C);
+			size_t headerPosition = (size_t)bucketsize*C + H->getField(C);
 			int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
 			if(compare == 0) //the last bucket is to the right (or in the actual)
 				L=C;
@@ -673,7 +1212,7 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint s
 		//first bucket
 		for(uint i=1; i<=bucketsize; i++)
 		{
-			uint actPos = bucketsize*first + i;
+			size_t actPos = (size_t)bucketsize*first + i;
 			uint comp = rp->extractPrefixAndCompareDAC(actPos, str, strLen);
 			if(comp==0) //found an element with the prefix, so store its ID
 			{
@@ -685,308 +1224,163 @@ IteratorRankedDictID* RankedStringDictionaryRPDAC::findPrefix(uchar *str, uint s
 		//the buckets between first and last (in this ones it's not necesary to compare if the strings have the prefix)
 		for(uint actBucket=first+1; actBucket<last; actBucket++) //for each bucket
 		{
-			for(uint i=1; i<=bucketsize; i++) //for each element of the bucket
-			{
-				ids[*numLocated] = actBucket*bucketsize + i;
-				*numLocated=*numLocated+1;
-			}
-		}
-
-		//last bucket
-		for(uint i=1; i<=bucketsize; i++)
-		{
-			uint actPos = bucketsize*last + i;
-			uint comp = rp->extractPrefixAndCompareDAC(actPos, str, strLen);
-			if(comp==0) //found an element with the prefix, so store its ID
-			{
-				ids[*numLocated] = actPos;
-				*numLocated=*numLocated+1;
-			}
-		}
-		
-	}
-	
-	/*Create a non contiguous ID iterator*/
-	IteratorRankedDictID* it = new IteratorRankedDictIDNoContiguous(ids, *numLocated);
-	
-    return it;
-}
-
-
-
-
-
-RankedPrefixNode ** RankedStringDictionaryRPDAC::createAuxiliarTree(uint first, uint last, uint *differentBits, uint *numNodes)
-{
-	first++; //in the tree buckets starts from 1
-	last++; //in the tree buckets starts from 1
-	
-	//Find the common bits prefix of the first and last symbols, and get the number of different bits
-	uint auxFirst=first;
-	uint auxLast=last;
-	*differentBits=0;
-	while(auxFirst!=auxLast) //Find the not common bits
-	{
-		auxFirst >>= 1;
-		auxLast >>= 1;
-		*differentBits+=1;
-	}
-	
-	//Obtain the levels array with the number of elements of each level (level 0 refers to the leaves)
-	uint * levels = new uint[*differentBits]; 
-	auxFirst=first;
-	auxLast=last;
-	*numNodes=0;
-	for(uint i=0; i<*differentBits; i++)
-	{
-		levels[i]=auxLast-auxFirst+1;
-		auxFirst=auxFirst>>1;
-		auxLast=auxLast>>1;
-		*numNodes+=levels[i];
-	}
-	
-	//Create an array for storing the auxiliar tree
-	RankedPrefixNode ** auxTree = new RankedPrefixNode*[*numNodes+1]; //the tree also stores the pivot node
-
-	/*CREATE AND INITIALIZE THE TREE*/
-	int father = levels[0];
-	int pos=0;
-	
-	/*initialize the leaves*/
-	uint symbol=first;
-	auxTree[father]= new RankedPrefixNode(); //create an empty node for the first father
-	for(uint i=0; i<levels[0]; i++)
-	{
-		//create the leaf node
-		size_t ptr=1;
-		auxTree[pos] = new RankedPrefixNode(ptr,father); //create the leaf node
-		if((1 & symbol) !=0 ) //is a rightChild
-		{
-			auxTree[father]->setRightson(pos);
-			//set right
-			size_t right = P->selectInLevel( symbol, auxTree[pos]->getPtr(), 1 );
-			auxTree[father]->setRight(right);
-			
-			if(i<levels[0]-1)//if it is not the last node of the level
-			{
-				father++;
-				auxTree[father]= new RankedPrefixNode(); //create an empty node for the next father
-			}	
-		}
-		else //is a left child
-		{
-			auxTree[father]->setLeftson(pos);
-			//set left
-			size_t left = P->selectInLevel( symbol, auxTree[pos]->getPtr(), 1 );
-			auxTree[father]->setLeft(left);
-		}
-		
-		pos++;
-		symbol+=1;
-	}
-	
-	
-	/*initialize the internal nodes*/
-	uint mask=1;
-	for(uint i=1; i<*differentBits; i++) //for each level starting from down
-	{		
-		//create an empty node for the father of the first node
-		father++;
-		auxTree[father] = new RankedPrefixNode();
-		
-		symbol=first;
-		mask <<= 1;
-				
-		for(uint j=0; j<levels[i]; j++) //for each element of the level
-		{
-			//it's not necesary to create the node (was created by the son)
-			
-			//set father
-			auxTree[pos]->setFather(father);
-
-			//set ptr
-			size_t left = auxTree[pos]->getLeft();
-			size_t right = auxTree[pos]->getRight(); 
-			if(left==0) //there is no left son
-				auxTree[pos]->setPtr(right);
-			else if(right==0) //there is no right son
-				auxTree[pos]->setPtr(left);
-			else //there are both sons
-			{
-				if(left<right)
-					auxTree[pos]->setPtr(left);
-				else
-					auxTree[pos]->setPtr(right);
-			}
-			
-			
-			if((mask & symbol) != 0) //is a right child
-			{
-				auxTree[father]->setRightson(pos); //point the father to the node
-				//set right
-				size_t right = P->selectInLevel( symbol, auxTree[pos]->getPtr(), i+1 );
-				auxTree[father]->setRight(right);
-				
-				if(j<levels[i]-1) //if it is not the last node of the level
-				{
-					father++;
-					auxTree[father]= new RankedPrefixNode(); //create an empty node for the next father 
-				}
+			for(uint i=1; i<=bucketsize; i++) //for each element of the bucket
+			{
+				ids[*numLocated] = (size_t)actBucket*bucketsize + i;
+				*numLocated=*numLocated+1;
 			}
-			else //is a left child
+		}
+
+		//last bucket
+		for(uint i=1; i<=bucketsize; i++)
+		{
+			size_t actPos = (size_t)bucketsize*last + i;
+			uint comp = rp->extractPrefixAndCompareDAC(actPos, str, strLen);
+			if(comp==0) //found an element with the prefix, so store its ID
 			{
-				auxTree[father]->setLeftson(pos);
-				//set left
-				size_t left = P->selectInLevel( symbol, auxTree[pos]->getPtr(), i+1 );
-				auxTree[father]->setLeft(left);
+				ids[*numLocated] = actPos;
+				*numLocated=*numLocated+1;
 			}
-			
-			symbol+= mask;
-			pos++;
 		}
-	}
 		
-	/*set ptr in pivot node*/
-	size_t left = auxTree[pos]->getLeft();
-	size_t right = auxTree[pos]->getRight(); 
-	if(left==0) //there is no left son
-		auxTree[pos]->setPtr(right);
-	else if(right==0) //there is no right son
-		auxTree[pos]->setPtr(left);
-	else //there are both sons
-	{
-		if(left<=right)
-			auxTree[pos]->setPtr(left);
-		else
-			auxTree[pos]->setPtr(right);
 	}
-	delete [] levels;
-	return auxTree;	
+	
+	/*Create a non contiguous ID iterator*/
+	IteratorRankedDictID* it = new IteratorRankedDictIDNoContiguous(ids, *numLocated);
+	
+    return it;
 }
 
 
 
 
-uint RankedStringDictionaryRPDAC::nextMidBucket(uint first, uint last, RankedPrefixNode ** auxTree, uint *inPos, uint numNodes)
+
+void RankedStringDictionaryRPDAC::createAuxiliarTree(uint first, uint last, RankedPrefixHeap *heap, size_t minId)
 {
 	first++; //in the tree buckets starts from 1
-	last++;	//in the tree buckets starts from 1
+	last++; //in the tree buckets starts from 1
+	heap->reset(first, last);
 	
-	//obtain the common bit prefix of first and last buckets
-	uint auxFirst=first;
-	uint auxLast=last;
-	while(auxFirst!=auxLast) //Find the not common bits
+	if(minId==0)
 	{
-		auxFirst >>= 1;
-		auxLast >>= 1;
+		/*only the nodes partially covered by the range (at most two per level) are initialized, the rest start with their first element when they are reached*/
+		for(uint level=1; level<=heap->differentBits; level++)
+		{
+			uint firstLabel = first>>level, lastLabel = last>>level;
+			if(!heap->covered(level, firstLabel))
+				initHeapNode(heap, level, firstLabel);
+			if(lastLabel!=firstLabel && !heap->covered(level, lastLabel))
+				initHeapNode(heap, level, lastLabel);
+		}
 	}
-	uint bucket=auxFirst;
-	uint bucketPos = numNodes; //initialize the bucket to the pivot node
-	bool ended=false;
-	while(!ended)
+	else
 	{
-		if(auxTree[bucketPos]->getLeft()==0 && auxTree[bucketPos]->getRight()==0) //if it has no sons is a leaf and we have ended
-			if(auxTree[bucketPos]->getLeftSon()==-1 && auxTree[bucketPos]->getRightSon()==-1) //is a leaf
-				ended=true;
-			else //it is not a leaf, so does not exist more elements
-				return 0;
-		else //is an internal node
+		/*the leaves start after the IDs up to minId, so every node is initialized*/
+		for(uint label=first; label<=last; label++)
 		{
-			bucket<<=1;
-			if(auxTree[bucketPos]->getLeft()==0) //it has no left son
-			{
-				bucketPos=auxTree[bucketPos]->getRightSon();
-				bucket++;
-			}
-			else if(auxTree[bucketPos]->getRight()==0) //it has no right son
-			{
-				bucketPos=auxTree[bucketPos]->getLeftSon();
-			}
-			else //it has both sons
-			{
-				if(auxTree[bucketPos]->getLeft() > auxTree[bucketPos]->getRight())
-				{
-					bucketPos=auxTree[bucketPos]->getRightSon();
-					bucket++;
-				}
-				else
-				{
-					bucketPos=auxTree[bucketPos]->getLeftSon();
-				}
-			}
+			uint pos = heap->node(0, label);
+			heap->ptr[pos] = P->rank(label, minId-1)+1;
+			if(heap->ptr[pos]>bucketsize) heap->ptr[pos]=0;
+			heap->touch(pos);
 		}
+		for(uint level=1; level<=heap->differentBits; level++)
+			for(uint label=first>>level; label<=(last>>level); label++)
+				initHeapNode(heap, level, label);
+	}
+}
+
+
+
+void RankedStringDictionaryRPDAC::initHeapNode(RankedPrefixHeap *heap, uint level, uint label)
+{
+	uint pos = heap->node(level, label);
+	if(level==0) //a leaf starts with the first element of its bucket
+		heap->ptr[pos] = 1;
+	else
+	{
+		heap->left[pos] = heapSonCandidate(heap, level-1, label<<1);
+		heap->right[pos] = heapSonCandidate(heap, level-1, (label<<1)+1);
+		size_t left = heap->left[pos], right = heap->right[pos];
+		heap->ptr[pos] = (left==0 || (right!=0 && right<left)) ? right : left;
 	}
+	heap->touch(pos);
+}
+
+
 
-	//get the inner position inside the bucket
-	*inPos=auxTree[bucketPos]->getPtr();
+size_t RankedStringDictionaryRPDAC::heapSonCandidate(RankedPrefixHeap *heap, uint level, uint label)
+{
+	if(!heap->exists(level, label))
+		return 0;
+	
+	//a fresh node has not been reached yet, so its candidate is its first element
+	uint pos = heap->node(level, label);
+	size_t ptr = heap->isFresh(pos) ? 1 : heap->ptr[pos];
+	if(ptr==0)
+		return 0;
+	return P->selectInLevel(heap->symbol(level, label), ptr, level+1);
+}
+
+
+
+uint RankedStringDictionaryRPDAC::nextMidBucket(RankedPrefixHeap *heap, uint *inPos)
+{
+	//descend from the pivot choosing the son with the lowest candidate
+	uint level = heap->differentBits;
+	uint bucket = heap->first>>level;
+	uint pos = heap->node(level, bucket);
+	if(heap->isFresh(pos)) initHeapNode(heap, level, bucket);
+	if(heap->ptr[pos]==0) //there are no more elements
+		return 0;
 	
-	//update the node ptr
+	while(level>0)
+	{
+		size_t left = heap->left[pos], right = heap->right[pos];
+		bucket <<= 1;
+		if(left==0 || (right!=0 && right<left))
+			bucket++;
+		level--;
+		
+		pos = heap->node(level, bucket);
+		if(heap->isFresh(pos)) initHeapNode(heap, level, bucket);
+	}
+
+	//get the inner position inside the bucket and update the leaf
+	*inPos = heap->ptr[pos];
 	if(*inPos<bucketsize)
-		auxTree[bucketPos]->setPtr(*inPos+1);
+		heap->ptr[pos] = *inPos+1;
 	else
-		auxTree[bucketPos]->setPtr(0);
+		heap->ptr[pos] = 0;
 	
-	/*update the tree*/
-	uint mask=1;
-	int father;
-	uint level=1;
-	while(bucketPos < numNodes)
+	/*update the candidates of the fathers*/
+	for(level=0; level<heap->differentBits; level++)
 	{
-		uint ptr = auxTree[bucketPos]->getPtr();
-		father = auxTree[bucketPos]->getFather();
-		if( (mask & bucket) != 0) //is a right son
-		{
-			uint right = P->selectInLevel(bucket, ptr, level );
-			auxTree[father]->setRight(right);
-			
-			//update father ptr
-			uint left = auxTree[father]->getLeft();
-			if(left==0) //father has no left son
-				auxTree[father]->setPtr(right);
-			else //father has left son
-			{
-				if(left<=right)
-					auxTree[father]->setPtr(left);
-				else
-					auxTree[father]->setPtr(right);
-			}
-		}
+		uint label = bucket>>level;
+		size_t ptr = heap->ptr[heap->node(level, label)];
+		size_t candidate = (ptr!=0) ? P->selectInLevel(bucket, ptr, level+1) : 0;
+		
+		uint father = heap->node(level+1, label>>1);
+		if((label & 1) != 0) //is a right son
+			heap->right[father] = candidate;
 		else //is a left son
-		{
-			uint left = P->selectInLevel(bucket, ptr, level );
-			auxTree[father]->setLeft(left);
-			
-			//update father ptr
-			uint right = auxTree[father]->getRight();
-			if(right==0) //father has no right son
-				auxTree[father]->setPtr(left);
-			else //father has right son
-			{
-				if(right<left)
-					auxTree[father]->setPtr(right);
-				else
-					auxTree[father]->setPtr(left);
-			}
-		}
+			heap->left[father] = candidate;
 		
-		bucketPos=father;
-		mask <<= 1;
-		level++;
+		size_t left = heap->left[father], right = heap->right[father];
+		heap->ptr[father] = (left==0 || (right!=0 && right<left)) ? right : left;
 	}
-
 	
 	return bucket;
 }
 
 
 
-uint RankedStringDictionaryRPDAC::nextIdFirstLastBucket(uchar *str, uint strLen, uint bucket, uint *startPoint)
+size_t RankedStringDictionaryRPDAC::nextIdFirstLastBucket(uchar *str, uint strLen, uint bucket, uint *startPoint)
 {
-	uint id=elements+1;
+	size_t id=elements+1;
 	bool found=false;
 	while(*startPoint<bucketsize && !found)
 	{
-		uint pos = bucket*bucketsize+*startPoint+1;
+		size_t pos = (size_t)bucket*bucketsize+*startPoint+1;
 		uint comp = rp->extractPrefixAndCompareDAC(pos, str, strLen);
 		if(comp==0) //found element with the prefix
 		{
@@ -1001,19 +1395,30 @@ uint RankedStringDictionaryRPDAC::nextIdFirstLastBucket(uchar *str, uint strLen,
 
 
 
-size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint n, size_t *numLocated)
+bool RankedStringDictionaryRPDAC::prefixBuckets(uchar *str, uint strLen, RankedPrefixSession *session, uint *first, uint *last)
 {
-	/*FIND FIRST AND LAST BUCKET*/
 	//find any bucket containing the prefix (using binary search)
 	//initialize the limits of the actual part of the search
 	uint left = 0;
 	uint right = numBuckets-1;
-	uint center = floor(numBuckets/2);
+	if(session!=NULL && session->extends(str, strLen)) //the strings with this prefix are in the range of the previous one
+	{
+		if(session->isEmpty())
+			return false;
+		left = session->getFirst();
+		right = session->getLast();
+	}
+	uint center;
 	bool found = false;
+	if(sample!=NULL && sampleBuckets(str, strLen, true, &left, &right, &center)) //the header of a sampled bucket matches the prefix
+		found = true;
+	else
+		center = left + floor((right-left+1)/2);
+	uint rangeLeft = left, rangeRight = right;
 	//start the binary search
 	while(!found && left!=right)
 	{
-		uint headerPosition = bucketsize*center + H->getField(center); //(bucketsize*center-1) gets the element inmidiatly before the center bucket
+		size_t headerPosition = (size_t)bucketsize*center + H->getField(center); //(bucketsize*center-1) gets the element inmidiatly before the center bucket
 		int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
 
 		if(compare > 0) //the searched prefix is to the left
@@ -1032,14 +1437,72 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 		}
 
 	}
-	size_t** ids; //array for storing the position in the RPDAC (first row) and the id (second row)
-	*numLocated = 0; //number of strings located with the prefix
+	
 	if(!found) //first and last bucket are the same
 	{
+		*first = center;
+		*last = center;
+		return true;
+	}
+	
+	/*starting from the found bucket search (binary search) left and right for the first and last bucket*/
+	//search the first bucket
+	uint L = rangeLeft;
+	uint R = (center>rangeLeft) ? center-1 : rangeLeft;
+	uint C = floor((R-L+1)/2)+L;
+	while(L<R)
+	{
+		size_t headerPosition = (size_t)bucketsize*C + H->getField(C);
+		int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
+		if(compare == 0) //the first bucket is to the left
+			R=C-1;
+		else //the first bucket is to the right
+		{
+			L=C;
+		}
+		C=floor((R-L+1)/2)+L;
+	}
+	*first = C;
+	
+	//search the last bucket
+	L=center;
+	R=rangeRight;
+	C=floor((R-L+1)/2)+L;
+	while(L<R)
+	{
+		size_t headerPosition = (size_t)bucketsize*C + H->getField(C);
+		int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
+		if(compare == 0) //the last bucket is to the right (or in the actual)
+			L=C;
+		else //the last bucket is to the left
+			R=C-1;
+			
+		C=floor((R-L+1)/2)+L;
+	}
+	*last = C;
+	
+	return true;
+}
+
+
+
+
+size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint n, size_t *numLocated, RankedPrefixSession *session, RankedQueryContext *context)
+{
+	/*FIND FIRST AND LAST BUCKET*/
+	uint first, last;
+	*numLocated = 0; //number of strings located with the prefix
+	if(rp==NULL || !prefixBuckets(str, strLen, session, &first, &last)) //the session knows that there are no strings with the prefix
+		return NULL;
+	
+	size_t** ids; //array for storing the position in the RPDAC (first row) and the id (second row)
+	if(first==last) //first and last bucket are the same
+	{
+		uint center = first;
 		uint arrSize=min(bucketsize,n);
-		ids = new size_t*[2];
-		ids[0] = new size_t[arrSize];
-		ids[1] = new size_t[arrSize];
+		ids = RankedQueryContext::alloc<size_t*>(context, 2);
+		ids[0] = RankedQueryContext::alloc<size_t>(context, arrSize);
+		ids[1] = RankedQueryContext::alloc<size_t>(context, arrSize);
 		
 		for(uint i=0;i<arrSize;i++) 
 		{
@@ -1055,7 +1518,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 		uint i=1;
 		while(*numLocated<n && i<=actBucketSize)
 		{
-			uint actPos = bucketsize*center + i;
+			size_t actPos = (size_t)bucketsize*center + i;
 			uint comp = rp->extractPrefixAndCompareDAC(actPos, str, strLen);
 			if(comp==0) //found an element with the prefix, so store its ID
 			{
@@ -1066,86 +1529,56 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 			i++;
 		}
 
+		if(session!=NULL)
+			session->update(str, strLen, center, center, *numLocated==0 && n>0);
+		
 		if(*numLocated==0) //no string found
+		{
+			deleteTopK(ids, context);
 			return NULL;
+		}
 	}
 	else//first and last buckets are different
 	{
-		/*starting from the found bucket search (binary search) left and right for the first and last bucket*/
-		uint first = 0;
-		uint last = numBuckets-1;
-		
-		ids = new size_t*[2];
-		ids[0] = new size_t[n];
-		ids[1] = new size_t[n];
+		ids = RankedQueryContext::alloc<size_t*>(context, 2);
+		ids[0] = RankedQueryContext::alloc<size_t>(context, n);
+		ids[1] = RankedQueryContext::alloc<size_t>(context, n);
 		
 		for(uint i=0;i<n;i++) 
 		{
 			ids[0][i]=0;
 			ids[1][i]=0;
 		}		
-
-		//search the first bucket
-		uint L = 0;
-		uint R = center-1;
-		uint C = floor((R-L+1)/2);
-		while(L<R)
-		{
-			uint headerPosition = bucketsize*C + H->getField(C);
-			int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
-			if(compare == 0) //the first bucket is to the left
-				R=C-1;
-			else //the first bucket is to the right
-			{
-				L=C;
-			}
-			C=floor((R-L+1)/2)+L;
-		}
-		first = C;
 		
-		//search the last bucket
-		L=center;
-		R=numBuckets;
-		C=floor((R-L+1)/2)+L;
-		while(L<R)
-		{
-			uint headerPosition = bucketsize*C + H->getField(C);
-			int compare = rp->extractPrefixAndCompareDAC(headerPosition, str, strLen);
-			if(compare == 0) //the last bucket is to the right (or in the actual)
-				L=C;
-			else //the last bucket is to the left
-				R=C-1;
-				
-			C=floor((R-L+1)/2)+L;
-		}
-		last = C;
+		if(session!=NULL)
+			session->update(str, strLen, first, last, false);
 
 		/*HAVING FIRST AND LAST BUCKET COMPARE THE FIRST OF FIRST BUCKET, LAST BUCKET AND MIDDLE BUCKETS*/
 
-		uint firstBucketId, lastBucketId;
+		size_t firstBucketId, lastBucketId;
 		if(first+2<last) /*there are more than one mid bucket*/
 		{
-			uint x;
-			uint numNodes;
-			RankedPrefixNode ** auxTree = createAuxiliarTree(first+1,last-1, &x, &numNodes);
+			RankedPrefixHeap localHeap; //the heap of the context is reused between queries
+			RankedPrefixHeap *auxTree = (context!=NULL) ? context->getHeap() : &localHeap;
+			createAuxiliarTree(first+1,last-1, auxTree);
 			
-			lowestIdBucket * bucketsAndIds = new lowestIdBucket[3];
+			lowestIdBucket bucketsAndIds[3];
 						
 			*numLocated=0;
 			bool existElements=true;
 			bucketsAndIds[0].startPoint=0;
 			bucketsAndIds[0].id = nextIdFirstLastBucket(str, strLen, first, &bucketsAndIds[0].startPoint);
 			bucketsAndIds[0].bucket=first;
-			bucketsAndIds[0].position = first*bucketsize+bucketsAndIds[0].startPoint-1;
+			bucketsAndIds[0].position = (size_t)first*bucketsize+bucketsAndIds[0].startPoint-1;
 			bucketsAndIds[1].startPoint=0;
 			bucketsAndIds[1].id = nextIdFirstLastBucket(str, strLen, last, &bucketsAndIds[1].startPoint);
 			bucketsAndIds[1].bucket=last;
-			bucketsAndIds[1].position = last*bucketsize+bucketsAndIds[1].startPoint-1;
+			bucketsAndIds[1].position = (size_t)last*bucketsize+bucketsAndIds[1].startPoint-1;
 			bucketsAndIds[2].startPoint=0;
-			uint midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[2].startPoint, numNodes);
+			uint midBucket = nextMidBucket(auxTree, &bucketsAndIds[2].startPoint);
 			bucketsAndIds[2].id = P->select(midBucket,bucketsAndIds[2].startPoint)+1;
 			bucketsAndIds[2].bucket=numBuckets+1;
-			bucketsAndIds[2].position = (midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
+			bucketsAndIds[2].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
 			
 				
 			reorderLowestIdBucket(bucketsAndIds);
@@ -1162,11 +1595,11 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 					ids[1][*numLocated] = bucketsAndIds[0].id;
 					if(bucketsAndIds[0].bucket==numBuckets+1)//the ID is from the middle buckets
 					{
-						midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[0].startPoint, numNodes);
+						midBucket = nextMidBucket(auxTree, &bucketsAndIds[0].startPoint);
 						if(midBucket>0)
 						{
 							bucketsAndIds[0].id = P->select(midBucket,bucketsAndIds[0].startPoint)+1;
-							bucketsAndIds[0].position = (midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
+							bucketsAndIds[0].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
 						}
 						else
 							bucketsAndIds[0].id = elements+1;
@@ -1174,7 +1607,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 					else//the ID is from the first or last bucket
 					{
 						bucketsAndIds[0].id = nextIdFirstLastBucket(str, strLen, bucketsAndIds[0].bucket, &bucketsAndIds[0].startPoint);
-						bucketsAndIds[0].position = bucketsAndIds[0].bucket*bucketsize+bucketsAndIds[0].startPoint-1;
+						bucketsAndIds[0].position = (size_t)bucketsAndIds[0].bucket*bucketsize+bucketsAndIds[0].startPoint-1;
 					}
 					*numLocated+=1;
 					
@@ -1184,11 +1617,11 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 						ids[1][*numLocated] = bucketsAndIds[1].id;
 						if(bucketsAndIds[1].bucket==numBuckets+1)//the ID is from the middle buckets
 						{
-							midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[1].startPoint, numNodes);
+							midBucket = nextMidBucket(auxTree, &bucketsAndIds[1].startPoint);
 							if(midBucket>0)
 							{
 								bucketsAndIds[1].id = P->select(midBucket,bucketsAndIds[1].startPoint)+1;
-								bucketsAndIds[1].position = (midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
+								bucketsAndIds[1].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
 							}
 							else
 								bucketsAndIds[1].id = elements+1;
@@ -1196,17 +1629,13 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 						else//the ID is from the first or last bucket
 						{
 							bucketsAndIds[1].id = nextIdFirstLastBucket(str, strLen, bucketsAndIds[1].bucket, &bucketsAndIds[1].startPoint);
-							bucketsAndIds[1].position = bucketsAndIds[1].bucket*bucketsize+bucketsAndIds[1].startPoint-1;
+							bucketsAndIds[1].position = (size_t)bucketsAndIds[1].bucket*bucketsize+bucketsAndIds[1].startPoint-1;
 						}
 						*numLocated+=1;
 						reorderLowestIdBucket(bucketsAndIds);
 					}
 				}
 			}
-			for(uint i=0; i<=numNodes;i++)
-				delete auxTree[i];
-			delete [] auxTree;
-			delete [] bucketsAndIds;
 		}
 		
 		else if(first+1==last) /*there are no mid buckets*/
@@ -1227,13 +1656,13 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 				{
 					if(firstBucketId<=lastBucketId)
 					{
-						ids[0][*numLocated]=first*bucketsize+startPointFirst-1;
+						ids[0][*numLocated]=(size_t)first*bucketsize+startPointFirst-1;
 						ids[1][*numLocated]=firstBucketId;
 						firstBucketId = nextIdFirstLastBucket(str, strLen, first, &startPointFirst);
 					}
 					else
 					{
-						ids[0][*numLocated]=last*bucketsize+startPointLast-1;
+						ids[0][*numLocated]=(size_t)last*bucketsize+startPointLast-1;
 						ids[1][*numLocated]=lastBucketId;
 						lastBucketId = nextIdFirstLastBucket(str, strLen, first, &startPointLast);
 					}
@@ -1245,7 +1674,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 		else /*there is only one mid bucket*/
 		{
 			
-			lowestIdBucket * bucketsAndIds = new lowestIdBucket[3];
+			lowestIdBucket bucketsAndIds[3];
 			
 			uint midBucket = first+1;
 			
@@ -1254,15 +1683,15 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 			bucketsAndIds[0].startPoint=0;
 			bucketsAndIds[0].id = nextIdFirstLastBucket(str, strLen, first, &bucketsAndIds[0].startPoint);
 			bucketsAndIds[0].bucket=first;
-			bucketsAndIds[0].position = first*bucketsize+bucketsAndIds[0].startPoint-1;
+			bucketsAndIds[0].position = (size_t)first*bucketsize+bucketsAndIds[0].startPoint-1;
 			bucketsAndIds[1].startPoint=0;
 			bucketsAndIds[1].id = nextIdFirstLastBucket(str, strLen, last, &bucketsAndIds[1].startPoint);
 			bucketsAndIds[1].bucket=last;
-			bucketsAndIds[1].position = last*bucketsize+bucketsAndIds[1].startPoint-1;
+			bucketsAndIds[1].position = (size_t)last*bucketsize+bucketsAndIds[1].startPoint-1;
 			bucketsAndIds[2].startPoint=1;
 			bucketsAndIds[2].id = P->select(midBucket+1,bucketsAndIds[2].startPoint)+1;
 			bucketsAndIds[2].bucket=numBuckets+1;
-			bucketsAndIds[2].position = (midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
+			bucketsAndIds[2].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
 			
 			reorderLowestIdBucket(bucketsAndIds);
 			
@@ -1281,7 +1710,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 						if(bucketsAndIds[0].startPoint<=bucketsize)
 						{
 							bucketsAndIds[0].id = P->select(midBucket+1,bucketsAndIds[0].startPoint)+1;
-							bucketsAndIds[0].position = (midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
+							bucketsAndIds[0].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
 						}
 						else
 							bucketsAndIds[0].id = elements+1;
@@ -1289,7 +1718,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 					else//the ID is from the first or last bucket
 					{
 						bucketsAndIds[0].id = nextIdFirstLastBucket(str, strLen, bucketsAndIds[0].bucket, &bucketsAndIds[0].startPoint);
-						bucketsAndIds[0].position = bucketsAndIds[0].bucket*bucketsize+bucketsAndIds[0].startPoint-1;
+						bucketsAndIds[0].position = (size_t)bucketsAndIds[0].bucket*bucketsize+bucketsAndIds[0].startPoint-1;
 					}
 					*numLocated+=1;
 					
@@ -1302,7 +1731,7 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 							if(bucketsAndIds[0].startPoint<=bucketsize)
 							{
 								bucketsAndIds[1].id = P->select(midBucket+1,bucketsAndIds[1].startPoint)+1;
-								bucketsAndIds[1].position = (midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
+								bucketsAndIds[1].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
 							}
 							else
 								bucketsAndIds[1].id = elements+1;
@@ -1310,14 +1739,13 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 						else//the ID is from the first or last bucket
 						{
 							bucketsAndIds[1].id = nextIdFirstLastBucket(str, strLen, bucketsAndIds[1].bucket, &bucketsAndIds[1].startPoint);
-							bucketsAndIds[1].position = bucketsAndIds[1].bucket*bucketsize+bucketsAndIds[1].startPoint-1;
+							bucketsAndIds[1].position = (size_t)bucketsAndIds[1].bucket*bucketsize+bucketsAndIds[1].startPoint-1;
 						}
 						*numLocated+=1;
 						reorderLowestIdBucket(bucketsAndIds);
 					}
 				}
 			}
-			delete [] bucketsAndIds;
 		}
 
 		
@@ -1328,14 +1756,14 @@ size_t ** RankedStringDictionaryRPDAC::topKprefix(uchar *str, uint strLen, uint
 
 
 
-size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, uint k)
+size_t ** RankedStringDictionaryRPDAC::topKInterval(size_t beginning, size_t len, uint k, RankedQueryContext *context)
 {
 	if(len<k) //if len<k we can only return len elements -> k=len
 		k=len;
 	
-	size_t** ids = new size_t*[2];; //array for storing the position in the RPDAC (first row) and the id (second row)
-	ids[0] = new size_t[k];
-	ids[1] = new size_t[k];
+	size_t** ids = RankedQueryContext::alloc<size_t*>(context, 2); //array for storing the position in the RPDAC (first row) and the id (second row)
+	ids[0] = RankedQueryContext::alloc<size_t>(context, k);
+	ids[1] = RankedQueryContext::alloc<size_t>(context, k);
 //	for(uint i=0;i<k;i++) 
 //	{
 //		ids[0][i]=0;
@@ -1351,20 +1779,21 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 		for(uint i=0; i<k; i++)
 		{
 			ids[0][i]=beginning+i;
+			ids[1][i]=0; //the ids are not needed for extracting the positions
 		}
 	}
 	else//first and last buckets are different
 	{
 		/*COMPARE THE FIRST RANKED ELEMENT OF FIRST BUCKET, LAST BUCKET AND MIDDLE BUCKETS*/
 
-		uint firstBucketId, lastBucketId;
+		size_t firstBucketId, lastBucketId;
 		if(first+2<last) /*there are more than one mid bucket*/
 		{
-			uint x;
-			uint numNodes;
-			RankedPrefixNode ** auxTree = createAuxiliarTree(first+1,last-1, &x, &numNodes);
+			RankedPrefixHeap localHeap; //the heap of the context is reused between queries
+			RankedPrefixHeap *auxTree = (context!=NULL) ? context->getHeap() : &localHeap;
+			createAuxiliarTree(first+1,last-1, auxTree);
 			
-			lowestIdBucket * bucketsAndIds = new lowestIdBucket[3];
+			lowestIdBucket bucketsAndIds[3];
 			
 			uint lastBucketEnd = (beginning+len-2)%bucketsize+1;
 			
@@ -1378,13 +1807,13 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 			bucketsAndIds[1].startPoint=1;
 			bucketsAndIds[1].id = P->select(last+1, bucketsAndIds[1].startPoint)+1;
 			bucketsAndIds[1].bucket=last+1;
-			bucketsAndIds[1].position = last*bucketsize+1;
+			bucketsAndIds[1].position = (size_t)last*bucketsize+1;
 			
 			bucketsAndIds[2].startPoint=0;
-			uint midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[2].startPoint, numNodes);
+			uint midBucket = nextMidBucket(auxTree, &bucketsAndIds[2].startPoint);
 			bucketsAndIds[2].id = P->select(midBucket,bucketsAndIds[2].startPoint)+1;
 			bucketsAndIds[2].bucket=numBuckets+1;
-			bucketsAndIds[2].position = (midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
+			bucketsAndIds[2].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[2].startPoint;
 			
 				
 			reorderLowestIdBucket(bucketsAndIds);
@@ -1397,11 +1826,11 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 				
 				if(bucketsAndIds[0].bucket==numBuckets+1)//the ID is from the middle buckets
 				{
-					midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[0].startPoint, numNodes);
+					midBucket = nextMidBucket(auxTree, &bucketsAndIds[0].startPoint);
 					if(midBucket>0)
 					{
 						bucketsAndIds[0].id = P->select(midBucket,bucketsAndIds[0].startPoint)+1;
-						bucketsAndIds[0].position = (midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
+						bucketsAndIds[0].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[0].startPoint;
 					}
 					else
 						bucketsAndIds[0].id = elements+1;
@@ -1416,14 +1845,14 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 						{
 							bucketsAndIds[0].startPoint++;
 							bucketsAndIds[0].id = P->select(bucketsAndIds[0].bucket,bucketsAndIds[0].startPoint)+1;
-							bucketsAndIds[0].position = (bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
+							bucketsAndIds[0].position = (size_t)(bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
 						}
 					}
 					else if(bucketsAndIds[0].startPoint<bucketsize) //first bucket
 					{
 						bucketsAndIds[0].startPoint++;
 						bucketsAndIds[0].id = P->select(bucketsAndIds[0].bucket,bucketsAndIds[0].startPoint)+1;
-						bucketsAndIds[0].position = (bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
+						bucketsAndIds[0].position = (size_t)(bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
 					}
 					else
 						bucketsAndIds[0].id = elements+1;
@@ -1436,11 +1865,11 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 					ids[1][numLocated] = bucketsAndIds[1].id;
 					if(bucketsAndIds[1].bucket==numBuckets+1)//the ID is from the middle buckets
 					{
-						midBucket = nextMidBucket(first+1,last-1, auxTree, &bucketsAndIds[1].startPoint, numNodes);
+						midBucket = nextMidBucket(auxTree, &bucketsAndIds[1].startPoint);
 						if(midBucket>0)
 						{
 							bucketsAndIds[1].id = P->select(midBucket,bucketsAndIds[1].startPoint)+1;
-							bucketsAndIds[1].position = (midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
+							bucketsAndIds[1].position = (size_t)(midBucket-1)*bucketsize+bucketsAndIds[1].startPoint;
 						}
 						else
 							bucketsAndIds[1].id = elements+1;
@@ -1455,14 +1884,14 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 							{
 								bucketsAndIds[1].startPoint++;
 								bucketsAndIds[1].id = P->select(bucketsAndIds[1].bucket,bucketsAndIds[1].startPoint)+1;
-								bucketsAndIds[1].position = (bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
+								bucketsAndIds[1].position = (size_t)(bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
 							}
 						}
 						else if(bucketsAndIds[1].startPoint<bucketsize) //first bucket
 						{
 							bucketsAndIds[1].startPoint++;
 							bucketsAndIds[1].id = P->select(bucketsAndIds[1].bucket,bucketsAndIds[1].startPoint)+1;
-							bucketsAndIds[1].position = (bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
+							bucketsAndIds[1].position = (size_t)(bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
 						}
 						else
 							bucketsAndIds[1].id = elements+1;
@@ -1472,10 +1901,6 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 				}
 
 			}
-			for(uint i=0; i<=numNodes;i++)
-				delete auxTree[i];
-			delete [] auxTree;
-			delete [] bucketsAndIds;
 		}
 		
 		else if(first+1==last) /*there are no mid buckets*/
@@ -1492,7 +1917,7 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 			{
 				if(firstBucketId<=lastBucketId) //recover element from first bucket
 				{
-					ids[0][i]=first*bucketsize+startPointFirst-1;
+					ids[0][i]=(size_t)first*bucketsize+startPointFirst-1;
 					ids[1][i]=firstBucketId;
 					startPointFirst++;
 					if(startPointFirst<=bucketsize)
@@ -1502,7 +1927,7 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 				}
 				else  //recover element from last bucket
 				{
-					ids[0][i]=last*bucketsize+startPointLast;
+					ids[0][i]=(size_t)last*bucketsize+startPointLast;
 					ids[1][i]=lastBucketId;
 					startPointLast++;
 					if(startPointLast<lastBucketEnd)
@@ -1516,7 +1941,7 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 		else /*there is only one mid bucket*/
 		{
 			uint lastBucketEnd = (beginning+len-2)%bucketsize+1;
-			lowestIdBucket * bucketsAndIds = new lowestIdBucket[3];
+			lowestIdBucket bucketsAndIds[3];
 			uint midBucket = first+1;
 			
 			uint numLocated=0;
@@ -1528,12 +1953,12 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 			bucketsAndIds[1].startPoint=1;
 			bucketsAndIds[1].id = P->select(last+1, bucketsAndIds[1].startPoint)+1;
 			bucketsAndIds[1].bucket=last+1;
-			bucketsAndIds[1].position = last*bucketsize+1;
+			bucketsAndIds[1].position = (size_t)last*bucketsize+1;
 			
 			bucketsAndIds[2].startPoint=1;
 			bucketsAndIds[2].id = P->select(midBucket+1,bucketsAndIds[2].startPoint)+1;
 			bucketsAndIds[2].bucket = midBucket+1;
-			bucketsAndIds[2].position = midBucket*bucketsize+bucketsAndIds[2].startPoint;
+			bucketsAndIds[2].position = (size_t)midBucket*bucketsize+bucketsAndIds[2].startPoint;
 			
 			reorderLowestIdBucket(bucketsAndIds);
 			
@@ -1551,7 +1976,7 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 				{
 					bucketsAndIds[0].startPoint++;
 					bucketsAndIds[0].id = P->select(bucketsAndIds[0].bucket,bucketsAndIds[0].startPoint)+1;
-					bucketsAndIds[0].position = (bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
+					bucketsAndIds[0].position = (size_t)(bucketsAndIds[0].bucket-1)*bucketsize + bucketsAndIds[0].startPoint;
 				}
 				else
 					bucketsAndIds[0].id = elements+1;
@@ -1570,7 +1995,7 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 					{
 						bucketsAndIds[1].startPoint++;
 						bucketsAndIds[1].id = P->select(bucketsAndIds[1].bucket,bucketsAndIds[1].startPoint)+1;
-						bucketsAndIds[1].position = (bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
+						bucketsAndIds[1].position = (size_t)(bucketsAndIds[1].bucket-1)*bucketsize + bucketsAndIds[1].startPoint;
 					}
 					else
 						bucketsAndIds[1].id = elements+1;
@@ -1579,7 +2004,6 @@ size_t ** RankedStringDictionaryRPDAC::topKInterval(uint beginning, uint len, ui
 					reorderLowestIdBucket(bucketsAndIds);
 				}
 			}
-			delete [] bucketsAndIds;
 		}
 
 		
@@ -1625,10 +2049,266 @@ void RankedStringDictionaryRPDAC::reorderLowestIdBucket(lowestIdBucket* array)
 
 
 
+void RankedStringDictionaryRPDAC::sortItems(vector<dictItem> *items, uint threads)
+{
+	size_t n = items->size();
+	if(threads<=1 || n<2*threads)
+	{
+		sort(items->begin(), items->end(), sorting);
+		return;
+	}
+	
+	//split the list in one run per thread and sort every run independently
+	vector<size_t> limits;
+	for(uint t=0; t<=threads; t++)
+		limits.push_back((n*t)/threads);
+	
+	vector<thread> workers;
+	for(uint t=0; t<threads; t++)
+		workers.push_back(thread(sort<vector<dictItem>::iterator, bool(*)(dictItem,dictItem)>, items->begin()+limits[t], items->begin()+limits[t+1], sorting));
+	for(uint t=0; t<threads; t++)
+		workers[t].join();
+	
+	//merge the runs by pairs (the merges of each round are independent)
+	while(limits.size()>2)
+	{
+		vector<size_t> merged;
+		workers.clear();
+		uint r;
+		for(r=0; r+2<limits.size(); r+=2)
+		{
+			merged.push_back(limits[r]);
+			workers.push_back(thread(inplace_merge<vector<dictItem>::iterator, bool(*)(dictItem,dictItem)>, items->begin()+limits[r], items->begin()+limits[r+1], items->begin()+limits[r+2], sorting));
+		}
+		if(r+1<limits.size()) //odd number of runs, the last one is merged in the next round
+			merged.push_back(limits[r]);
+		merged.push_back(n);
+		
+		for(uint t=0; t<workers.size(); t++)
+			workers[t].join();
+		limits = merged;
+	}
+}
+
+
+
+void RankedStringDictionaryRPDAC::reorderBuckets(vector<dictItem> *items, uint bucketsize, uint firstBucket, uint lastBucket, size_t *finalOrder, size_t *headers)
+{
+	vector< pair<size_t,size_t> > bucket; //(ID, lexicographical position) of the strings in the bucket
+	bucket.reserve(bucketsize);
+	for(uint i=firstBucket; i<lastBucket; i++) //for each bucket
+	{
+		size_t begin = (size_t)i*bucketsize;
+		size_t end = min(begin+bucketsize, items->size());
+		
+		bucket.clear();
+		for(size_t j=begin; j<end; j++)
+			bucket.push_back(pair<size_t,size_t>((*items)[j].itemId, j));
+		
+		//the smallest ID will be first
+		sort(bucket.begin(), bucket.end());
+		
+		for(uint j=0; j<bucket.size(); j++)
+		{
+			finalOrder[begin+j] = bucket[j].second;
+			//if it is the first element (lexicographically) store the position in the header array
+			if(bucket[j].second==begin)
+				headers[i] = j+1;
+		}
+	}
+}
+
+
+
+void RankedStringDictionaryRPDAC::buildP(RankedStringDictionaryRPDAC *dict, uint *bucketNumber)
+{
+	dict->P = new WaveletTreeNoptrs(bucketNumber, dict->elements, new BitSequenceBuilder375(), new MapperNone());
+	//dict->P = new WaveletTreeNoptrs(bucketNumber, dict->elements, new BitSequenceBuilderRG(20), new MapperNone());
+}
+
+
+
+uint RankedStringDictionaryRPDAC::bucketElements(uint bucket)
+{
+	if(bucket==numBuckets-1) //the last bucket can be incomplete
+		return elements-(size_t)bucket*bucketsize;
+	return bucketsize;
+}
+
+
+
+bool RankedStringDictionaryRPDAC::validToken(RankedTopKToken *resume)
+{
+	if(resume->first>resume->last || resume->last>=numBuckets || resume->lastId>elements)
+	{
+		cerr << "[ERROR] The top k token [" << resume->first << ", " << resume->last << "] after ID " << resume->lastId << " does not belong to this dictionary" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+RankedTopKFrontier* RankedStringDictionaryRPDAC::prefixFrontier(uchar *str, uint strLen, RankedTopKToken *resume)
+{
+	if(resume!=NULL && !validToken(resume)) return NULL;
+	
+	RankedTopKFrontier *frontier = new RankedTopKFrontier();
+	frontier->prefix = new uchar[strLen+1];
+	memcpy(frontier->prefix, str, strLen);
+	frontier->prefix[strLen] = '\0';
+	frontier->prefixLen = strLen;
+	if(rp==NULL) return frontier; //the dictionary was left empty
+	
+	//the bucket range is kept in the token, so it is not searched again
+	size_t minId = 0;
+	if(resume!=NULL)
+	{
+		frontier->first = resume->first;
+		frontier->last = resume->last;
+		minId = resume->lastId;
+	}
+	else prefixBuckets(frontier->prefix, strLen, NULL, &frontier->first, &frontier->last);
+	frontier->minId = minId;
+	
+	uint first = frontier->first, last = frontier->last;
+	addSide(frontier, first, 0, bucketElements(first), true, minId);
+	if(first<last)
+	{
+		addSide(frontier, last, 0, bucketElements(last), true, minId);
+		addMiddle(frontier, first+1, last-1, minId);
+	}
+	
+	return frontier;
+}
+
+
+
+RankedTopKFrontier* RankedStringDictionaryRPDAC::intervalFrontier(size_t beginning, size_t len, RankedTopKToken *resume)
+{
+	if(resume!=NULL && !validToken(resume)) return NULL;
+	
+	RankedTopKFrontier *frontier = new RankedTopKFrontier();
+	size_t minId = (resume!=NULL) ? resume->lastId : 0;
+	frontier->minId = minId;
+	if(len==0 || rp==NULL) return frontier;
+	
+	//obtain the first and last buckets
+	uint first = (beginning-1)/bucketsize;
+	uint last = (beginning+len-2)/bucketsize;
+	uint firstBucketStart = (beginning-1)%bucketsize; //inner positions of the first bucket out of the interval
+	uint lastBucketEnd = (beginning+len-2)%bucketsize+1;
+	frontier->first = first;
+	frontier->last = last;
+	
+	//inside the interval the strings are not compared
+	if(first==last)
+		addSide(frontier, first, firstBucketStart, lastBucketEnd, false, minId);
+	else
+	{
+		addSide(frontier, first, firstBucketStart, bucketElements(first), false, minId);
+		addSide(frontier, last, 0, lastBucketEnd, false, minId);
+		addMiddle(frontier, first+1, last-1, minId);
+	}
+	
+	return frontier;
+}
+
+
+
+void RankedStringDictionaryRPDAC::addSide(RankedTopKFrontier *frontier, uint bucket, uint startPoint, uint end, bool check, size_t minId)
+{
+	RankedTopKSide *side = &frontier->sides[frontier->numSides];
+	frontier->numSides++;
+	
+	side->bucket = bucket;
+	side->end = end;
+	side->check = check;
+	side->startPoint = startPoint;
+	if(minId>0) //the strings are sorted by ID inside the bucket, so the IDs up to minId are the first ones
+	{
+		uint skipped = P->rank(bucket+1, minId-1);
+		if(skipped>startPoint) side->startPoint = skipped;
+	}
+	
+	advanceSide(frontier, side);
+}
+
+
+
+void RankedStringDictionaryRPDAC::addMiddle(RankedTopKFrontier *frontier, uint midFirst, uint midLast, size_t minId)
+{
+	if(midFirst>midLast) //there are no middle buckets
+		return;
+	
+	if(midFirst==midLast) //only one middle bucket (all its strings are in the range)
+	{
+		addSide(frontier, midFirst, 0, bucketsize, false, minId);
+		return;
+	}
+	
+	frontier->tree = new RankedPrefixHeap();
+	createAuxiliarTree(midFirst, midLast, frontier->tree, minId);
+	advanceTree(frontier);
+}
+
+
 
+void RankedStringDictionaryRPDAC::advanceSide(RankedTopKFrontier *frontier, RankedTopKSide *side)
+{
+	side->id = 0;
+	while(side->startPoint<side->end && side->id==0)
+	{
+		side->startPoint++;
+		size_t pos = (size_t)side->bucket*bucketsize+side->startPoint;
+		if(!side->check || rp->extractPrefixAndCompareDAC(pos, frontier->prefix, frontier->prefixLen)==0)
+		{
+			side->id = P->select(side->bucket+1, side->startPoint)+1;
+			side->position = pos;
+		}
+	}
+}
 
 
 
+void RankedStringDictionaryRPDAC::advanceTree(RankedTopKFrontier *frontier)
+{
+	uint inPos = 0;
+	uint midBucket = nextMidBucket(frontier->tree, &inPos);
+	if(midBucket>0)
+	{
+		frontier->treeId = P->select(midBucket, inPos)+1;
+		frontier->treePosition = (size_t)(midBucket-1)*bucketsize+inPos;
+	}
+	else
+		frontier->treeId = 0;
+}
 
 
 
+size_t RankedStringDictionaryRPDAC::nextTopK(RankedTopKFrontier *frontier, size_t *position)
+{
+	//the lowest ID between the middle buckets and the sides
+	size_t id = frontier->treeId;
+	*position = frontier->treePosition;
+	RankedTopKSide *lowest = NULL;
+	for(uint i=0; i<frontier->numSides; i++)
+	{
+		RankedTopKSide *side = &frontier->sides[i];
+		if(side->id!=0 && (id==0 || side->id<id))
+		{
+			id = side->id;
+			*position = side->position;
+			lowest = side;
+		}
+	}
+	
+	if(id==0) //there are no more IDs
+		return 0;
+	
+	//find the next candidate of the part which had the lowest ID
+	if(lowest!=NULL) advanceSide(frontier, lowest);
+	else advanceTree(frontier);
+	
+	return id;
+}
@@ -33,9 +33,18 @@
 #include "RankedStringDictionary.h"
 #include <libcdsBasics.h>
 #include <vector>
+#include <thread>
+#include <algorithm>
+#include <new>
 #include "iterators/IteratorDictString.h"
 #include "utils/LogSequence.h"
-#include "ranked/RankedPrefixNode.h"
+#include "utils/MemoryUsage.h"
+#include "ranked/RankedPrefixHeap.h"
+#include "ranked/RankedPrefixSession.h"
+#include "ranked/RankedTopTier.h"
+#include "ranked/RankedHeaderSample.h"
+#include "ranked/RankedTopKFrontier.h"
+#include "ranked/RankedQueryContext.h"
 
 #include "RePair/Coder/IRePair.h"
 #include "utils/DAC_VLS.h"
@@ -43,13 +52,15 @@
 using namespace std;
 using namespace cds_utils;
 
+class IteratorRankedDictIDTopK;
+class IteratorRankedDictStringTopK;
 
 
 struct lowestIdBucket //struct for top_k operation for finding the lowest ID between the first, last and middle buckets.
 {
     uint bucket; //the position of the first or last bucket in our range or numbuckets+1 for middle buckets
-	uint position; //the position of the string in the RPDAC
-    uint id;
+	size_t position; //the position of the string in the RPDAC
+    size_t id;
 	uint startPoint;
 };
 
@@ -66,15 +77,35 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		/** Class Constructor.
 		    @param it: iterator scanning the original set of strings.
 		    @param bucketsize: number of strings represented per bucket.
+		    @param threads: number of threads used for building the
+		      dictionary (the string sort, the bucket reordering and
+		      the construction of P and the RePair/DAC sequence).
+		    @param topT: number of IDs (the first ones) also stored
+		      uncompressed for fast extraction (0 for none).
+		    @param sampleRate: one of every sampleRate bucket headers is
+		      also stored uncompressed for the bucket searches (0 for none).
+		    @param options: options of the RePair compression.
 		*/
-		RankedStringDictionaryRPDAC(IteratorDictString *it, uint bucketsize);
+		RankedStringDictionaryRPDAC(IteratorDictString *it, uint bucketsize, uint threads=1, uint topT=0, uint sampleRate=0, const RePairOptions &options=RePairOptions());
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint strLen);
+		size_t locate(uchar *str, uint strLen);
+
+		/** Retrieves the IDs corresponding to a batch of strings. The
+		    strings are sorted and the binary search over the headers is
+		    performed for all of them together, so each header is
+		    decompressed once per batch (as well as each bucket reached).
+		    @param strings: the strings to be searched.
+		    @param lengths: the string lengths.
+		    @param n: number of strings in the batch.
+		    @param ids: array (of n positions) for the IDs, in the order
+		      of the input (NORESULT for the strings not found).
+		*/
+		void locateBatch(uchar **strings, uint *lengths, uint n, size_t *ids);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -84,6 +115,33 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Obtains the string associated with the given ID using the
+		    memory of a query context.
+		    @param id: the ID to be extracted.
+		    @param strLen: pointer to the extracted string length.
+		    @param context: the query context (the string is valid until
+		      its next query and must not be deleted).
+		    @returns the requested string.
+		 */
+		uchar* extract(size_t id, uint *strLen, RankedQueryContext *context);
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -104,7 +162,7 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -127,7 +185,7 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -135,6 +193,12 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		*/
 		IteratorRankedDictString* extractTable();
 
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes.
 		    @returns the dictionary size in bytes.
 		*/
@@ -158,9 +222,11 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static RankedStringDictionary *load(ifstream &in);
+		static RankedStringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		
 		/** Locates the first k IDs of those elements prefixed by the given
@@ -181,6 +247,34 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		*/
 		IteratorRankedDictString* extractRankedPrefix(uchar *str, uint strLen, uint k);
 		
+		/** Locates the first k IDs of those elements prefixed by the given
+		    string, reusing the bucket range of the previous prefix searched
+		    in the session when the new one extends it (e.g. one keystroke more).
+		    @param session: the session of consecutive prefixes (it is updated).
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+			@param k: the maximun number of elements to return
+		    @param context: query context whose memory is used for the
+		      auxiliar structures and the IDs (NULL for the heap). The IDs
+		      are valid until its next query.
+		    @returns an iterator for direct scanning of all the IDs.
+		*/
+		IteratorRankedDictID* locateRankedPrefix(RankedPrefixSession *session, uchar *str, uint strLen, uint k, RankedQueryContext *context=NULL);
+		
+		/** Extracts the first k strings of those elements prefixed by the given
+		    string, reusing the bucket range of the previous prefix searched
+		    in the session when the new one extends it.
+		    @param session: the session of consecutive prefixes (it is updated).
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+			@param k: the maximun number of elements to return
+		    @param context: query context whose memory is used for the
+		      auxiliar structures and the strings (NULL for the heap). The
+		      strings are valid until its next query and must not be deleted.
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractRankedPrefix(RankedPrefixSession *session, uchar *str, uint strLen, uint k, RankedQueryContext *context=NULL);
+		
 		/** Extracts the first (ranked) k strings of those elements in the closed interval given
 		    string.
 			@param beginning: The first element of the interval
@@ -188,7 +282,73 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 			@param k: the maximun number of elements to return
 		    @returns an iterator for direct scanning of all the strings.
 		*/
-		IteratorRankedDictString* extractRankedInterval(uint beginning, uint len, uint k);
+		IteratorRankedDictString* extractRankedInterval(size_t beginning, size_t len, uint k);
+		
+		/** Extracts the first (ranked) k strings of those elements in the
+		    closed interval given, using the memory of a query context.
+			@param beginning: The first element of the interval
+			@param len: The length of the interval
+			@param k: the maximun number of elements to return
+		    @param context: the query context (the strings are valid until
+		      its next query and must not be deleted).
+		    @returns an iterator for direct scanning of all the strings.
+		*/
+		IteratorRankedDictString* extractRankedInterval(size_t beginning, size_t len, uint k, RankedQueryContext *context);
+		
+		/** Locates lazily (in increasing order, without a fixed k) the IDs
+		    of those elements prefixed by the given string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+		    @param resume: token obtained from a previous iterator of the
+		      same prefix, for continuing after its last ID (NULL for
+		      starting from the beginning).
+		    @returns an iterator which computes each ID when it is requested
+		      (NULL if the token does not belong to this dictionary).
+		*/
+		IteratorRankedDictIDTopK* locateRankedPrefixLazy(uchar *str, uint strLen, RankedTopKToken *resume=NULL);
+		
+		/** Extracts lazily (in increasing order of ID, without a fixed k)
+		    the strings of those elements prefixed by the given string.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+		    @param resume: token obtained from a previous iterator of the
+		      same prefix (NULL for starting from the beginning).
+		    @returns an iterator which computes each string when it is requested
+		      (NULL if the token does not belong to this dictionary).
+		*/
+		IteratorRankedDictStringTopK* extractRankedPrefixLazy(uchar *str, uint strLen, RankedTopKToken *resume=NULL);
+		
+		/** Extracts lazily (in increasing order of ID, without a fixed k)
+		    the strings of those elements in the closed interval given.
+			@param beginning: The first element of the interval
+			@param len: The length of the interval
+		    @param resume: token obtained from a previous iterator of the
+		      same interval (NULL for starting from the beginning).
+		    @returns an iterator which computes each string when it is requested
+		      (NULL if the token does not belong to this dictionary).
+		*/
+		IteratorRankedDictStringTopK* extractRankedIntervalLazy(size_t beginning, size_t len, RankedTopKToken *resume=NULL);
+		
+		
+		/** Stores uncompressed the headers of one of every rate buckets
+		    (replacing the previous sample), so the binary searches over
+		    the buckets (locate and prefix operations) only decompress
+		    headers in their last steps.
+		    @param rate: the sampling rate (0 for removing the sample).
+		*/
+		void setHeaderSample(uint rate);
+		
+		/** Changes the IDs of the strings (e.g. new popularity ranks)
+		    without compressing them again. The buckets do not change, so
+		    only P, H and the order inside each bucket are rebuilt: the
+		    RePair grammar is kept and only the DAC sequence is encoded
+		    again (the top tier is also rebuilt).
+		    @param newIds: the new ID of each string (newIds[id-1] for the
+		      current ID id). It must be a permutation of 1..n.
+		    @returns true if the dictionary was re-ranked (false if newIds
+		      is not a valid permutation).
+		*/
+		bool rerank(size_t *newIds);
 		
 		
 		/** Generic destructor. */
@@ -201,29 +361,128 @@ class RankedStringDictionaryRPDAC : public RankedStringDictionary
 		RePair *rp;
         WaveletTreeNoptrs *P;
 		LogSequence * H;
+		RankedTopTier * top; //plain strings of the first IDs (NULL if there is not)
+		RankedHeaderSample * sample; //plain headers of some buckets (NULL if there is not)
+		
+		//narrows the buckets [left, right] of a search with the header sample (true if the header of the sampled bucket *match is equal to str or prefixed by it)
+		inline bool sampleBuckets(uchar *str, uint strLen, bool prefix, uint *left, uint *right, uint *match);
+		
+		//extracts the string in the position rpPos of the RPDAC (in the memory of the context, if any)
+		inline uchar* extractPosition(size_t rpPos, uint *strLen, RankedQueryContext *context=NULL);
+		
+		//decodes the string in the position rpPos of the RPDAC in the buffer s (of maxlength+1 chars) and returns its length (an invalid position is reported and decodes as an empty string)
+		inline uint decodePosition(size_t rpPos, uchar *s);
+		
+		//decodes a block of the table of exportTable (alphabetically, by bucket ranges)
+		bool decodeTable(bool lexicographic, RankedTableBlock *block);
+		
+		//sections of the mapped layout: 0 the sizes, 1 the RePair, 2 P, 3 H and 4 the top tier and the header sample
+		static const uint SECTIONS = 5;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+		
+		//extracts the string of the given id, from the top tier if it is there or from the position rpPos of the RPDAC
+		uchar* extractString(size_t id, size_t rpPos, uint *strLen, RankedQueryContext *context=NULL);
+		
+		//frees the result of topKprefix or topKInterval (if it is not in the context)
+		inline void deleteTopK(size_t **ids, RankedQueryContext *context);
+
 		
 		inline IteratorRankedDictID* findPrefix(uchar *str, uint strLen, size_t* numLocated);
 		
-		//creates the auxiliar tree needed for the locateRankedPrefix
-		inline RankedPrefixNode ** createAuxiliarTree(uint first, uint last, uint *differentBits, uint *numNodes);
+		//searches the strings order[lo..hi) (sorted) of a batch, which are all between the buckets left and right
+		void locateGroup(uchar **strings, uint *lengths, uint *order, uint lo, uint hi, uint left, uint right, size_t *ids);
+		
+		//compares two strings lexicographically (<0, 0 or >0 as strcmp)
+		static inline int compareStrings(uchar *str1, uint len1, uchar *str2, uint len2)
+		{
+			int cmp = memcmp(str1, str2, min(len1, len2));
+			if(cmp!=0) return cmp;
+			return (len1<len2) ? -1 : ((len1>len2) ? 1 : 0);
+		}
+		
+		struct BatchOrder //sorts the positions of a batch by their strings
+		{
+			uchar **strings;
+			uint *lengths;
+			BatchOrder(uchar **_strings, uint *_lengths) : strings(_strings), lengths(_lengths) {}
+			bool operator()(uint i, uint j)
+			{
+				return compareStrings(strings[i], lengths[i], strings[j], lengths[j]) < 0;
+			}
+		};
 		
-		//finds the next bucket and position inside it, also updates the tree
-		inline uint nextMidBucket(uint first, uint last, RankedPrefixNode ** auxTree, uint *inPos, uint numNodes);
+		//prepares the auxiliar heap of the middle buckets [first, last] needed for the locateRankedPrefix (skipping the IDs up to minId)
+		inline void createAuxiliarTree(uint first, uint last, RankedPrefixHeap *heap, size_t minId=0);
+		
+		//computes the candidates of a node of the heap from its sons
+		inline void initHeapNode(RankedPrefixHeap *heap, uint level, uint label);
+		
+		//obtains the candidate of a son in the level of its father (0 if there is not)
+		inline size_t heapSonCandidate(RankedPrefixHeap *heap, uint level, uint label);
+		
+		//finds the next bucket and position inside it, also updates the heap
+		inline uint nextMidBucket(RankedPrefixHeap *heap, uint *inPos);
 		
 		//finds the next id with the prefix *str in the bucket (starting from startPoint)
-		inline uint nextIdFirstLastBucket(uchar *str, uint strLen, uint bucket, uint *startPoint);
+		inline size_t nextIdFirstLastBucket(uchar *str, uint strLen, uint bucket, uint *startPoint);
 		
-		//finds the first n elements with the prefix str
-		inline size_t ** topKprefix(uchar *str, uint strLen, uint n, size_t* numLocated);
+		//finds the first and last buckets which can contain the prefix str (false if the session knows there is none)
+		inline bool prefixBuckets(uchar *str, uint strLen, RankedPrefixSession *session, uint *first, uint *last);
+		
+		//finds the first n elements with the prefix str (narrowing the range stored in the session, if any)
+		inline size_t ** topKprefix(uchar *str, uint strLen, uint n, size_t* numLocated, RankedPrefixSession *session=NULL, RankedQueryContext *context=NULL);
 		
 		//finds the first n elements in the interval given
-		inline size_t ** topKInterval(uint beginning, uint len, uint k);
+		inline size_t ** topKInterval(size_t beginning, size_t len, uint k, RankedQueryContext *context=NULL);
 		
 		inline void reorderLowestIdBucket(lowestIdBucket* array);
-
+		
+		//number of strings in the bucket
+		inline uint bucketElements(uint bucket);
+		
+		//checks that the bucket range and the ID of a top k token are inside this dictionary
+		bool validToken(RankedTopKToken *resume);
+		
+		//creates the frontier of a lazy top k prefix query (continuing after the ID of the token, if any; NULL if it is not valid)
+		inline RankedTopKFrontier* prefixFrontier(uchar *str, uint strLen, RankedTopKToken *resume);
+		
+		//creates the frontier of a lazy top k interval query (continuing after the ID of the token, if any; NULL if it is not valid)
+		inline RankedTopKFrontier* intervalFrontier(size_t beginning, size_t len, RankedTopKToken *resume);
+		
+		//adds to the frontier the inner positions (startPoint, end] of the bucket, skipping the IDs up to minId
+		inline void addSide(RankedTopKFrontier *frontier, uint bucket, uint startPoint, uint end, bool check, size_t minId);
+		
+		//adds to the frontier the middle buckets [midFirst, midLast], skipping the IDs up to minId
+		inline void addMiddle(RankedTopKFrontier *frontier, uint midFirst, uint midLast, size_t minId);
+		
+		//finds the next candidate of a side of the frontier
+		inline void advanceSide(RankedTopKFrontier *frontier, RankedTopKSide *side);
+		
+		//finds the next candidate of the middle buckets of the frontier
+		inline void advanceTree(RankedTopKFrontier *frontier);
+		
+		//obtains the next lowest ID of the frontier and its position in the RPDAC (0 if there are no more)
+		size_t nextTopK(RankedTopKFrontier *frontier, size_t *position);
+		
+		//sorts the items lexicographically splitting the work in the given number of threads
+		static void sortItems(vector<dictItem> *items, uint threads);
+		
+		//sorts by ID the strings of the buckets [firstBucket, lastBucket) obtaining their final positions and headers
+		static void reorderBuckets(vector<dictItem> *items, uint bucketsize, uint firstBucket, uint lastBucket, size_t *finalOrder, size_t *headers);
+		
+		//builds the wavelet tree P from the bucket of each ID
+		static void buildP(RankedStringDictionaryRPDAC *dict, uint *bucketNumber);
+		
+		friend class IteratorRankedDictIDTopK;
+		friend class IteratorRankedDictStringTopK;
 
 
 };
 
+#include "iterators/IteratorRankedDictIDTopK.h"
+#include "iterators/IteratorRankedDictStringTopK.h"
+
 #endif
 
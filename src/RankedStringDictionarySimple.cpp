@@ -34,13 +34,23 @@ RankedStringDictionarySimple::RankedStringDictionarySimple()
 	this->type = RDS;
 	this->elements = 0;
 	this->maxlength = 0;
+	this->permutation = NULL;
+	this->mDictionary = NULL;
+	this->top = NULL;
+	this->ids = NULL;
+	this->rmq = NULL;
 }
 
-RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *it, uint bucketsize, uint dictionaryType, char compress)
+RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *it, uint bucketsize, uint dictionaryType, char compress, uint topT, const RePairOptions &options)
 {
 	this->type = RDS;
 	this->maxlength = 0;
 	this->elements = 0;
+	this->permutation = NULL;
+	this->mDictionary = NULL;
+	this->top = NULL;
+	this->ids = NULL;
+	this->rmq = NULL;
 	if(dictionaryType==4) //is HASHRPDAC
 	{
 		vector<uchar*> strings;
@@ -53,8 +63,8 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 		((IteratorDictStringPlain*)it)->restart();
 		
 		//create the hash dictionary
-		mDictionary = new StringDictionaryHASHRPDAC(it, elements, bucketsize); //for hash the bucketsize represents the overhead
-		
+		mDictionary = new StringDictionaryHASHRPDAC(it, elements, bucketsize, options); //for hash the bucketsize represents the overhead
+		if(!mDictionary->good()) return; //the strings cannot be compressed (see good)
 
 		//create the array for the permutation
 		uint* elems = new uint[elements];
@@ -89,7 +99,7 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 		//Insert the items in the list using the iterator
 		uchar* strCurrent=NULL;
 		uint lenCurrent=0;
-		uint id=0;
+		size_t id=0;
 		while(it->hasNext())
 		{
 			id++;
@@ -132,6 +142,11 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 		permutation = pb->build(perm, elements+1);
 		delete pb;
 
+		//the IDs in alphabetical order and their RMQ for the top k queries (without inverting the permutation)
+		ids = new LogSequence(bitsperm, elements);
+		for (uint i=0; i<elements; i++) ids->setField(i, itemsList[i].itemId);
+		rmq = new RankedRMQ(ids);
+
 
 		//create the array for the dictionary
 		vector<uchar*> elemsStr;
@@ -159,7 +174,7 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 				{
 					//Re-Pair compression
 					cout << "RPCF" << endl;
-					mDictionary = new StringDictionaryRPFC(iter, bucketsize);
+					mDictionary = new StringDictionaryRPFC(iter, bucketsize, options);
 				}
 				else
 					cerr << "wrong parameters" << endl;
@@ -177,7 +192,7 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 				{
 					// RePair compression
                     cout << "RPHTFC" << endl;
-                    mDictionary = new StringDictionaryRPHTFC(iter, bucketsize);
+                    mDictionary = new StringDictionaryRPHTFC(iter, bucketsize, options);
 				}
 				else if(compress == 'h')
 				{
@@ -192,11 +207,26 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 				case 3: //RPDAC Ranked dictionary
 			{
 				cout << "RPDAC" << endl;
-				mDictionary = new StringDictionaryRPDAC(iter);
+				mDictionary = new StringDictionaryRPDAC(iter, options);
 				break;
 			}
 		}
 	}
+	if(!good()) return; //the strings cannot be compressed (see good)
+	
+	//Store the strings of the first IDs uncompressed
+	if(topT>elements) topT=elements;
+	if(topT>0)
+	{
+		uchar **topStrings = new uchar*[topT];
+		uint topLen;
+		for(uint i=0; i<topT; i++)
+			topStrings[i] = extract(i+1, &topLen);
+		top = new RankedTopTier(topStrings, topT);
+		for(uint i=0; i<topT; i++)
+			delete [] topStrings[i];
+		delete [] topStrings;
+	}
 }
 
 
@@ -205,13 +235,13 @@ RankedStringDictionarySimple::RankedStringDictionarySimple(IteratorDictString *i
 
 
 
-uint RankedStringDictionarySimple::locate(uchar *str, uint strLen)
+size_t RankedStringDictionarySimple::locate(uchar *str, uint strLen)
 {
-    uint orderedPos = mDictionary->locate(str,strLen);
+    size_t orderedPos = mDictionary->locate(str,strLen);
     if(orderedPos == NORESULT) //if the string it's not in the dictionary orderedPos=0
         return NORESULT;
 
-	uint elemId = permutation->revpi(orderedPos)+1; //+1 because the permutation starts with 0
+	size_t elemId = permutation->revpi(orderedPos)+1; //+1 because the permutation starts with 0
     return elemId;
 }
 
@@ -224,6 +254,9 @@ uchar* RankedStringDictionarySimple::extract(size_t id, uint *strLen)
     //if the id its higher than the number of elements return 0
     if(id>elements)
         return 0;
+    //the most popular strings are stored uncompressed
+    if(top!=NULL && top->contains(id))
+        return top->extract(id, strLen);
     uint orderedPos = permutation->pi(id-1); //-1 because the permutation starts with 0 and we start the ids with 1
     uchar* s = mDictionary->extract(orderedPos, strLen);
 	return s;
@@ -233,6 +266,34 @@ uchar* RankedStringDictionarySimple::extract(size_t id, uint *strLen)
 
 
 
+uint RankedStringDictionarySimple::extractInto(size_t id, uchar *buf, size_t cap)
+{
+    if(id==0 || id>elements)
+        return 0;
+    //the most popular strings are copied from the top tier
+    if(top!=NULL && top->contains(id))
+    {
+        uint strLen;
+        uchar *str = top->access(id, &strLen);
+        if(strLen<cap) memcpy(buf, str, strLen+1);
+        return strLen;
+    }
+    return mDictionary->extractInto(permutation->pi(id-1), buf, cap);
+}
+
+
+
+
+
+size_t RankedStringDictionarySimple::extractCapacity()
+{
+	return mDictionary->extractCapacity();
+}
+
+
+
+
+
 IteratorRankedDictID* RankedStringDictionarySimple::locatePrefix(uchar *str, uint strLen)
 {
 
@@ -266,7 +327,7 @@ IteratorRankedDictID* RankedStringDictionarySimple::locateSubstr(uchar *str, uin
 
 
 
-uint RankedStringDictionarySimple::locateRank(uint rank)
+size_t RankedStringDictionarySimple::locateRank(size_t rank)
 {
     return rank;
 }
@@ -308,7 +369,7 @@ IteratorRankedDictString* RankedStringDictionarySimple::extractSubstr(uchar *str
 
 
 
-uchar* RankedStringDictionarySimple::extractRank(uint rank, uint *strLen)
+uchar* RankedStringDictionarySimple::extractRank(size_t rank, uint *strLen)
 {
     return extract(rank, strLen);
 }
@@ -320,19 +381,46 @@ uchar* RankedStringDictionarySimple::extractRank(uint rank, uint *strLen)
 
 IteratorRankedDictString* RankedStringDictionarySimple::extractTable()
 {
-cerr << "This dictionary does not provide table extraction" << endl;
-    return NULL;
+	return tableIterator();
 }
 
 
 
 
 
+bool RankedStringDictionarySimple::decodeTable(bool lexicographic, RankedTableBlock *block)
+{
+	//the strings of the hash dictionary are not sorted
+	if(lexicographic && dynamic_cast<StringDictionaryHASHRPDAC*>(mDictionary)!=NULL)
+		return false;
+	
+	//the positions of the block in mDictionary are extracted together (so each bucket is decoded once)
+	size_t count = block->getCount();
+	size_t *positions = new size_t[count];
+	for(size_t slot=0; slot<count; slot++)
+		positions[slot] = lexicographic ? block->getFirst()+slot : permutation->pi(block->getFirst()+slot-1);
+	mDictionary->extractBatch(positions, count, RankedTableBlock::store, block);
+	
+	delete [] positions;
+	return true;
+}
+
+
 
 
+
+
+
+bool RankedStringDictionarySimple::good()
+{
+	return mDictionary!=NULL && mDictionary->good();
+}
+
 size_t RankedStringDictionarySimple::getSize()
 {
-    return permutation->getSize() + mDictionary->getSize() + sizeof(RankedStringDictionarySimple);
+	size_t topSize = (top!=NULL) ? top->getSize() : 0;
+	size_t rmqSize = (rmq!=NULL) ? ids->getSize() + rmq->getSize() : 0;
+    return permutation->getSize() + mDictionary->getSize() + topSize + rmqSize + sizeof(RankedStringDictionarySimple);
 }
 
 
@@ -362,11 +450,9 @@ size_t RankedStringDictionarySimple::numElements()
 
 void RankedStringDictionarySimple::save(ofstream &out)
 {
-    saveValue<uint32_t>(out, type);
-    saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	permutation->save(out);
-	mDictionary->save(out);
+	//the sections are stored back to back
+	for(uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 
@@ -374,63 +460,159 @@ void RankedStringDictionarySimple::save(ofstream &out)
 
 
 
-RankedStringDictionary * RankedStringDictionarySimple::load(ifstream &in)
+RankedStringDictionary * RankedStringDictionarySimple::load(ifstream &in, const RePairOptions &options)
 {
     RankedStringDictionarySimple * dict = new RankedStringDictionarySimple();
-    dict->type = RDS;
-    dict->elements = loadValue<uint64_t>(in);
-    dict->maxlength = loadValue<uint32_t>(in);
-    dict->permutation = Permutation::load(in);
-    uint32_t dictType = loadValue<uint32_t>(in);
-    switch(dictType) //check the inside dictionary type
-    {
-        case PFC:
-        {
-            dict->mDictionary = StringDictionaryPFC::load(in);
-            break;
-        }
-        case RPFC:
-        {
-            dict->mDictionary = StringDictionaryRPFC::load(in);
-            break;
-        }
-        case HTFC:
-        {
-            dict->mDictionary = StringDictionaryHTFC::load(in);
-            break;
-        }
-        case HHTFC:
-        {
-            dict->mDictionary = StringDictionaryHHTFC::load(in);
-            break;
-        }
-        case RPHTFC:
-        {
-            dict->mDictionary = StringDictionaryRPHTFC::load(in);
-            break;
-        }
-        case RPDAC:
-        {
-            dict->mDictionary = StringDictionaryRPDAC::load(in);
-            break;
-        }
-		case HASHRPDAC:
+	for(uint s=0; s<SECTIONS; s++)
+	{
+		if(!dict->loadSection(s, in, options))
 		{
-			dict->mDictionary = StringDictionaryHASHRPDAC::load(in);
-			break;
+			delete dict;
+			return NULL;
 		}
-		default:
-        {
-            return NULL;
-        }
-    }
-	
+	}
     return dict;
 }
 
 
+
+
+
+
+uint RankedStringDictionarySimple::numSections()
+{
+	return SECTIONS;
+}
+
+
+
+
+
+
+void RankedStringDictionarySimple::saveSection(uint section, ofstream &out)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			break;
+		}
+		case 1: permutation->save(out); break;
+		case 2: mDictionary->save(out); break;
+		case 3:
+		{
+			//save the top tier (0 if there is not)
+			if(top!=NULL) top->save(out);
+			else saveValue<uint32_t>(out, 0);
+			break;
+		}
+		case 4:
+		{
+			//save the IDs in alphabetical order and their RMQ (0 if there are not)
+			if(rmq!=NULL)
+			{
+				saveValue<uint32_t>(out, 1);
+				ids->save(out);
+				rmq->save(out);
+			}
+			else saveValue<uint32_t>(out, 0);
+			break;
+		}
+	}
+}
+
+
+
+
+
+
+bool RankedStringDictionarySimple::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch(section)
+	{
+		case 0:
+		{
+			type = RDS;
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			permutation = Permutation::load(in);
+			return permutation!=NULL;
+		}
+		case 2:
+		{
+			uint32_t dictType = loadValue<uint32_t>(in);
+			switch(dictType) //check the inside dictionary type
+			{
+				case PFC: mDictionary = StringDictionaryPFC::load(in); break;
+				case RPFC: mDictionary = StringDictionaryRPFC::load(in, options); break;
+				case HTFC: mDictionary = StringDictionaryHTFC::load(in); break;
+				case HHTFC: mDictionary = StringDictionaryHHTFC::load(in); break;
+				case RPHTFC: mDictionary = StringDictionaryRPHTFC::load(in, options); break;
+				case RPDAC: mDictionary = StringDictionaryRPDAC::load(in, options); break;
+				case HASHRPDAC: mDictionary = StringDictionaryHASHRPDAC::load(in, HASHRPDAC, options); break;
+			}
+			return mDictionary!=NULL;
+		}
+		case 3:
+		{
+			//load the top tier (dictionaries saved before it was added end here)
+			if(in.peek()!=EOF)
+			{
+				streampos tierPos = in.tellg();
+				if(loadValue<uint32_t>(in)>0)
+				{
+					in.seekg(tierPos);
+					top = RankedTopTier::load(in);
+				}
+			}
+			in.clear(); //peek at the end of the file sets eof
+			return true;
+		}
+		case 4:
+		{
+			//load the RMQ (dictionaries saved before it was added end here and use the permutation)
+			if(in.peek()!=EOF && loadValue<uint32_t>(in)>0)
+			{
+				ids = new LogSequence(in);
+				rmq = RankedRMQ::load(in, ids);
+			}
+			in.clear();
+			return true;
+		}
+	}
+	return false;
+}
+
+
 IteratorRankedDictID* RankedStringDictionarySimple::locateRankedPrefix(uchar *str, uint strLen, uint k)
 {
+	//the answer can be in the top tier
+	if(top!=NULL)
+	{
+		size_t* topIds = new size_t[k];
+		if(top->topKprefix(str, strLen, k, topIds))
+			return new IteratorRankedDictIDNoContiguous(topIds, k);
+		delete [] topIds;
+	}
+	
+	//the k smallest IDs of the alphabetical range are obtained directly
+	if(rmq!=NULL)
+	{
+		size_t left, right;
+		if(!prefixRange(str, strLen, &left, &right))
+			return NULL;
+		size_t *topk = new size_t[k];
+		k = rmq->topK(left-1, right-1, k, topk);
+		return new IteratorRankedDictIDNoContiguous(topk, k);
+	}
+	
 	IteratorDictID * orderedIds =  mDictionary->locatePrefix(str, strLen); //get the positions in the ordered dictionary
 
     //if the iterator is null return null
@@ -441,8 +623,8 @@ IteratorRankedDictID* RankedStringDictionarySimple::locateRankedPrefix(uchar *st
     }
 	
 	
-	uint* allIds = new uint[orderedIds->size()];
-	uint x=0;
+	size_t* allIds = new size_t[orderedIds->size()];
+	size_t x=0;
 	
 	while(orderedIds->hasNext()) //obtain the real IDs with the permutation
 	{
@@ -460,6 +642,31 @@ IteratorRankedDictID* RankedStringDictionarySimple::locateRankedPrefix(uchar *st
 
 IteratorRankedDictString* RankedStringDictionarySimple::extractRankedPrefix(uchar *str, uint strLen, uint k)
 {
+	//the answer can be in the top tier
+	if(top!=NULL)
+	{
+		size_t* topIds = new size_t[k];
+		if(top->topKprefix(str, strLen, k, topIds))
+		{
+			vector<uchar*> strings;
+			uint strl;
+			for(uint i=0; i<k; i++)
+				strings.push_back(top->extract(topIds[i],&strl));
+			delete [] topIds;
+			return new IteratorRankedDictStringVector(&strings, k);
+		}
+		delete [] topIds;
+	}
+	
+	//the k smallest IDs of the alphabetical range are obtained directly
+	if(rmq!=NULL)
+	{
+		size_t left, right;
+		if(!prefixRange(str, strLen, &left, &right))
+			return NULL;
+		return extractTopK(left, right, k);
+	}
+	
 	IteratorDictID * orderedIds =  mDictionary->locatePrefix(str, strLen); //get the positions in the ordered dictionary
 
     //if the iterator is null return null
@@ -470,8 +677,8 @@ IteratorRankedDictString* RankedStringDictionarySimple::extractRankedPrefix(ucha
     }
 	
 	
-	uint* allIds = new uint[orderedIds->size()];
-	uint x=0;
+	size_t* allIds = new size_t[orderedIds->size()];
+	size_t x=0;
 	
 	while(orderedIds->hasNext()) //obtain the real IDs with the permutation
 	{
@@ -484,40 +691,36 @@ IteratorRankedDictString* RankedStringDictionarySimple::extractRankedPrefix(ucha
 	size_t* topk = insertionSort(allIds,x,k);
 	delete [] allIds;
 	//extract the strings for the ids
-	vector<uchar*> strings;
-	uint strl;
-	for(uint i=0; i<k; i++)
-		strings.push_back(this->extract(topk[i],&strl));
-	
-	IteratorRankedDictString* it = new IteratorRankedDictStringVector(&strings, k);
+	IteratorRankedDictString* it = extractRanked(topk, NULL, k);
 	
+	delete [] topk;
 	return it;
 }
 
 
-IteratorRankedDictString* RankedStringDictionarySimple::extractRankedInterval(uint beginning, uint len, uint k)
+IteratorRankedDictString* RankedStringDictionarySimple::extractRankedInterval(size_t beginning, size_t len, uint k)
 {
 	if(len<k) //if the interval is less than k, set k to the interval length
 		k=len;
+	
+	//the k smallest IDs of the interval are obtained directly
+	if(rmq!=NULL && len>0 && beginning>0 && beginning<=elements)
+		return extractTopK(beginning, min((size_t)beginning+len-1, (size_t)elements), k);
 		
-	uint* allIds = new uint[len];
+	size_t* allIds = new size_t[len];
 	
-	for(uint i=0; i<len; i++) //obtain the real IDs of the interval with the permutation
+	for(size_t i=0; i<len; i++) //obtain the real IDs of the interval with the permutation
 	{
 		allIds[i] = permutation->revpi(beginning+i)+1;
 	}
 	
 	//get the first k with an insertion sort
 	size_t* topk = insertionSort(allIds,len,k);
+	delete [] allIds;
 	//extract the strings for the ids
-	vector<uchar*> strings;
-	uint strl;
-	for(uint i=0; i<k; i++)
-		strings.push_back(this->extract(topk[i],&strl));
+	IteratorRankedDictString* it = extractRanked(topk, NULL, k);
 	
 	delete [] topk;
-	IteratorRankedDictString* it = new IteratorRankedDictStringVector(&strings, k);
-	
 	return it;
 }
 
@@ -526,12 +729,15 @@ RankedStringDictionarySimple::~RankedStringDictionarySimple()
 {
     delete mDictionary;
     delete permutation;
+	if(top!=NULL) delete top;
+	if(rmq!=NULL) delete rmq;
+	if(ids!=NULL) delete ids;
 }
 
 
 
 
-size_t* RankedStringDictionarySimple::insertionSort(uint* allIds, uint n, uint k)
+size_t* RankedStringDictionarySimple::insertionSort(size_t* allIds, size_t n, uint k)
 {
 	size_t* topk = new size_t[k];
 	
@@ -540,9 +746,9 @@ size_t* RankedStringDictionarySimple::insertionSort(uint* allIds, uint n, uint k
 		topk[i]=this->elements+1;
 	
 	int actualPos; //the position to be compared
-	uint actualId; //the id of the topk array to be compared
+	size_t actualId; //the id of the topk array to be compared
 	//only one run to the array to sort
-	for(uint i=0; i<n; i++)
+	for(size_t i=0; i<n; i++)
 	{
 		actualPos=k-1;
 		actualId=topk[actualPos];
@@ -565,3 +771,71 @@ size_t* RankedStringDictionarySimple::insertionSort(uint* allIds, uint n, uint k
 	return topk;
 }
 
+
+
+bool RankedStringDictionarySimple::prefixRange(uchar *str, uint strLen, size_t *left, size_t *right)
+{
+	//the dictionaries with the RMQ are Front-Coding or RPDAC, which return contiguous positions
+	IteratorDictIDContiguous *it = (IteratorDictIDContiguous*)mDictionary->locatePrefix(str, strLen);
+	*left = it->getLeftLimit();
+	*right = it->getRightLimit();
+	delete it;
+
+	return *left!=NORESULT && *left<=*right;
+}
+
+
+
+
+IteratorRankedDictString* RankedStringDictionarySimple::extractTopK(size_t left, size_t right, uint k)
+{
+	size_t *topk = new size_t[k];
+	size_t *positions = new size_t[k];
+	k = rmq->topK(left-1, right-1, k, topk, positions);
+
+	//the strings are extracted from their alphabetical positions (without the permutation)
+	for(uint i=0; i<k; i++)
+		positions[i]++;
+	IteratorRankedDictString* it = extractRanked(topk, positions, k);
+
+	delete [] topk;
+	delete [] positions;
+	return it;
+}
+
+
+
+
+IteratorRankedDictString* RankedStringDictionarySimple::extractRanked(size_t *topk, size_t *positions, uint k)
+{
+	vector<uchar*> strings(k, (uchar*)NULL);
+	uint strl;
+	
+	//the strings of the top tier are copied, the rest are extracted together (sorted by position, so each bucket is decoded once)
+	size_t *batch = new size_t[k];
+	uint *batchIndex = new uint[k];
+	uint batchSize = 0;
+	for(uint i=0; i<k; i++)
+	{
+		if(top!=NULL && top->contains(topk[i]))
+			strings[i] = top->extract(topk[i], &strl);
+		else
+		{
+			batch[batchSize] = (positions!=NULL) ? positions[i] : permutation->pi(topk[i]-1);
+			batchIndex[batchSize] = i;
+			batchSize++;
+		}
+	}
+	
+	uchar **batchStrings = new uchar*[batchSize];
+	uint *batchLens = new uint[batchSize];
+	mDictionary->extractBatch(batch, batchSize, batchStrings, batchLens);
+	for(uint i=0; i<batchSize; i++)
+		strings[batchIndex[i]] = batchStrings[i];
+	
+	delete [] batch;
+	delete [] batchIndex;
+	delete [] batchStrings;
+	delete [] batchLens;
+	return new IteratorRankedDictStringVector(&strings, k);
+}
@@ -36,6 +36,9 @@
 #include <libcdsBasics.h>
 #include <vector>
 #include "iterators/IteratorDictString.h"
+#include "ranked/RankedTopTier.h"
+#include "ranked/RankedRMQ.h"
+#include "utils/LogSequence.h"
 
 using namespace std;
 using namespace cds_utils;
@@ -55,15 +58,19 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 		/** Class Constructor.
 		    @param it: iterator scanning the original set of strings.
 		    @param bucketsize: number of strings represented per bucket.
+		    @param topT: number of IDs (the first ones) also stored
+		      uncompressed for fast extraction (0 for none).
+		    @param options: options of the RePair compression (if the
+		      strings are compressed with RePair).
 		*/
-		RankedStringDictionarySimple(IteratorDictString *it, uint bucketsize, uint dictionaryType, char compress);
+		RankedStringDictionarySimple(IteratorDictString *it, uint bucketsize, uint dictionaryType, char compress, uint topT=0, const RePairOptions &options=RePairOptions());
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint strLen);
+		size_t locate(uchar *str, uint strLen);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -73,6 +80,23 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -93,7 +117,7 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -116,7 +140,7 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -124,6 +148,12 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 		*/
 		IteratorRankedDictString* extractTable();
 
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes.
 		    @returns the dictionary size in bytes.
 		*/
@@ -147,9 +177,11 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static RankedStringDictionary *load(ifstream &in);
+		static RankedStringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Locates the first k IDs of those elements prefixed by the given
 		    string.
@@ -176,7 +208,7 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 			@param k: the maximun number of elements to return
 		    @returns an iterator for direct scanning of all the strings.
 		*/
-		IteratorRankedDictString* extractRankedInterval(uint beginning, uint len, uint k);
+		IteratorRankedDictString* extractRankedInterval(size_t beginning, size_t len, uint k);
 		
 		/** Generic destructor. */
 		~RankedStringDictionarySimple();
@@ -184,8 +216,29 @@ class RankedStringDictionarySimple : public RankedStringDictionary
 	protected:
         Permutation * permutation;
         StringDictionary * mDictionary ;
+		RankedTopTier * top; //plain strings of the first IDs (NULL if there is not)
+		LogSequence * ids; //ID of the string in each alphabetical position (NULL if there is not)
+		RankedRMQ * rmq; //range minimum queries over ids for the top k queries (NULL if there is not)
+
+		inline size_t* insertionSort(size_t* allIds, size_t n, uint k);
+
+		//finds the alphabetical positions [left, right] (from 1) of the strings with the prefix (false if there are none)
+		inline bool prefixRange(uchar *str, uint strLen, size_t *left, size_t *right);
+
+		//extracts the strings of the k smallest IDs in the alphabetical positions [left, right] (from 1) using the RMQ
+		inline IteratorRankedDictString* extractTopK(size_t left, size_t right, uint k);
+
+		//extracts the strings of the given IDs (in their order), from their positions in mDictionary (NULL for obtaining them with the permutation)
+		inline IteratorRankedDictString* extractRanked(size_t *topk, size_t *positions, uint k);
+
+		//decodes a block of the table of exportTable (extracting its positions of mDictionary in a batch)
+		bool decodeTable(bool lexicographic, RankedTableBlock *block);
 
-		inline size_t* insertionSort(uint* allIds, uint n, uint k);
+		//sections of the mapped layout: 0 the sizes, 1 the permutation, 2 the strings, 3 the top tier and 4 the IDs with their RMQ
+		static const uint SECTIONS = 5;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
 
 };
 
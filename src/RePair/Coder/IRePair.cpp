@@ -43,6 +43,7 @@ IRePair::compress(int *text, unsigned int length, size_t *csymbols, size_t *crul
 	free(L);
 	Heap::destroyHeap(&Heap);
 	HashRP::destroyHash(&Hash);
+	Records::destroyRecords(&Rec);
 	
 	// Linking results with function parameters
 	*csymbols = alph;
@@ -67,18 +68,30 @@ if (PRNR) prnRec();
 	if (oid == -1) break; // the end!!
  	orec = &Rec.records[oid];
  	cpos = orec->cpos;
+	if (minFreq && (orec->freq < minFreq)) break; // the remaining pairs are not worth a rule
 	
 		// Adding a new rule to the dictionary
-		int lrule = 0;
+		int lrule = 0, hrule = 0;
 		
 		if (orec->pair.left < alph) lrule++; 
-		else lrule += Dicc.rules[orec->pair.left-alph].l;
+		else { lrule += Dicc.rules[orec->pair.left-alph].l; hrule = heights[orec->pair.left-alph]; }
 		
 		if (orec->pair.right < alph) lrule++; 
-		else lrule += Dicc.rules[orec->pair.right-alph].l;
+		else { lrule += Dicc.rules[orec->pair.right-alph].l; if (heights[orec->pair.right-alph] > hrule) hrule = heights[orec->pair.right-alph]; }
+		hrule++;
+		
+		if ((maxHeight && (hrule > maxHeight)) || (maxLength && (lrule > maxLength)))
+		   { // the pair is left as is (like the pairs purged from the heap, its
+		     // occurrences are no longer found in the hash)
+		     Records::removeRecord (&Rec,oid);
+		     skipped++;
+		     continue;
+		   }
 		
 		Trule nrule = {orec->pair, lrule};
 		Dictionary::insertRule (&Dicc, nrule);
+		heights.push_back(hrule);
+		if (hrule > height) height = hrule;
 	
 if (PRNP) 
     { printf("Chosen pair %i = (",n);
@@ -34,6 +34,7 @@ Chile. Blanco Encalada 2120, Santiago, Chile. gnavarro@dcc.uchile.cl
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <vector>
 
 #include "basics.h"
 #include "records.h"
@@ -51,9 +52,28 @@ static const int minsize = 256;
 class IRePair
 {
 public:
-	IRePair(){};
+	IRePair(){ maxHeight = maxLength = minFreq = 0; skipped = height = 0; };
 	int compress(int *text, unsigned int length, size_t *csymbols, size_t *crules, Tdiccarray **rules);
 
+	// bounds the grammar (0 = no bound): the pairs whose rule would be
+	// higher than maxHeight or expand to more than maxLength symbols are
+	// not replaced, and the compression stops when the most frequent pair
+	// has less than minFreq occurrences
+	void setLimits(int maxHeight, int maxLength, int minFreq)
+	{ this->maxHeight = maxHeight; this->maxLength = maxLength; this->minFreq = minFreq; }
+
+	int getHeight() { return height; }	// height of the grammar
+	int getSkipped() { return skipped; }	// pairs not replaced by the bounds
+	int getLength() { return c; }	// length of the compressed sequence
+
+	// estimated memory (bytes) used to compress a text, besides the text:
+	// 8 bytes per symbol for L, and the records, hash and heap of the
+	// pairs (1-2 bytes per symbol on string dictionaries, up to 8 are
+	// reserved for texts with more distinct pairs)
+	static const size_t FOOTPRINT = 16;
+	static const size_t OVERHEAD = 1<<20;
+	static size_t footprint(size_t length) { return FOOTPRINT*length + OVERHEAD; }
+
 private:
 	int u;		// |text| and later current |C| with gaps
 	int *C; 		// compressed text
@@ -66,6 +86,11 @@ private:
 	Trarray Rec; 	// records
 	Tdiccarray Dicc;	// compressed dictionary
 
+	int maxHeight, maxLength, minFreq;	// bounds of the grammar
+	std::vector<int> heights;	// height of each rule
+	int height;	// height of the grammar
+	int skipped;	// pairs not replaced
+
 	int repair();
 	int expand (int i, int d);
 
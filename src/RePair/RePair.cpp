@@ -26,31 +26,81 @@
  */
 
 #include "RePair.h"
+#include "../utils/MemoryUsage.h"
 
 RePair::RePair()
 {
 	this->G = NULL;
 	this->Cls = NULL;
 	this->Cdac = NULL;
+	this->ruleLength = NULL;
+	this->rulePrefix = NULL;
+	this->hotCount = 0;
+	this->hotRules = NULL;
+	this->hotBits = NULL;
+	this->hotOffset = NULL;
+	this->hotText = NULL;
 	this->maxchar = 0;
 
 	this->rules = 0;
 	this->terminals = 0;
 }
 
-RePair::RePair(int *sequence, uint length, uchar maxchar)
+RePair::RePair(int *sequence, size_t length, uchar maxchar, const RePairOptions &options)
 {
 	this->G = NULL;
 	this->Cls = NULL;
 	this->Cdac = NULL;
+	this->ruleLength = NULL;
+	this->rulePrefix = NULL;
+	this->hotCount = 0;
+	this->hotRules = NULL;
+	this->hotBits = NULL;
+	this->hotOffset = NULL;
+	this->hotText = NULL;
 	this->maxchar = maxchar;
 
 	this->rules = 0;
 	this->terminals = 0;
 
+	// IRePair stores the positions of the sequence in ints, so a longer
+	// one is compressed in blocks (which may be extended up to 1/8)
+	uint blocks = 1, concurrent = 1;
+	size_t longest = MAXSEQUENCE-MAXSEQUENCE/8;
+	if (length > MAXSEQUENCE) blocks = (length+longest-1)/longest;
+	if ((options.threads > 1) && (length >= 2*MINBLOCK))
+	{
+		concurrent = (uint)min((size_t)options.threads, length/MINBLOCK);
+		blocks = max(blocks, concurrent);
+	}
+
+	if (options.memoryBudget)
+	{
+		// The sequence is not compressed if it does not fit in the budget
+		if (!fitsBudget(length, options)) return;
+
+		concurrent = max(concurrent, min(options.threads, (uint)(length/MINBUDGETBLOCK)));
+		planBudget(length, options.memoryBudget, &blocks, &concurrent);
+		cerr << "[REPAIR] budget " << (options.memoryBudget>>20) << " MB: " << blocks << " blocks (" << concurrent << " at a time), estimated peak " << ((length*sizeof(int)+concurrent*IRePair::footprint((length+blocks-1)/blocks))>>20) << " MB" << endl;
+	}
+
+	if (blocks > 1)
+	{
+		compressBlocks(sequence, length, blocks, concurrent, options);
+		if (G == NULL) return;
+		if (options.memoryBudget) cerr << "[REPAIR] resident peak " << (MemoryUsage::peak()>>20) << " MB (of the current phase)" << endl;
+		if (options.summaries) buildSummaries();
+		return;
+	}
+
 	Tdiccarray *dicc;
 	IRePair compressor;
+	compressor.setLimits(options.maxHeight, options.maxLength, options.minFreq);
 	compressor.compress(sequence, length, (size_t*)&terminals, (size_t*)&rules, &dicc);
+
+	if (options.memoryBudget) cerr << "[REPAIR] resident peak " << (MemoryUsage::peak()>>20) << " MB (of the current phase)" << endl;
+	if (options.maxHeight || options.maxLength || options.minFreq)
+		cerr << "[REPAIR] " << rules << " rules, height " << compressor.getHeight() << ", " << compressor.getLength() << " symbols in the sequence, " << compressor.getSkipped() << " pairs not replaced" << endl;
 	// Building the array for the dictionary
 	G = new LogSequence(bits(rules+terminals), 2*rules);
 	for (uint i=0; i<rules; i++)
@@ -60,58 +110,366 @@ RePair::RePair(int *sequence, uint length, uchar maxchar)
 		G->setField((2*i)+1, dicc->rules[i].rule.right);
 	}
 	Dictionary::destroyDicc(dicc);
+
+	// The pointers skipping the replaced positions become the lengths of
+	// the runs, as in the blocks
+	size_t i = 0;
+	while (i < length)
+	{
+		if (sequence[i] < 0)
+		{
+			size_t next = -(sequence[i]+1);
+			sequence[i] = -(int)(next-i);
+			i = next;
+		}
+		else i++;
+	}
+
+	if (options.hotRules > 0) selectHotRules(sequence, length, options.hotRules);
+	if (options.summaries) buildSummaries();
 }
 
-uint
-RePair::expandRule(uint rule, uchar* str)
+bool
+RePair::fitsBudget(size_t length, const RePairOptions &options)
 {
-	uint pos = 0;
-	uint left = G->getField(2*rule);
-	uint right = G->getField((2*rule)+1);
+	uint blocks = 1, concurrent = 1;
 
-	if (left >= terminals) pos += expandRule(left-terminals, str+pos);
-	else { str[pos] = (char)left; pos++; }
+	if ((options.memoryBudget == 0) || planBudget(length, options.memoryBudget, &blocks, &concurrent)) return true;
 
-	if (right >= terminals) pos += expandRule(right-terminals, str+pos);
-	else { str[pos] = (char)right; pos++; }
+	size_t required = length*sizeof(int)+IRePair::footprint(MINBUDGETBLOCK);
+	cerr << "[REPAIR] ERROR: compressing " << length << " symbols needs a memory budget of at least " << ((required>>20)+1) << " MB (" << (options.memoryBudget>>20) << " MB given)" << endl;
+	return false;
+}
 
-	return pos;
+bool
+RePair::planBudget(size_t length, size_t budget, uint *blocks, uint *concurrent)
+{
+	// The sequence is compressed in place, so the structures of the
+	// blocks compressed at the same time use the rest of the budget
+	size_t available = (budget > length*sizeof(int)) ? budget-length*sizeof(int) : 0;
+	size_t block = 0;
+
+	while (true)
+	{
+		size_t share = available / *concurrent;
+		block = (share > IRePair::OVERHEAD) ? (share-IRePair::OVERHEAD)/IRePair::FOOTPRINT : 0;
+		if ((block >= MINBUDGETBLOCK) || (*concurrent == 1)) break;
+		(*concurrent)--;
+	}
+	if (block < MINBUDGETBLOCK) return false;
+
+	// The blocks may be extended up to 1/8 to end after a '\0'
+	block -= block/8;
+	size_t needed = (length+block-1)/block;
+	if (needed > *blocks) *blocks = needed;
+	if (*concurrent > *blocks) *concurrent = *blocks;
+
+	return true;
 }
 
-int
-RePair::expandRuleAndCompareString(uint rule, uchar *str, uint *pos)
+void
+RePair::compressBlocks(int *sequence, size_t length, uint blocks, uint concurrent, const RePairOptions &options)
 {
-	int cmp = 0;
+	// Splitting the sequence after a '\0' (if there is one close to the
+	// expected end of the block)
+	vector<size_t> start(1, 0);
+	size_t window = (length/blocks)/8;
 
-	uint left = G->getField(2*rule);
-	if (left >= terminals)
+	for (uint b=1; b<blocks; b++)
 	{
-		cmp = expandRuleAndCompareString(left-terminals, str, pos);
-		if (cmp != 0) return cmp;
+		size_t nominal = max(start.back()+1, (size_t)(((uint64_t)length*b)/blocks));
+		size_t pos = nominal;
+		while ((pos < length) && (pos < nominal+window) && (sequence[pos-1] != 0)) pos++;
+		if ((pos < length) && (sequence[pos-1] != 0)) pos = nominal;
+		if (pos >= length) break;
+		start.push_back(pos);
 	}
-	else
+	start.push_back(length);
+	blocks = start.size()-1;
+
+	// Compressing the blocks
+	vector<IRePair> compressor(blocks);
+	vector<Tdiccarray*> dicc(blocks);
+	vector<size_t> alph(blocks), nrules(blocks);
+
+	for (uint first=0; first<blocks; first+=concurrent)
 	{
-		if ((uchar)left != str[*pos]) return (int)((uchar)left-str[*pos]);
-		(*pos)++;
+		vector<thread> workers;
+		uint last = min(blocks, first+concurrent);
+
+		for (uint b=first; b<last; b++)
+		{
+			compressor[b].setLimits(options.maxHeight, options.maxLength, options.minFreq);
+			workers.push_back(thread(&IRePair::compress, &compressor[b], sequence+start[b], start[b+1]-start[b], &alph[b], &nrules[b], &dicc[b]));
+		}
+		for (uint b=0; b<workers.size(); b++) workers[b].join();
 	}
 
-	uint right = G->getField((2*rule)+1);
-	if (right >= terminals)
+	terminals = 0;
+	for (uint b=0; b<blocks; b++)
+		if (alph[b] > terminals) terminals = alph[b];
+
+	// Merging the grammars: the rules of each block are renumbered (the
+	// rules only refer to the previous ones) and the repeated ones are
+	// stored once
+	vector<uint64_t> grammar;
+	unordered_map<uint64_t, uint64_t> merged;
+	size_t built = 0, symbols = 0, skipped = 0;
+	int height = 0;
+
+	for (uint b=0; b<blocks; b++)
 	{
-		cmp = expandRuleAndCompareString(right-terminals, str, pos);
-		if (cmp != 0) return cmp;
+		vector<uint64_t> id(nrules[b]);
+
+		for (size_t i=0; i<nrules[b]; i++)
+		{
+			Tpair pair = dicc[b]->rules[i].rule;
+			uint64_t left = ((size_t)pair.left < alph[b]) ? pair.left : terminals+id[pair.left-alph[b]];
+			uint64_t right = ((size_t)pair.right < alph[b]) ? pair.right : terminals+id[pair.right-alph[b]];
+			uint64_t key = (left << 32) | right;
+
+			unordered_map<uint64_t, uint64_t>::iterator it = merged.find(key);
+			if (it != merged.end()) id[i] = it->second;
+			else
+			{
+				id[i] = grammar.size()/2;
+				merged[key] = id[i];
+				grammar.push_back(left);
+				grammar.push_back(right);
+			}
+		}
+		Dictionary::destroyDicc(dicc[b]);
+
+		// The symbols are stored in ints
+		if (terminals+grammar.size()/2 > MAXSEQUENCE)
+		{
+			cerr << "[REPAIR] ERROR: the grammar of the blocks has more than " << MAXSEQUENCE << " symbols" << endl;
+			for (b++; b<blocks; b++) Dictionary::destroyDicc(dicc[b]);
+			return;
+		}
+
+		// Renumbering the symbols of the block (the pointers skipping
+		// the replaced positions become the lengths of the runs)
+		size_t i = start[b];
+		while (i < start[b+1])
+		{
+			if (sequence[i] < 0)
+			{
+				size_t next = start[b]-(sequence[i]+1);
+				sequence[i] = -(int)(next-i);
+				i = next;
+			}
+			else
+			{
+				if ((size_t)sequence[i] >= alph[b]) sequence[i] = terminals+id[sequence[i]-alph[b]];
+				i++;
+			}
+		}
+
+		built += nrules[b];
+		symbols += compressor[b].getLength();
+		skipped += compressor[b].getSkipped();
+		if (compressor[b].getHeight() > height) height = compressor[b].getHeight();
 	}
-	else
+
+	rules = grammar.size()/2;
+	G = new LogSequence(bits(rules+terminals), 2*rules);
+	for (size_t i=0; i<grammar.size(); i++) G->setField(i, grammar[i]);
+
+	cerr << "[REPAIR] " << blocks << " blocks, " << rules << " rules (" << built << " before merging)";
+	if (options.maxHeight || options.maxLength || options.minFreq) cerr << ", height " << height << ", " << symbols << " symbols in the sequence, " << skipped << " pairs not replaced";
+	cerr << endl;
+
+	if (options.hotRules > 0) selectHotRules(sequence, length, options.hotRules);
+}
+
+void
+RePair::buildSummaries()
+{
+	if (ruleLength != NULL) return;
+
+	ruleLength = new uint32_t[rules];
+	rulePrefix = new uint64_t[rules];
+	for (uint i=0; i<rules; i++) ruleLength[i] = 0;
+
+	// The rules only refer to previous ones, so each summary is
+	// usually computed from those already known
+	for (uint i=0; i<rules; i++) summarizeRule(i);
+}
+
+void
+RePair::summarizeRule(uint rule)
+{
+	if (ruleLength[rule] != 0) return;
+
+	uint64_t length[2], prefix[2];
+	uint symbol[2] = {(uint)G->getField(2*rule), (uint)G->getField((2*rule)+1)};
+
+	for (uint i=0; i<2; i++)
 	{
-		if ((uchar)right != str[*pos]) return (int)((uchar)right-str[*pos]);
-		(*pos)++;
+		if (symbol[i] >= terminals)
+		{
+			summarizeRule(symbol[i]-terminals);
+			length[i] = ruleLength[symbol[i]-terminals];
+			prefix[i] = rulePrefix[symbol[i]-terminals];
+		}
+		else
+		{
+			length[i] = 1;
+			prefix[i] = (uint64_t)(uchar)symbol[i] << 56;
+		}
 	}
 
-	return cmp;
+	ruleLength[rule] = length[0]+length[1];
+	rulePrefix[rule] = prefix[0];
+	if (length[0] < SUMMARY) rulePrefix[rule] |= prefix[1] >> (8*length[0]);
+}
+
+void
+RePair::selectHotRules(int *sequence, size_t length, uint limit)
+{
+	// Direct references to each rule, from the other rules and from the sequence
+	vector<uint64_t> references(rules, 0);
+	for (size_t i=0; i<2*rules; i++)
+	{
+		uint symbol = G->getField(i);
+		if (symbol >= terminals) references[symbol-terminals]++;
+	}
+
+	size_t i = 0;
+	while (i < length)
+	{
+		if (sequence[i] < 0) i = skipReplaced(sequence, i);
+		else
+		{
+			if ((uint)sequence[i] >= terminals) references[sequence[i]-terminals]++;
+			i++;
+		}
+	}
+
+	// The rules of two terminals are expanded as fast as copied
+	vector<pair<uint64_t, uint> > candidates;
+	for (uint i=0; i<rules; i++)
+		if ((G->getField(2*i) >= terminals) || (G->getField((2*i)+1) >= terminals))
+			candidates.push_back(make_pair(references[i], i));
+
+	size_t n = min((size_t)limit, candidates.size());
+	partial_sort(candidates.begin(), candidates.begin()+n, candidates.end(), greater<pair<uint64_t, uint> >());
+
+	hotCount = n;
+	hotRules = new uint32_t[n];
+	for (size_t i=0; i<n; i++) hotRules[i] = candidates[i].second;
+	sort(hotRules, hotRules+n);
+
+	buildHotCache();
+}
+
+void
+RePair::buildHotCache()
+{
+	// The expansions are obtained before any rule is marked as cached
+	hotOffset = new uint64_t[hotCount+1];
+	hotOffset[0] = 0;
+	for (uint i=0; i<hotCount; i++)
+	{
+		uint64_t len = 0;
+		RuleStack stack;
+		stack.push(hotRules[i]+terminals);
+		while (!stack.empty())
+		{
+			uint symbol = stack.pop();
+			if (symbol < terminals) { len++; continue; }
+			stack.push(G->getField((2*(symbol-terminals))+1));
+			stack.push(G->getField(2*(symbol-terminals)));
+		}
+		hotOffset[i+1] = hotOffset[i]+len;
+	}
+
+	hotText = new uchar[hotOffset[hotCount]+1];
+	for (uint i=0; i<hotCount; i++)
+		expandRule(hotRules[i], hotText+hotOffset[i]);
+
+	hotBits = new uint64_t[(rules+63)/64+1];
+	for (size_t i=0; i<(rules+63)/64+1; i++) hotBits[i] = 0;
+	for (uint i=0; i<hotCount; i++)
+		hotBits[hotRules[i]/64] |= (uint64_t)1 << (hotRules[i]%64);
+}
+
+uint
+RePair::expandRule(uint rule, uchar* str)
+{
+	uint pos = 0;
+	RuleStack stack;
+	stack.push(rule+terminals);
+
+	while (!stack.empty())
+	{
+		uint symbol = stack.pop();
+		if (symbol < terminals) { str[pos] = (uchar)symbol; pos++; continue; }
+
+		const uchar *text;
+		uint len = cachedRule(symbol-terminals, &text);
+		if (len > 0) { memcpy(str+pos, text, len); pos += len; continue; }
+
+		// The right symbol is expanded after the whole left one
+		stack.push(G->getField((2*(symbol-terminals))+1));
+		stack.push(G->getField(2*(symbol-terminals)));
+	}
+
+	return pos;
 }
 
 int
-RePair::extractStringAndCompareRP(uint id, uchar* str, uint strLen)
+RePair::expandRuleAndCompareString(uint rule, uchar *str, uint *pos)
+{
+	RuleStack stack;
+	stack.push(rule+terminals);
+
+	while (!stack.empty())
+	{
+		uint symbol = stack.pop();
+		if (symbol < terminals)
+		{
+			if ((uchar)symbol != str[*pos]) return (int)((uchar)symbol-str[*pos]);
+			(*pos)++;
+			continue;
+		}
+		uint current = symbol-terminals;
+
+		if (ruleLength != NULL)
+		{
+			// The first symbols are compared from the summary, so the rule
+			// is only expanded when they match and it is longer
+			uint known = (ruleLength[current] < SUMMARY) ? ruleLength[current] : SUMMARY;
+			for (uint i=0; i<known; i++)
+			{
+				uchar c = (uchar)(rulePrefix[current] >> (56-8*i));
+				if (c != str[*pos+i]) { *pos += i; return (int)(c-str[*pos]); }
+			}
+			if (ruleLength[current] <= SUMMARY) { *pos += known; continue; }
+		}
+
+		const uchar *text;
+		uint len = cachedRule(current, &text);
+		if (len > 0)
+		{
+			for (uint i=0; i<len; i++)
+			{
+				if (text[i] != str[*pos]) return (int)(text[i]-str[*pos]);
+				(*pos)++;
+			}
+			continue;
+		}
+
+		stack.push(G->getField((2*current)+1));
+		stack.push(G->getField(2*current));
+	}
+
+	return 0;
+}
+
+int
+RePair::extractStringAndCompareRP(size_t id, uchar* str, uint strLen)
 {
 	str[strLen] = maxchar;
 
@@ -144,11 +502,11 @@ RePair::extractStringAndCompareRP(uint id, uchar* str, uint strLen)
 }
 
 int
-RePair::extractStringAndCompareDAC(uint id, uchar* str, uint strLen)
+RePair::extractStringAndCompareDAC(size_t id, uchar* str, uint strLen)
 {
 	uint l = 0, pos = 0, next;
 	int cmp = 0;
-	while(id != (uint)-1)
+	while(id != DAC_VLS::END)
 	{
 		next = Cdac->access_next(l, &id);
 
@@ -173,44 +531,63 @@ RePair::extractStringAndCompareDAC(uint id, uchar* str, uint strLen)
 int
 RePair::expandRuleAndComparePrefixDAC(uint rule, uchar *str, uint *pos)
 {
-	int cmp = 0;
+	// As expandRuleAndCompareString, but the comparison succeeds when the
+	// prefix ends (which is checked before every symbol but the first one)
+	uint first = *pos;
+	RuleStack stack;
+	stack.push(rule+terminals);
 
-	uint left = G->getField(2*rule);
-	if (left >= terminals)
-	{
-		cmp = expandRuleAndComparePrefixDAC(left-terminals, str, pos);
-		if (cmp != 0) return cmp;
-	}
-	else
+	while (!stack.empty())
 	{
-		if ((uchar)left != str[*pos]) return (int)((uchar)left-str[*pos]);
-		(*pos)++;
-	}
+		uint symbol = stack.pop();
+		if (symbol < terminals)
+		{
+			if ((*pos != first) && (str[*pos] == '\0')) return 0;
+			if ((uchar)symbol != str[*pos]) return (int)((uchar)symbol-str[*pos]);
+			(*pos)++;
+			continue;
+		}
+		uint current = symbol-terminals;
 
-	if (str[*pos] == '\0') return cmp;
+		if (ruleLength != NULL)
+		{
+			uint known = (ruleLength[current] < SUMMARY) ? ruleLength[current] : SUMMARY;
+			for (uint i=0; i<known; i++)
+			{
+				if ((*pos+i != first) && (str[*pos+i] == '\0')) { *pos += i; return 0; }
+				uchar c = (uchar)(rulePrefix[current] >> (56-8*i));
+				if (c != str[*pos+i]) { *pos += i; return (int)(c-str[*pos]); }
+			}
+			if (ruleLength[current] <= SUMMARY) { *pos += known; continue; }
+		}
 
-	uint right = G->getField((2*rule)+1);
-	if (right >= terminals)
-	{
-		cmp = expandRuleAndComparePrefixDAC(right-terminals, str, pos);
-		if (cmp != 0) return cmp;
-	}
-	else
-	{
-		if ((uchar)right != str[*pos]) return (int)((uchar)right-str[*pos]);
-		(*pos)++;
+		const uchar *text;
+		uint len = cachedRule(current, &text);
+		if (len > 0)
+		{
+			for (uint i=0; i<len; i++)
+			{
+				if ((*pos != first) && (str[*pos] == '\0')) return 0;
+				if (text[i] != str[*pos]) return (int)(text[i]-str[*pos]);
+				(*pos)++;
+			}
+			continue;
+		}
+
+		stack.push(G->getField((2*current)+1));
+		stack.push(G->getField(2*current));
 	}
 
-	return cmp;
+	return 0;
 }
 
 int
-RePair::extractPrefixAndCompareDAC(uint id, uchar* prefix, uint prefixLen)
+RePair::extractPrefixAndCompareDAC(size_t id, uchar* prefix, uint prefixLen)
 {
 	uint l = 0, pos = 0, next;
 	int cmp = 0;
 
-	while(id != (uint)-1)
+	while(id != DAC_VLS::END)
 	{
 		next = Cdac->access_next(l, &id);
 
@@ -242,10 +619,16 @@ RePair::save(ofstream &out,  uint encoding)
 	saveValue<uint64_t>(out, rules);
 	G->save(out);
 
-	saveValue<uint32_t>(out, encoding);
+	saveValue<uint32_t>(out, (hotCount > 0) ? (encoding | HOTRULES) : encoding);
 
 	if ((encoding == HASHRPDAC) || (encoding == RPDAC)) Cdac->save(out);
 	else Cls->save(out);
+
+	if (hotCount > 0)
+	{
+		saveValue<uint32_t>(out, hotCount);
+		saveValue<uint32_t>(out, hotRules, hotCount);
+	}
 }
 
 void
@@ -258,7 +641,7 @@ RePair::save(ofstream &out)
 }
 
 RePair*
-RePair::load(ifstream &in)
+RePair::load(ifstream &in, const RePairOptions &options)
 {
 	RePair *dict = new RePair();
 
@@ -266,17 +649,27 @@ RePair::load(ifstream &in)
 	dict->terminals = loadValue<uint64_t>(in);
 	dict->rules = loadValue<uint64_t>(in);
 	dict->G = new LogSequence(in);
+	if (options.summaries) dict->buildSummaries();
 
 	uint encoding = loadValue<uint32_t>(in);
+	bool hot = (encoding & HOTRULES) != 0;
+	encoding &= ~HOTRULES;
 
 	if ((encoding == HASHRPDAC) || (encoding == RPDAC)) dict->Cdac = DAC_VLS::load(in);
 	else dict->Cls = new LogSequence(in);
 
+	if (hot)
+	{
+		dict->hotCount = loadValue<uint32_t>(in);
+		dict->hotRules = loadValue<uint32_t>(in, dict->hotCount);
+		dict->buildHotCache();
+	}
+
 	return dict;
 }
 
 RePair*
-RePair::loadNoSeq(ifstream &in)
+RePair::loadNoSeq(ifstream &in, const RePairOptions &options)
 {
 	RePair *dict = new RePair();
 
@@ -284,6 +677,7 @@ RePair::loadNoSeq(ifstream &in)
 	dict->terminals = loadValue<uint64_t>(in);
 	dict->rules = loadValue<uint64_t>(in);
 	dict->G = new LogSequence(in);
+	if (options.summaries) dict->buildSummaries();
 
 	return dict;
 }
@@ -292,9 +686,13 @@ RePair::loadNoSeq(ifstream &in)
 size_t
 RePair::getSize()
 {
-	if (Cdac != NULL) return G->getSize()+Cdac->getSize()+sizeof(RePair);
-	if (Cls != NULL) return G->getSize()+Cls->getSize()+sizeof(RePair);
-	return G->getSize()+sizeof(RePair);
+	size_t size = G->getSize()+sizeof(RePair);
+	if (ruleLength != NULL) size += rules*(sizeof(uint32_t)+sizeof(uint64_t));
+	if (hotText != NULL) size += hotCount*(sizeof(uint32_t)+sizeof(uint64_t))+hotOffset[hotCount]+((rules+63)/64+1)*sizeof(uint64_t);
+
+	if (Cdac != NULL) return size+Cdac->getSize();
+	if (Cls != NULL) return size+Cls->getSize();
+	return size;
 }
 
 RePair::~RePair()
@@ -302,4 +700,10 @@ RePair::~RePair()
 	if (G != NULL) delete G;
 	if (Cls != NULL) delete Cls;
 	if (Cdac != NULL) delete Cdac;
+	if (ruleLength != NULL) delete [] ruleLength;
+	if (rulePrefix != NULL) delete [] rulePrefix;
+	if (hotRules != NULL) delete [] hotRules;
+	if (hotBits != NULL) delete [] hotBits;
+	if (hotOffset != NULL) delete [] hotOffset;
+	if (hotText != NULL) delete [] hotText;
 }
@@ -38,6 +38,100 @@ using namespace cds_utils;
 #include "../utils/DAC_VLS.h"
 #include "../utils/Utils.h"
 
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+/** Stack of the symbols pending in the expansion of a rule. It is kept in
+    the program stack unless the grammar is deeper than its capacity.
+*/
+class RuleStack
+{
+	public:
+		RuleStack() { symbols = local; size = 0; capacity = CAPACITY; }
+
+		bool empty() { return size == 0; }
+
+		void push(uint symbol)
+		{
+			if (size == capacity)
+			{
+				uint *grown = new uint[2*capacity];
+				memcpy(grown, symbols, size*sizeof(uint));
+				if (symbols != local) delete [] symbols;
+				symbols = grown;
+				capacity *= 2;
+			}
+			symbols[size++] = symbol;
+		}
+
+		uint pop() { return symbols[--size]; }
+
+		~RuleStack() { if (symbols != local) delete [] symbols; }
+
+	protected:
+		static const uint CAPACITY = 64;
+
+		uint local[CAPACITY];	// The stack while it fits
+		uint *symbols;		// The stack
+		uint size;		// Number of symbols pending
+		uint capacity;		// Capacity of the stack
+};
+
+
+/** Options of the RePair encodings built (and loaded).
+*/
+struct RePairOptions
+{
+	/** Builds (and loads) the rule summaries: the summary of a rule (its
+	    expanded length and its first RePair::SUMMARY symbols) uses 12
+	    bytes, and lets the comparisons decide most rules without
+	    expanding them (false by default). */
+	bool summaries;
+
+	/** Number of rules whose expansion is cached (none by default). The
+	    most referenced rules (from the sequence and from other rules)
+	    are chosen when the encoding is built, their list is stored with
+	    it, and they are expanded when it is loaded, so expanding them
+	    copies their bytes instead of walking G. */
+	uint hotRules;
+
+	/** Bounds of the grammar (0 for no bound, the default). The pairs
+	    whose rule would be higher than maxHeight, or expand to more than
+	    maxLength symbols, are not replaced, so expanding any symbol of
+	    the sequence takes a bounded number of steps; and the compression
+	    stops when the most frequent pair has less than minFreq
+	    occurrences (a rule saves minFreq-2 symbols). The sequence gets
+	    longer, so the dictionary uses more space. The resulting grammar
+	    is reported to stderr. */
+	uint maxHeight, maxLength, minFreq;
+
+	/** Number of threads compressing the sequence (1 by default). The
+	    sequence is split in blocks (after a '\0', since the pairs
+	    including it are never replaced), which are compressed in
+	    parallel, and their grammars are merged (the rules built by
+	    several blocks are stored once). The grammar gets larger than
+	    compressing the whole sequence, as the blocks do not share their
+	    pairs. */
+	uint threads;
+
+	/** Memory budget of the compression (0, the default, for no budget).
+	    The sequence is compressed in place, in blocks short enough for
+	    the structures of RePair (about 16 bytes per symbol) to fit in
+	    the budget besides the sequence, compressing fewer blocks at the
+	    same time if needed. The budget only covers RePair: the caller's
+	    own allocations (e.g. the strings being indexed, another structure
+	    built at the same time, or the dictionary built from the grammar)
+	    are not accounted for. The estimated peak of the compression and
+	    the resident peak of the current phase (see MemoryUsage, which is
+	    not reset) are reported to stderr. */
+	size_t memoryBudget;
+
+	RePairOptions() : summaries(false), hotRules(0), maxHeight(0), maxLength(0), minFreq(0), threads(1), memoryBudget(0) {}
+};
+
 
 class RePair
 {
@@ -47,12 +141,33 @@ class RePair
 		RePair();
 
 		/** Constructor performing RePair compression over an integer sequence.
+		 *  A sequence longer than MAXSEQUENCE is compressed in blocks. The
+		 *  sequence is replaced by the symbols of the compressed one and,
+		 *  in the first position of each run of replaced positions, minus
+		 *  the length of the run (see skipReplaced). It is not compressed
+		 *  (see good) if it does not fit in the memory budget.
 		 *  @param sequence: the sequence to be compressed.
 		 *  @param length: the sequence length.
 		 *  @param maxchar: the highest char used in the sequence.
+		 *  @param options: the options of the compression.
+		 */
+
+		RePair(int *sequence, size_t length, uchar maxchar, const RePairOptions &options=RePairOptions());
+
+		/** Checks if the sequence was compressed.
+		 * @returns false if it could not be compressed.
 		 */
+		bool good() { return G != NULL; }
+
+		static const size_t MAXSEQUENCE = 0x7FFFFFFF;	//! Longest block compressed by IRePair (it stores its positions in ints)
 
-		RePair(int *sequence, uint length, uchar maxchar);
+		/** Position of the next symbol of a compressed sequence, from
+		    the first position of a run of replaced positions.
+		    @param sequence: the compressed sequence.
+		    @param pos: the position (sequence[pos] < 0).
+		    @returns the position after the run.
+		*/
+		static size_t skipReplaced(int *sequence, size_t pos) { return pos+(size_t)(-(int64_t)sequence[pos]); }
 
 		/** Returns the RePair representation size.
 		 * @returns representation size.
@@ -75,15 +190,33 @@ class RePair
 
 		/** Loads a RePair encoding from an ifstream.
 		    @param in: the ifstream.
+		    @param options: the options (only the summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static RePair *load(ifstream &in);
+		static RePair *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Loads a RePair encoding (without sequence) from an ifstream.
 		    @param in: the ifstream.
+		    @param options: the options (only the summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static RePair* loadNoSeq(ifstream &in);
+		static RePair* loadNoSeq(ifstream &in, const RePairOptions &options=RePairOptions());
+
+		/** Prefetches the pair of a rule in G (to expand it later).
+		    @param rule: the rule.
+		*/
+		void prefetchRule(uint rule) { G->prefetch(2*(size_t)rule); }
+
+		/** Builds the rule summaries (if they were not built). */
+		void buildSummaries();
+
+		/** Checks if a sequence can be compressed within the memory
+		    budget, reporting the budget required otherwise.
+		    @param length: length of the sequence.
+		    @param options: the options of the compression.
+		    @returns true if it fits (or there is no budget).
+		*/
+		static bool fitsBudget(size_t length, const RePairOptions &options);
 
 		// Generic destructor
 		~RePair();
@@ -97,7 +230,75 @@ class RePair
 		uint64_t rules;			//! Number of rules in the grammar G
 		LogSequence *G;			//! RePair grammar (using 2*log(terminals+rules) bits per rule).
 
-		/** Expands the required rule into str.
+		static const uint SUMMARY = 8;	//! Symbols of each rule stored in its summary
+		uint32_t *ruleLength;		//! Expanded length of each rule (NULL without summaries)
+		uint64_t *rulePrefix;		//! First SUMMARY symbols of each rule, packed from the highest byte
+
+		/** Computes the summary of a rule (and those of its subrules).
+		    @param rule: the rule.
+		*/
+		void summarizeRule(uint rule);
+
+		static const uint32_t HOTRULES = 0x80000000;	//! Flag of the encoding: the hot rules are stored
+		static const uint MINBLOCK = 1<<20;	//! Minimum length of a block compressed in parallel
+		static const uint MINBUDGETBLOCK = 1<<16;	//! Minimum length of a block compressed within a budget
+
+		/** Computes the blocks needed to compress a sequence within the
+		    memory budget.
+		    @param length: length of the sequence.
+		    @param budget: the memory budget.
+		    @param blocks: number of blocks (increased if needed).
+		    @param concurrent: blocks compressed at the same time
+		      (decreased if needed).
+		    @returns false if the budget is too small.
+		*/
+		static bool planBudget(size_t length, size_t budget, uint *blocks, uint *concurrent);
+
+		/** Compresses a sequence in blocks (in parallel) and merges
+		    their grammars into G. The sequence is replaced by the
+		    symbols and the runs of replaced positions (see
+		    skipReplaced).
+		    @param sequence: the sequence.
+		    @param length: its length.
+		    @param blocks: number of blocks.
+		    @param concurrent: blocks compressed at the same time.
+		    @param options: the options of the compression.
+		*/
+		void compressBlocks(int *sequence, size_t length, uint blocks, uint concurrent, const RePairOptions &options);
+		uint32_t hotCount;		//! Number of hot rules
+		uint32_t *hotRules;		//! The hot rules (sorted)
+		uint64_t *hotBits;		//! Bitmap of the hot rules
+		uint64_t *hotOffset;		//! Position of the expansion of each hot rule in hotText
+		uchar *hotText;			//! Expansions of the hot rules
+
+		/** Chooses the most referenced rules and caches their
+		    expansions.
+		    @param sequence: the compressed sequence (with the runs of
+		      replaced positions).
+		    @param length: its length.
+		    @param limit: number of rules chosen.
+		*/
+		void selectHotRules(int *sequence, size_t length, uint limit);
+
+		/** Expands the hot rules into the cache. */
+		void buildHotCache();
+
+		/** Retrieves the cached expansion of a rule.
+		    @param rule: the rule.
+		    @param text: pointer to its expansion.
+		    @returns the expansion length (0 if it is not cached).
+		*/
+		uint cachedRule(uint rule, const uchar **text)
+		{
+			if ((hotBits == NULL) || !((hotBits[rule/64] >> (rule%64)) & 1)) return 0;
+
+			size_t i = lower_bound(hotRules, hotRules+hotCount, rule)-hotRules;
+			*text = hotText+hotOffset[i];
+			return hotOffset[i+1]-hotOffset[i];
+		}
+
+		/** Expands the required rule into str (iteratively, copying the
+		    cached expansions of the hot rules).
 		    @param rule: the rule to be extracted.
 		    @param str: the expanded string.
 		    @returns the string length.
@@ -125,12 +326,12 @@ class RePair
 		    @param strLen: the string length.
 		    @returns the comparison result.
 		*/
-		int extractStringAndCompareRP(uint id, uchar* str, uint strLen);
+		int extractStringAndCompareRP(size_t id, uchar* str, uint strLen);
 
 		/** Similar than "extractStringAndCompareRP", extracts the string from
 		 *  a DAC encoding.
 		 */
-		int extractStringAndCompareDAC(uint id, uchar* str, uint strLen);
+		int extractStringAndCompareDAC(size_t id, uchar* str, uint strLen);
 
 		/** Expands the required rule and compares it with respect to
 		    the given prefix 'prefix'. Returns an integer value containing
@@ -154,7 +355,7 @@ class RePair
 		    @param strLen: prefix length.
 		    @returns the comparison result.
 		*/
-		int extractPrefixAndCompareDAC(uint id, uchar* prefix, uint prefixLen);
+		int extractPrefixAndCompareDAC(size_t id, uchar* prefix, uint prefixLen);
 
 		friend class StringDictionaryHASHRPF;
 		friend class StringDictionaryHASHRPDAC;
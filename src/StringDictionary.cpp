@@ -25,28 +25,33 @@
  *   Miguel A. Martinez-Prieto:	migumar2@infor.uva.es
  */
 
+#include <algorithm>
+#include <thread>
+#include <string.h>
 #include "StringDictionary.h"
 
 StringDictionary*
-StringDictionary::load(ifstream & fp)
+StringDictionary::load(ifstream & fp, const RePairOptions &options)
 {
 	size_t r = loadValue<uint32_t>(fp);
 
+	if (r == MappedFile::MAGIC) return loadLayout(fp, NULL, options, true);
+
 	switch(r)
 	{
 		case HASHHF:		return StringDictionaryHASHHF::load(fp);
 		case HASHUFFDAC:	return StringDictionaryHASHUFFDAC::load(fp);
-		case HASHRPF:		return StringDictionaryHASHRPF::load(fp);
-		case HASHRPDAC:		return StringDictionaryHASHRPDAC::load(fp);
+		case HASHRPF:		return StringDictionaryHASHRPF::load(fp, options);
+		case HASHRPDAC:		return StringDictionaryHASHRPDAC::load(fp, HASHRPDAC, options);
 
 		case PFC:		return StringDictionaryPFC::load(fp);
-		case RPFC:		return StringDictionaryRPFC::load(fp);
+		case RPFC:		return StringDictionaryRPFC::load(fp, options);
 
 		case HTFC:		return StringDictionaryHTFC::load(fp);
 		case HHTFC:		return StringDictionaryHHTFC::load(fp);
-		case RPHTFC:		return StringDictionaryRPHTFC::load(fp);
+		case RPHTFC:		return StringDictionaryRPHTFC::load(fp, options);
 
-		case RPDAC:		return StringDictionaryRPDAC::load(fp);
+		case RPDAC:		return StringDictionaryRPDAC::load(fp, options);
 		case FMINDEX:		return StringDictionaryFMINDEX::load(fp);
 		case DXBW:		return StringDictionaryXBW::load(fp);
 	}
@@ -54,6 +59,267 @@ StringDictionary::load(ifstream & fp)
 	return NULL;
 }
 
+StringDictionary*
+StringDictionary::create(uint32_t type)
+{
+	switch(type)
+	{
+		case HASHHF:		return new StringDictionaryHASHHF();
+		case HASHUFFDAC:	return new StringDictionaryHASHUFFDAC();
+		case HASHRPF:		return new StringDictionaryHASHRPF();
+		case HASHRPDAC:		return new StringDictionaryHASHRPDAC();
+
+		case PFC:		return new StringDictionaryPFC();
+		case RPFC:		return new StringDictionaryRPFC();
+
+		case HTFC:		return new StringDictionaryHTFC();
+		case HHTFC:		return new StringDictionaryHHTFC();
+		case RPHTFC:		return new StringDictionaryRPHTFC();
+
+		case RPDAC:		return new StringDictionaryRPDAC();
+		case FMINDEX:		return new StringDictionaryFMINDEX();
+		case DXBW:		return new StringDictionaryXBW();
+	}
+
+	return NULL;
+}
+
+StringDictionary*
+StringDictionary::loadLayout(ifstream &in, const char *path, const RePairOptions &options, bool verify)
+{
+	StringDictionary *dict = NULL;
+	uint32_t version = MappedFile::readHeader(in);
+	SectionTable table;
+
+	if (version == 1) dict = load(in, options); //the dictionary follows the header
+	else if ((version == 2) && table.read(in) && table.open(in, 0, verify))
+	{
+		if (table.size() == 1) dict = load(in, options); //the whole dictionary is one section
+		else
+		{
+			dict = create(loadValue<uint32_t>(in));
+			bool *loaded = new bool[table.size()];
+			loaded[0] = (dict != NULL) && (dict->numSections() == table.size()) && dict->loadSection(0, in, options);
+
+			//the other sections are independent: with the path each one is loaded by a thread with its own stream
+			vector<thread> threads;
+			for (uint s=1; s<table.size(); s++)
+			{
+				loaded[s] = false;
+				if (!loaded[0]) continue;
+				if (path != NULL) threads.push_back(thread(loadSectionThread, dict, &table, s, path, &in, &options, verify, &loaded[s]));
+				else loaded[s] = table.open(in, s, verify) && dict->loadSection(s, in, options);
+			}
+			for (uint t=0; t<threads.size(); t++)
+				threads[t].join();
+
+			for (uint s=0; s<table.size(); s++)
+			{
+				if (loaded[s]) continue;
+				cerr << "The section " << s << " of the dictionary cannot be loaded" << endl;
+				if (dict != NULL) delete dict;
+				dict = NULL;
+				break;
+			}
+			delete [] loaded;
+		}
+	}
+
+	MappedFile::detach(in);
+	return dict;
+}
+
+void
+StringDictionary::loadSectionThread(StringDictionary *dict, SectionTable *table, uint section, const char *path, ifstream *from, const RePairOptions *options, bool verify, bool *loaded)
+{
+	ifstream in(path, ios::binary);
+	MappedFile::follow(in, *from);
+	*loaded = table->open(in, section, verify) && dict->loadSection(section, in, *options);
+	MappedFile::detach(in);
+}
+
+void
+StringDictionary::saveMapped(ofstream &out)
+{
+	if (!good())
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+
+	uint sections = numSections();
+	SectionTable table(sections);
+
+	MappedFile::writeHeader(out);
+	table.reserve(out);
+	for (uint s=0; s<sections; s++)
+	{
+		table.begin(out, s);
+		saveSection(s, out);
+		table.end(out, s);
+	}
+	table.write(out);
+	MappedFile::detach(out);
+}
+
+StringDictionary*
+StringDictionary::loadMapped(const char *path, const RePairOptions &options, bool verify)
+{
+	MappedFile *file = new MappedFile(path);
+	if (!file->good())
+	{
+		delete file;
+		return NULL;
+	}
+
+	ifstream in(path, ios::binary);
+	MappedFile::attach(in, file);
+	StringDictionary *dict;
+	if (loadValue<uint32_t>(in) == MappedFile::MAGIC) dict = loadLayout(in, path, options, verify);
+	else
+	{
+		in.seekg(0);
+		dict = load(in, options);
+	}
+	MappedFile::detach(in);
+	in.close();
+
+	if (dict == NULL) delete file;
+	else dict->mapping = file;
+	return dict;
+}
+
+uint
+StringDictionary::numSections()
+{
+	return 1;
+}
+
+void
+StringDictionary::saveSection(uint section, ofstream &out)
+{
+	save(out);
+}
+
+bool
+StringDictionary::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	return false;
+}
+
+StringDictionary::~StringDictionary()
+{
+	//the arrays pointing into the mapping are left by the destructors of the subclasses
+	if (mapping != NULL) delete mapping;
+}
+
+void
+StringDictionary::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	size_t capacity = extractCapacity();
+	uchar *buffer = new uchar[capacity];
+
+	// The IDs are prefetched PREFETCH positions in advance (in two stages)
+	for (uint i=0; (i<2*PREFETCH) && (i<n); i++)
+		if ((ids[order[i]] > 0) && (ids[order[i]] <= elements)) prefetch(ids[order[i]], 0);
+	for (uint i=0; (i<PREFETCH) && (i<n); i++)
+		if ((ids[order[i]] > 0) && (ids[order[i]] <= elements)) prefetch(ids[order[i]], 1);
+
+	for (uint i=0; i<n; i++)
+	{
+		if (i+2*PREFETCH < n)
+		{
+			size_t next = ids[order[i+2*PREFETCH]];
+			if ((next > 0) && (next <= elements)) prefetch(next, 0);
+		}
+
+		if (i+PREFETCH < n)
+		{
+			size_t next = ids[order[i+PREFETCH]];
+			if ((next > 0) && (next <= elements)) prefetch(next, 1);
+		}
+
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements)) callback(order[i], NULL, 0, data);
+		else
+		{
+			uint strLen = extractInto(id, buffer, capacity);
+			callback(order[i], buffer, strLen, data);
+		}
+	}
+
+	delete [] buffer;
+	delete [] order;
+}
+
+struct BatchStrings
+{
+	uchar **strings;
+	uint *strLens;
+};
+
+static void
+storeString(size_t index, uchar *str, uint strLen, void *data)
+{
+	BatchStrings *batch = (BatchStrings*)data;
+
+	if (str == NULL) batch->strings[index] = NULL;
+	else
+	{
+		batch->strings[index] = new uchar[strLen+1];
+		memcpy(batch->strings[index], str, strLen);
+		batch->strings[index][strLen] = '\0';
+	}
+	batch->strLens[index] = strLen;
+}
+
+void
+StringDictionary::extractBatch(size_t *ids, uint n, uchar **strings, uint *strLens)
+{
+	BatchStrings batch = {strings, strLens};
+	extractBatch(ids, n, storeString, &batch);
+}
+
+uint
+StringDictionary::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	uint strLen;
+	uchar *str = extract(id, &strLen);
+	if (str == NULL) return 0;
+
+	if (strLen < cap)
+	{
+		memcpy(buf, str, strLen);
+		buf[strLen] = '\0';
+	}
+	delete [] str;
+	return strLen;
+}
+
+size_t
+StringDictionary::extractCapacity()
+{
+	return maxlength+1;
+}
+
+struct BatchOrder
+{
+	size_t *ids;
+	BatchOrder(size_t *_ids) : ids(_ids) {}
+	bool operator()(uint i, uint j) { return ids[i] < ids[j]; }
+};
+
+uint*
+StringDictionary::sortBatch(size_t *ids, uint n)
+{
+	uint *order = new uint[n];
+	for (uint i=0; i<n; i++) order[i] = i;
+	stable_sort(order, order+n, BatchOrder(ids));
+	return order;
+}
+
 uint
 StringDictionary::maxLength()
 {
@@ -36,6 +36,18 @@ using namespace cds_utils;
 #include "iterators/IteratorDictID.h"
 #include "iterators/IteratorDictString.h"
 #include "utils/Utils.h"
+#include "utils/MappedFile.h"
+#include "utils/SectionTable.h"
+#include "RePair/RePair.h"
+
+/** Function receiving each string of a batch extraction.
+    @param index: position of the ID in the batch.
+    @param str: the string (NULL if the ID is not in the dictionary),
+      only valid during the call.
+    @param strLen: the string length.
+    @param data: user data given to extractBatch.
+*/
+typedef void (*ExtractCallback)(size_t index, uchar *str, uint strLen, void *data);
 
 
 class StringDictionary
@@ -46,7 +58,7 @@ class StringDictionary
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the dictionary).
 		*/
-		virtual uint locate(uchar *str, uint strLen)=0;
+		virtual size_t locate(uchar *str, uint strLen)=0;
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -56,6 +68,60 @@ class StringDictionary
 		*/
 		virtual uchar* extract(size_t id, uint *strLen)=0;
 
+		/** Decodes the strings associated with a batch of IDs, visiting
+		    the IDs in increasing order. The bucketed dictionaries decode
+		    each bucket once for all its IDs; by default, each ID is
+		    extracted (with extractInto) in a single buffer, so nothing
+		    is allocated per ID, and the data of the next IDs is
+		    prefetched (see prefetch) while each one is decoded.
+		    @param ids: the IDs to be extracted.
+		    @param n: number of IDs.
+		    @param callback: function called for each ID with its string,
+		      which is only valid during the call.
+		    @param data: user data given to the callback.
+		*/
+		virtual void extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data);
+
+		/** Obtains the strings associated with a batch of IDs (with the
+		    callback extractBatch).
+		    @param ids: the IDs to be extracted.
+		    @param n: number of IDs.
+		    @param strings: array (of n positions) for the strings, in the
+		      order of the IDs (NULL for the IDs not in the dictionary).
+		    @param strLens: array (of n positions) for their lengths.
+		*/
+		void extractBatch(size_t *ids, uint n, uchar **strings, uint *strLens);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer given by the caller. The string is decoded in place
+		    if the buffer has (at least) extractCapacity() bytes;
+		    otherwise it is extracted apart and copied if it fits (by
+		    default, extract is always used).
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary). The buffer contains the '\0'-terminated
+		      string only if the length is lower than cap.
+		*/
+		virtual uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		virtual size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID. The default
+		    extractBatch calls it twice for each ID, some IDs in
+		    advance: stage 0 (farther) brings the structures locating
+		    the string, and stage 1 the string itself (reading the
+		    former, already cached). Nothing is done by default.
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		virtual void prefetch(size_t id, uint stage) {}
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -76,7 +142,7 @@ class StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		virtual uint locateRank(uint rank)=0;
+		virtual size_t locateRank(size_t rank)=0;
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -99,7 +165,7 @@ class StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		virtual uchar* extractRank(uint rank, uint *strLen)=0;
+		virtual uchar* extractRank(size_t rank, uint *strLen)=0;
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -123,6 +189,14 @@ class StringDictionary
 		*/
 		size_t numElements();
 
+		/** Checks if the dictionary was built: the construction fails
+		    (reporting it to stderr) if the strings cannot be compressed.
+		    A dictionary that was not built is empty: it locates and
+		    extracts nothing, and it cannot be saved.
+		    @returns false if it could not be built.
+		*/
+		virtual bool good() { return true; }
+
 		/** Stores the dictionary into an ofstream.
 		    @param out: the oftstream.
 		*/
@@ -130,18 +204,102 @@ class StringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in);
+		static StringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
+
+		/** Stores the dictionary into an ofstream in the mapped layout
+		    (a header, a directory with the offset, length and checksum
+		    of each section, and the arrays aligned), so it can be loaded
+		    with loadMapped. It is also read by load, which checks the
+		    checksums.
+		    @param out: the oftstream.
+		*/
+		void saveMapped(ofstream &out);
+
+		/** Loads a dictionary mapping its file in memory: the arrays of
+		    the sequences and strings point into the mapping (shared by
+		    all the processes mapping the file) instead of being read.
+		    The sections are loaded in parallel. A file without the
+		    mapped layout is read as by load.
+		    @param path: the file.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @param verify: true to check the checksums of the sections
+		      (which reads every page of the file); otherwise only their
+		      bounds are checked.
+		    @returns the loaded dictionary (NULL if it cannot be loaded).
+		*/
+		static StringDictionary *loadMapped(const char *path, const RePairOptions &options=RePairOptions(), bool verify=false);
 
 		/** Generic destructor. */
-		virtual ~StringDictionary() {};
+		virtual ~StringDictionary();
 
 
 	protected:
+		StringDictionary() : mapping(NULL) {}
+
 		uint32_t type;      //! Dictionary type.
 		uint64_t elements;  //! Number of strings in the dictionary.
 		uint32_t maxlength; //! Length of the largest string in the dictionary.
+		MappedFile *mapping; //! Mapping of the file it was loaded from (NULL if it was read).
+
+		static const uint PREFETCH = 8; //! Distance (in IDs) of the prefetching in extractBatch.
+
+		/** Sorts the positions of a batch by their IDs.
+		    @param ids: the IDs.
+		    @param n: number of IDs.
+		    @returns the positions of the batch in increasing order of ID.
+		*/
+		static uint* sortBatch(size_t *ids, uint n);
+
+		/** Retrieves the number of sections of the dictionary in the
+		    mapped layout: independent components, which are loaded in
+		    parallel. By default, the whole dictionary is one section.
+		    @returns the number of sections.
+		*/
+		virtual uint numSections();
+
+		/** Stores a section of the dictionary (save stores all of them,
+		    so the first one starts with the type).
+		    @param section: the section.
+		    @param out: the oftstream.
+		*/
+		virtual void saveSection(uint section, ofstream &out);
+
+		/** Loads a section into the dictionary (the type of the first
+		    one has been read).
+		    @param section: the section.
+		    @param in: the ifstream, at the start of the section.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @returns false if it cannot be loaded.
+		*/
+		virtual bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
+		/** Creates an empty dictionary of a type, whose sections are
+		    loaded next.
+		    @param type: the type.
+		    @returns the dictionary (NULL if the type is not valid).
+		*/
+		static StringDictionary *create(uint32_t type);
+
+		/** Loads a dictionary in the mapped layout (after its magic
+		    number).
+		    @param in: the ifstream.
+		    @param path: the file, so the sections are loaded in parallel
+		      with a stream each (NULL to load them with in).
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
+		    @param verify: true to check the checksums of the sections.
+		    @returns the loaded dictionary (NULL if error).
+		*/
+		static StringDictionary *loadLayout(ifstream &in, const char *path, const RePairOptions &options, bool verify);
+
+		//loads a section (verifying it if requested) with its own stream (run by the threads of loadLayout)
+		static void loadSectionThread(StringDictionary *dict, SectionTable *table, uint section, const char *path, ifstream *from, const RePairOptions *options, bool verify, bool *loaded);
 };
 
 #include "StringDictionaryHASHHF.h"
@@ -53,7 +53,7 @@ StringDictionaryFMINDEX::StringDictionaryFMINDEX(
 	if(BWTsampling > 0)
 	{
 		bitmap = new uint[(len+1+W)/W];
-		for(uint i=0; i<(len+1+W)/W; i++)
+		for(size_t i=0; i<(len+1+W)/W; i++)
 			bitmap[i]=0;
 		bitset(bitmap, 0);
 	}
@@ -105,11 +105,11 @@ StringDictionaryFMINDEX::StringDictionaryFMINDEX(
 	delete [] text;
 }
 
-uint
+size_t
 StringDictionaryFMINDEX::locate(uchar *str, uint strLen)
 {
 	uchar *n_s = new uchar[strLen+2];
-	uint o;
+	size_t o;
 	n_s[0] = '\1';
 	for(size_t i=1; i<=strLen; i++) n_s[i] = str[i-1];
 	n_s[strLen+1] = '\1';
@@ -140,6 +140,30 @@ StringDictionaryFMINDEX::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryFMINDEX::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	uint strLen = 0;
+	if ((id > 0) && (id <= elements))
+	{
+		size_t i;
+
+		if (id == elements) i=2;
+		else i=id+3;
+
+		fm_index->extract_id(i, buf, &strLen, maxlength);
+	}
+	return strLen;
+}
+
+size_t
+StringDictionaryFMINDEX::extractCapacity()
+{
+	return maxlength+2;
+}
+
 IteratorDictID*
 StringDictionaryFMINDEX::locatePrefix(uchar *str, uint strLen)
 {
@@ -148,7 +172,7 @@ StringDictionaryFMINDEX::locatePrefix(uchar *str, uint strLen)
 	strncpy((char*)&(prefix[1]), (char*)str, strLen+1);
 
 	size_t left, right;
-	uint num_occ = fm_index->locateP(prefix, (uint)(strLen+1), &left, &right, elements);
+	size_t num_occ = fm_index->locateP(prefix, (uint)(strLen+1), &left, &right, elements);
 	delete [] prefix;
 
 	if (num_occ > 0) return new IteratorDictIDContiguous(left, right);
@@ -163,7 +187,7 @@ StringDictionaryFMINDEX::locateSubstr(uchar *str, uint strLen)
 		return NULL;
 	}
 
-	size_t* occs; uint num_occ;
+	size_t* occs; size_t num_occ;
 	num_occ = fm_index->locate(str, (uint)strLen, &occs);
 
 	if (num_occ > 0)
@@ -176,8 +200,8 @@ StringDictionaryFMINDEX::locateSubstr(uchar *str, uint strLen)
 	else return new IteratorDictIDContiguous(NORESULT, NORESULT);
 }
 
-uint
-StringDictionaryFMINDEX::locateRank(uint rank)
+size_t
+StringDictionaryFMINDEX::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -190,7 +214,7 @@ StringDictionaryFMINDEX::extractPrefix(uchar *str, uint strLen)
 	strncpy((char*)&(prefix[1]), (char*)str, strLen+1);
 
 	size_t left, right;
-	uint num_occ = fm_index->locateP(prefix, (uint)(strLen+1), &left, &right, elements);
+	size_t num_occ = fm_index->locateP(prefix, (uint)(strLen+1), &left, &right, elements);
 	delete [] prefix;
 
 	if (num_occ > 0) return new IteratorDictStringFMINDEX(fm_index, left, right-left+1, elements, maxlength);
@@ -206,7 +230,7 @@ StringDictionaryFMINDEX::extractSubstr(uchar *str, uint strLen)
 		return NULL;
 	}
 
-	size_t* occs; uint num_occ;
+	size_t* occs; size_t num_occ;
 	num_occ = fm_index->locate(str, (uint)strLen, &occs);
 
 	if (num_occ > 0)
@@ -220,7 +244,7 @@ StringDictionaryFMINDEX::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar*
-StringDictionaryFMINDEX::extractRank(uint rank, uint *strLen)
+StringDictionaryFMINDEX::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -280,9 +304,9 @@ StringDictionaryFMINDEX::build_ssa(uchar *text, size_t len, bool sparse_bitseque
 
 	if (BWTsampling > 0)
 	{
-		uint samples = (len+1)/BWTsampling+1;
+		size_t samples = (len+1)/BWTsampling+1;
 
-		for (uint i=0; i<samples; i++) fm_index->suff_sample[i] = separators->rank1(fm_index->suff_sample[i]);
+		for (size_t i=0; i<samples; i++) fm_index->suff_sample->setField(i, separators->rank1(fm_index->suff_sample->getField(i)));
 	}
 }
 
@@ -75,7 +75,7 @@ class StringDictionaryFMINDEX : public StringDictionary
 	    	@param strLen: the string length.
 	    	@returns the ID (or NORESULT if it is not in the bucket).
 		 */
-		uint locate(uchar *str, uint strLen);
+		size_t locate(uchar *str, uint strLen);
 
 		/** Obtains the string associated with the given ID.
 	    	@param id: the ID to be extracted.
@@ -85,6 +85,23 @@ class StringDictionaryFMINDEX : public StringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
 		/** Locates all IDs of those elements prefixed by the given
 	    	string.
 	    	@param str: the prefix to be searched.
@@ -105,7 +122,7 @@ class StringDictionaryFMINDEX : public StringDictionary
 	    	@param rank: the alphabetical ranking.
 	    	@returns the ID.
 		 */
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 	    	@param str: the prefix to be searched.
@@ -128,7 +145,7 @@ class StringDictionaryFMINDEX : public StringDictionary
 	    	@returns the requested string (or NULL if it is not in the
 	      	  dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 	    	alphabetical order.
@@ -41,7 +41,7 @@ StringDictionaryHASHHF::StringDictionaryHASHHF()
 	coder = NULL;
 }
 
-StringDictionaryHASHHF::StringDictionaryHASHHF(IteratorDictString *it, uint len, int overhead, int encoding)
+StringDictionaryHASHHF::StringDictionaryHASHHF(IteratorDictString *it, size_t len, int overhead, int encoding)
 {
 	this->type = HASHHF;
 	this->encoding = encoding;
@@ -258,10 +258,10 @@ StringDictionaryHASHHF::StringDictionaryHASHHF(IteratorDictString *it, uint len,
 	delete builder;
 }
 
-uint
+size_t
 StringDictionaryHASHHF::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
 
 	// Encoding the string
 	uint encLen, offset;
@@ -298,6 +298,39 @@ StringDictionaryHASHHF::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryHASHHF::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint remain = maxcomplength+4;
+		uint pos = hash->getValue(id);
+
+		ChunkScan chunk = {0, 0, textStrings+pos, remain, buf, 0, 0, 1};
+		while (!(table->processChunk(&chunk)));
+
+		buf[chunk.strLen] = '\0';
+
+		return chunk.strLen-1;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryHASHHF::extractCapacity()
+{
+	return 4*maxlength+table->getK();
+}
+
+void
+StringDictionaryHASHHF::prefetch(size_t id, uint stage)
+{
+	if (stage == 0) hash->prefetchValue(id);
+	else __builtin_prefetch(textStrings+hash->getValue(id));
+}
+
 IteratorDictID*
 StringDictionaryHASHHF::locatePrefix(uchar *str, uint strLen)
 {
@@ -312,8 +345,8 @@ StringDictionaryHASHHF::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint
-StringDictionaryHASHHF::locateRank(uint rank)
+size_t
+StringDictionaryHASHHF::locateRank(size_t rank)
 {
 	cout << "This dictionary does not provide rank location" << endl;
 	return 0;
@@ -334,7 +367,7 @@ StringDictionaryHASHHF::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHASHHF::extractRank(uint rank, uint *strLen)
+StringDictionaryHASHHF::extractRank(size_t rank, uint *strLen)
 {
 	cout << "This dictionary does not provide rank extraction" << endl;
 	return NULL;
@@ -373,48 +406,101 @@ StringDictionaryHASHHF::getSize()
 void
 StringDictionaryHASHHF::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint32_t>(out, encoding);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, maxcomplength);
-
-	// Information for Hash and Huffman encoding
-	hash->save(out);
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-
-	// Decoding Table
-	saveValue<Codeword>(out, codewords, 256);
-	table->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
 StringDictionaryHASHHF::load(ifstream &in)
 {
 	StringDictionaryHASHHF *dict = new StringDictionaryHASHHF();
-	dict->type = HASHHF;
-	dict->encoding = loadValue<uint32_t>(in);
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->maxcomplength = loadValue<uint32_t>(in);
 
-	dict->hash = Hash::load(in, dict->encoding);
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->hash->setData(dict->textStrings);
-
-	dict->codewords = loadValue<Codeword>(in, 256);
-	dict->table = DecodingTable::load(in);
-	dict->coder = new StatCoder(dict->table, dict->codewords);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, RePairOptions()))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
 	return dict;
 }
 
+uint
+StringDictionaryHASHHF::numSections()
+{
+	return SECTIONS;
+}
+
+void
+StringDictionaryHASHHF::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint32_t>(out, encoding);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, maxcomplength);
+			break;
+		}
+		case 1:
+		{
+			hash->save(out);
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2:
+		{
+			saveValue<Codeword>(out, codewords, 256);
+			table->save(out);
+			break;
+		}
+	}
+}
+
+bool
+StringDictionaryHASHHF::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			encoding = loadValue<uint32_t>(in);
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			maxcomplength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			hash = Hash::load(in, encoding);
+			if (hash == NULL) return false;
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			hash->setData(textStrings);
+			return in.good();
+		}
+		case 2:
+		{
+			codewords = loadValue<Codeword>(in, 256);
+			table = DecodingTable::load(in);
+			coder = new StatCoder(table, codewords);
+			return in.good();
+		}
+	}
+	return false;
+}
+
 StringDictionaryHASHHF::~StringDictionaryHASHHF()
 {
 	if (hash != NULL) delete hash;
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (codewords != NULL) delete [] codewords;
 	if (table != NULL) delete table;
 	if (coder != NULL) delete coder;
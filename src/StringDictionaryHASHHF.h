@@ -65,14 +65,14 @@ class StringDictionaryHASHHF : public StringDictionary
 		      the size of the dictionary.
 		    @param encoding: hash table encoding (HASHUFF, HASHBHUFF, or HASHBBHUFF).
 		*/
-		StringDictionaryHASHHF(IteratorDictString *it, uint len, int overhead, int encoding);
+		StringDictionaryHASHHF(IteratorDictString *it, size_t len, int overhead, int encoding);
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -82,6 +82,31 @@ class StringDictionaryHASHHF : public StringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID (see
+		    StringDictionary::prefetch): the hash entry
+		    (stage 0) and the beginning of the encoded string (stage 1).
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		void prefetch(size_t id, uint stage);
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -102,7 +127,7 @@ class StringDictionaryHASHHF : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -125,7 +150,7 @@ class StringDictionaryHASHHF : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -153,6 +178,12 @@ class StringDictionaryHASHHF : public StringDictionary
 		~StringDictionaryHASHHF();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the hash table and the strings and 2 the Huffman decoder
+		static const uint SECTIONS = 3;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		uint32_t encoding;		//! Tells the class of table encoding
 		Hash *hash;				//! Hash table
 
@@ -42,7 +42,7 @@ StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC()
 	this->oks = 0;
 }
 
-StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, uint len, int overhead)
+StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, size_t len, int overhead, const RePairOptions &options)
 {
 	this->type = HASHRPDAC;
 	this->elements = 0;
@@ -86,7 +86,7 @@ StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, uin
 
 	uchar *strCurrent;
 	uint lenCurrent=0;
-	uint processed=0;
+	size_t processed=0;
 	for (uint current=0; current<elements; current++)
 	{
 		strCurrent= it->next(&lenCurrent);
@@ -123,11 +123,22 @@ StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, uin
 	}
 
 
-	rp = new RePair(dict, processed, maxchar);
+	rp = new RePair(dict, processed, maxchar, options);
+	if (!rp->good())
 	{
-		// Compacting the sequence (a -i value is inserted after the i-th string).
-		int *cdict = new int[processed];
-		uint io = 0, ic = 0, strings = 0;
+		// The strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] dict;
+		elements = 0;
+		return;
+	}
+
+	{
+		// Compacting the sequence (a -1 value is inserted after each string).
+		// It is compacted in place: ic never overtakes io.
+		int *cdict = dict;
+		size_t io = 0, ic = 0;
+		size_t strings = 0;
 		uint maxseq = 0, currentseq = 0;
 
 		hash->setOffset(sorting[0].hash, 0);
@@ -143,7 +154,7 @@ StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, uin
 					hash->setOffset(sorting[strings].hash, ic);
 					strings++;
 
-					cdict[ic] = -strings;
+					cdict[ic] = -1;
 					io++; ic++;
 					currentseq = 0;
 				}
@@ -156,26 +167,25 @@ StringDictionaryHASHRPDAC::StringDictionaryHASHRPDAC(IteratorDictString *it, uin
 			}
 			else
 			{
-				if (io < processed) io = -(dict[io]+1);
+				if (io < processed) io = RePair::skipReplaced(dict, io);
 			}
 		}
 
-		delete [] dict;
-
 		// Post-processing the hash
 		hash->finish(ic);
 
 		// Building the array for the sequence
 		rp->Cdac = new DAC_VLS(cdict, ic-2, bits(rp->rules+rp->terminals), maxseq);
 
-		delete [] cdict;
+		delete [] dict;
 	}
 }
 
-uint
+size_t
 StringDictionaryHASHRPDAC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
+	if (rp == NULL) return id;
 
 	size_t hval = bitwisehash(str, strLen, hash->tsize);
 	size_t next;
@@ -246,6 +256,56 @@ StringDictionaryHASHRPDAC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryHASHRPDAC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint *rules;
+		uint len = rp->Cdac->access(id, &rules);
+		uint strLen = 0;
+
+		for (uint i=0; i<len; i++)
+		{
+			if (rules[i] >= rp->terminals) strLen += rp->expandRule(rules[i]-rp->terminals, (buf+strLen));
+			else
+			{
+				buf[strLen] = (uchar)rules[i];
+				strLen++;
+			}
+		}
+
+		buf[strLen] = (uchar)'\0';
+		delete [] rules;
+		return strLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryHASHRPDAC::extractCapacity()
+{
+	return maxlength+1;
+}
+
+void
+StringDictionaryHASHRPDAC::prefetch(size_t id, uint stage)
+{
+	if (rp == NULL) return;
+
+	if (stage == 0) rp->Cdac->prefetch(id);
+	else
+	{
+		size_t pos = id;
+		uint rule = rp->Cdac->access_next(0, &pos);
+
+		if (rule >= rp->terminals) rp->prefetchRule(rule-rp->terminals);
+		if (pos != DAC_VLS::END) rp->Cdac->prefetch(pos);
+	}
+}
+
 IteratorDictID*
 StringDictionaryHASHRPDAC::locatePrefix(uchar *str, uint strLen)
 {
@@ -260,8 +320,8 @@ StringDictionaryHASHRPDAC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint
-StringDictionaryHASHRPDAC::locateRank(uint rank)
+size_t
+StringDictionaryHASHRPDAC::locateRank(size_t rank)
 {
 	cout << "This dictionary does not provide rank location" << endl;
 	return 0;
@@ -282,7 +342,7 @@ StringDictionaryHASHRPDAC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHASHRPDAC::extractRank(uint rank, uint *strLen)
+StringDictionaryHASHRPDAC::extractRank(size_t rank, uint *strLen)
 {
 	cout << "This dictionary does not provide rank extraction" << endl;
 	return NULL;
@@ -299,36 +359,91 @@ StringDictionaryHASHRPDAC::extractTable()
 	return new IteratorDictStringVector(&tabledec, elements);
 }
 
+bool
+StringDictionaryHASHRPDAC::good()
+{
+	return rp != NULL;
+}
+
 size_t
 StringDictionaryHASHRPDAC::getSize()
 {
+	if (rp == NULL) return sizeof(StringDictionaryHASHRPDAC);
 	return hash->getSize()+rp->getSize()+sizeof(StringDictionaryHASHRPDAC);
 }
 
 void
 StringDictionaryHASHRPDAC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	rp->save(out, type);
-	hash->save(out);
+	if (rp == NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
-StringDictionaryHASHRPDAC::load(ifstream &in, uint technique)
+StringDictionaryHASHRPDAC::load(ifstream &in, uint technique, const RePairOptions &options)
 {
 	StringDictionaryHASHRPDAC *dict = new StringDictionaryHASHRPDAC();
 	dict->type = technique;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
 
-	dict->rp = RePair::load(in);
-	dict->hash = HashDAC::load(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
 	return dict;
 }
 
+uint
+StringDictionaryHASHRPDAC::numSections()
+{
+	return SECTIONS;
+}
+
+void
+StringDictionaryHASHRPDAC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			break;
+		}
+		case 1: rp->save(out, type); break;
+		case 2: hash->save(out); break;
+	}
+}
+
+bool
+StringDictionaryHASHRPDAC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1: rp = RePair::load(in, options); return rp != NULL;
+		case 2: hash = HashDAC::load(in); return hash != NULL;
+	}
+	return false;
+}
+
 StringDictionaryHASHRPDAC::~StringDictionaryHASHRPDAC()
 {
 	//cout << "ACCESSES => " << accesses << endl;
@@ -60,15 +60,16 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 		    @param overhead: overhead that the hash table will use over
 		      the size of the dictionary
 		    @param order: dictionary order (hash-based order by default)
+		    @param options: options of the RePair compression.
 		*/
-		StringDictionaryHASHRPDAC(IteratorDictString *it, uint len, int overhead);
+		StringDictionaryHASHRPDAC(IteratorDictString *it, size_t len, int overhead, const RePairOptions &options=RePairOptions());
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -78,6 +79,32 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID (see
+		    StringDictionary::prefetch): the first level of the
+		    DAC (stage 0) and, from its first symbol, the first rule and
+		    the next level (stage 1).
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		void prefetch(size_t id, uint stage);
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -98,7 +125,7 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -121,7 +148,7 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -129,6 +156,12 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 		*/
 		IteratorDictString* extractTable();
 
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes.
 		    @returns the dictionary size in bytes.
 		*/
@@ -141,14 +174,23 @@ class StringDictionaryHASHRPDAC : public StringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param technique: the dictionary type.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in, uint technique=HASHRPDAC);
+		static StringDictionary *load(ifstream &in, uint technique=HASHRPDAC, const RePairOptions &options=RePairOptions());
 
 		/** Generic destructor. */
 		~StringDictionaryHASHRPDAC();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the RePair and 2 the hash table
+		static const uint SECTIONS = 3;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		HashDAC *hash;	//! Hash table
 		RePair *rp;		//! RePair encoding
 
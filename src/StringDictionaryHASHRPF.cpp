@@ -36,7 +36,7 @@ StringDictionaryHASHRPF::StringDictionaryHASHRPF()
 	this->hash = NULL;
 }
 
-StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, uint len, int overhead, int encoding)
+StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, size_t len, int overhead, int encoding, const RePairOptions &options)
 {
 	this->type = HASHRPF;
 	this->elements = 0;
@@ -77,7 +77,7 @@ StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, uint le
 
 	uchar *strCurrent;
 	uint lenCurrent=0;
-	uint processed=0;
+	size_t processed=0;
 
 	for (uint current=0; current<elements; current++)
 	{
@@ -118,13 +118,22 @@ StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, uint le
 	processed--;
 	delete it;
 
-	rp = new RePair(dict, processed, maxchar);
+	rp = new RePair(dict, processed, maxchar, options);
+	if (!rp->good())
+	{
+		// The strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] dict;
+		elements = 0;
+		return;
+	}
 
 	{
 		// Compacting the sequence
 		vector<size_t> textStrings;
 		size_t bytesStrings = 0;
-		uint io = 0, strings = 0;
+		size_t io = 0;
+		size_t strings = 0;
 
 		hash->setOffset(sorting[0].hash, 0);
 
@@ -145,7 +154,7 @@ StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, uint le
 			}
 			else
 			{
-				if (io < processed) io = -(dict[io]+1);
+				if (io < processed) io = RePair::skipReplaced(dict, io);
 			}
 		}
 
@@ -159,10 +168,11 @@ StringDictionaryHASHRPF::StringDictionaryHASHRPF(IteratorDictString *it, uint le
 	}
 }
 
-uint
+size_t
 StringDictionaryHASHRPF::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
+	if (rp == NULL) return id;
 
 	size_t hval = bitwisehash(str, strLen, hash->tsize);
 	size_t next;
@@ -229,6 +239,56 @@ StringDictionaryHASHRPF::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryHASHRPF::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint strLen = 0;
+		uint position = hash->getValue(id);
+
+		uint rule;
+		uint ptr = 0;
+
+		while (true)
+		{
+			rule = rp->Cls->getField(position+ptr); ptr++;
+
+			if (rule >= rp->terminals) strLen += rp->expandRule(rule-rp->terminals, (buf+strLen));
+			else
+			{
+				buf[strLen] = (uchar)rule;
+				strLen++;
+			}
+
+			if (buf[strLen-1] == rp->maxchar) break;
+		}
+
+		strLen--;
+		buf[strLen] = (uchar)'\0';
+
+		return strLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryHASHRPF::extractCapacity()
+{
+	return maxlength+1;
+}
+
+void
+StringDictionaryHASHRPF::prefetch(size_t id, uint stage)
+{
+	if (rp == NULL) return;
+
+	if (stage == 0) hash->prefetchValue(id);
+	else rp->Cls->prefetch(hash->getValue(id));
+}
+
 IteratorDictID*
 StringDictionaryHASHRPF::locatePrefix(uchar *str, uint strLen)
 {
@@ -243,8 +303,8 @@ StringDictionaryHASHRPF::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint
-StringDictionaryHASHRPF::locateRank(uint rank)
+size_t
+StringDictionaryHASHRPF::locateRank(size_t rank)
 {
 	cout << "This dictionary does not provide rank location" << endl;
 	return 0;
@@ -265,7 +325,7 @@ StringDictionaryHASHRPF::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHASHRPF::extractRank(uint rank, uint *strLen)
+StringDictionaryHASHRPF::extractRank(size_t rank, uint *strLen)
 {
 	cout << "This dictionary does not provide rank extraction" << endl;
 	return NULL;
@@ -282,40 +342,92 @@ StringDictionaryHASHRPF::extractTable()
 	return new IteratorDictStringVector(&tabledec, elements);
 }
 
+bool
+StringDictionaryHASHRPF::good()
+{
+	return rp != NULL;
+}
+
 size_t
 StringDictionaryHASHRPF::getSize()
 {
+	if (rp == NULL) return sizeof(StringDictionaryHASHRPF);
 	return hash->getSize()+rp->getSize()+sizeof(StringDictionaryHASHRPF);
 }
 
 void
 StringDictionaryHASHRPF::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint32_t>(out, encoding);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
+	if (rp == NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
 
-	rp->save(out, HASHRPF);
-	hash->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
-StringDictionaryHASHRPF::load(ifstream &in)
+StringDictionaryHASHRPF::load(ifstream &in, const RePairOptions &options)
 {
 	StringDictionaryHASHRPF *dict = new StringDictionaryHASHRPF();
 
-	dict->type = HASHRPF;
-	dict->encoding = loadValue<uint32_t>(in);
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-
-	dict->rp = RePair::load(in);
-	dict->hash = Hash::load(in, dict->encoding);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
 	return dict;
 }
 
+uint
+StringDictionaryHASHRPF::numSections()
+{
+	return SECTIONS;
+}
+
+void
+StringDictionaryHASHRPF::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint32_t>(out, encoding);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			break;
+		}
+		case 1: rp->save(out, HASHRPF); break;
+		case 2: hash->save(out); break;
+	}
+}
+
+bool
+StringDictionaryHASHRPF::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			encoding = loadValue<uint32_t>(in);
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1: rp = RePair::load(in, options); return rp != NULL;
+		case 2: hash = Hash::load(in, encoding); return hash != NULL;
+	}
+	return false;
+}
+
 StringDictionaryHASHRPF::~StringDictionaryHASHRPF()
 {
 	if (rp != NULL) delete rp;
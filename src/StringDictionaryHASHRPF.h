@@ -60,15 +60,16 @@ class StringDictionaryHASHRPF : public StringDictionary
 		    @param overhead: overhead that the hash table will use over
 		      the size of the dictionary
 			@param encoding: hash table encoding (HASHUFF, HASHBHUFF, or HASHBBHUFF).
+		    @param options: options of the RePair compression.
 		*/
-		StringDictionaryHASHRPF(IteratorDictString *it, uint len, int overhead, int encoding);
+		StringDictionaryHASHRPF(IteratorDictString *it, size_t len, int overhead, int encoding, const RePairOptions &options=RePairOptions());
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -78,6 +79,31 @@ class StringDictionaryHASHRPF : public StringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID (see
+		    StringDictionary::prefetch): the hash entry
+		    (stage 0) and the first RePair symbols of the string (stage 1).
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		void prefetch(size_t id, uint stage);
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -98,7 +124,7 @@ class StringDictionaryHASHRPF : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -121,7 +147,7 @@ class StringDictionaryHASHRPF : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -129,6 +155,12 @@ class StringDictionaryHASHRPF : public StringDictionary
 		*/
 		IteratorDictString* extractTable();
 
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes.
 		    @returns the dictionary size in bytes.
 		*/
@@ -141,14 +173,22 @@ class StringDictionaryHASHRPF : public StringDictionary
 
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in);
+		static StringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Generic destructor. */
 		~StringDictionaryHASHRPF();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the RePair and 2 the hash table
+		static const uint SECTIONS = 3;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		Hash *hash;				//! Hash table
 		uint32_t encoding;		//! Tells how the hash tables is encoded
 		RePair *rp;				//! RePair encoding
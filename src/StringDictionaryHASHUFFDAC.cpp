@@ -40,7 +40,7 @@ StringDictionaryHASHUFFDAC::StringDictionaryHASHUFFDAC()
 	this->dac = NULL;
 }
 
-StringDictionaryHASHUFFDAC::StringDictionaryHASHUFFDAC(IteratorDictString *it, uint len, int overhead)
+StringDictionaryHASHUFFDAC::StringDictionaryHASHUFFDAC(IteratorDictString *it, size_t len, int overhead)
 {
 	this->type = HASHUFFDAC;
 	this->elements = 0;
@@ -215,10 +215,10 @@ StringDictionaryHASHUFFDAC::StringDictionaryHASHUFFDAC(IteratorDictString *it, u
 	delete builder;
 }
 
-uint
+size_t
 StringDictionaryHASHUFFDAC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
 
 	// Encoding the string
 	uint encLen, offset;
@@ -236,6 +236,34 @@ StringDictionaryHASHUFFDAC::extract(size_t id, uint *strLen)
 	else { *strLen = 0; return NULL; }
 }
 
+uint
+StringDictionaryHASHUFFDAC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	uint strLen = 0;
+	if ((id > 0) && (id <= elements)) extractString(id, &strLen, buf);
+	return strLen;
+}
+
+size_t
+StringDictionaryHASHUFFDAC::extractCapacity()
+{
+	return 4*maxlength;
+}
+
+void
+StringDictionaryHASHUFFDAC::prefetch(size_t id, uint stage)
+{
+	if (stage == 0) dac->prefetch(id);
+	else
+	{
+		uint pos = id;
+		dac->access_next(0, &pos);
+		if (pos != (uint)-1) dac->prefetch(pos);
+	}
+}
+
 IteratorDictID*
 StringDictionaryHASHUFFDAC::locatePrefix(uchar *str, uint strLen)
 {
@@ -250,8 +278,8 @@ StringDictionaryHASHUFFDAC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint
-StringDictionaryHASHUFFDAC::locateRank(uint rank)
+size_t
+StringDictionaryHASHUFFDAC::locateRank(size_t rank)
 {
 	cout << "This dictionary does not provide rank location" << endl;
 	return 0;
@@ -272,7 +300,7 @@ StringDictionaryHASHUFFDAC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHASHUFFDAC::extractRank(uint rank, uint *strLen)
+StringDictionaryHASHUFFDAC::extractRank(size_t rank, uint *strLen)
 {
 	cout << "This dictionary does not provide rank extraction" << endl;
 	return NULL;
@@ -291,10 +319,10 @@ StringDictionaryHASHUFFDAC::extractTable()
 }
 
 inline uchar*
-StringDictionaryHASHUFFDAC::extractString(size_t id, uint *strLen)
+StringDictionaryHASHUFFDAC::extractString(size_t id, uint *strLen, uchar *tmp)
 {
 	uchar *dec = new uchar[4*maxlength];
-	uchar *tmp = new uchar[4*maxlength];
+	if (tmp == NULL) tmp = new uchar[4*maxlength];
 
 	uint cid = id;
 	uint level = 0;
@@ -350,17 +378,9 @@ StringDictionaryHASHUFFDAC::getSize()
 void
 StringDictionaryHASHUFFDAC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-
-	// Information for Hash and Huffman encoding
-	hash->save(out);
-	dac->save(out);
-
-	// Decoding Table
-	saveValue<Codeword>(out, codewords, 256);
-	table->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 
@@ -370,19 +390,79 @@ StringDictionaryHASHUFFDAC::load(ifstream &in)
 {
 	StringDictionaryHASHUFFDAC *dict = new StringDictionaryHASHUFFDAC();
 
-	dict->type = HASHUFFDAC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, RePairOptions()))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
+
+	return dict;
+}
 
-	dict->hash = HashDAC::load(in);
-	dict->dac = DAC_BVLS::load(in);
-	dict->hash->setData(dict->dac);
+uint
+StringDictionaryHASHUFFDAC::numSections()
+{
+	return SECTIONS;
+}
 
-	dict->codewords = loadValue<Codeword>(in, 256);
-	dict->table = DecodingTable::load(in);
-	dict->coder = new StatCoder(dict->table, dict->codewords);
+void
+StringDictionaryHASHUFFDAC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			break;
+		}
+		case 1:
+		{
+			hash->save(out);
+			dac->save(out);
+			break;
+		}
+		case 2:
+		{
+			saveValue<Codeword>(out, codewords, 256);
+			table->save(out);
+			break;
+		}
+	}
+}
 
-	return dict;
+bool
+StringDictionaryHASHUFFDAC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			hash = HashDAC::load(in);
+			dac = DAC_BVLS::load(in);
+			if ((hash == NULL) || (dac == NULL)) return false;
+			hash->setData(dac);
+			return in.good();
+		}
+		case 2:
+		{
+			codewords = loadValue<Codeword>(in, 256);
+			table = DecodingTable::load(in);
+			coder = new StatCoder(table, codewords);
+			return in.good();
+		}
+	}
+	return false;
 }
 
 StringDictionaryHASHUFFDAC::~StringDictionaryHASHUFFDAC()
@@ -72,14 +72,14 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		    @param overhead: overhead that the hash table will use over
 		      the size of the dictionary
 		*/
-		StringDictionaryHASHUFFDAC(IteratorDictString *it, uint len, int overhead);
+		StringDictionaryHASHUFFDAC(IteratorDictString *it, size_t len, int overhead);
 
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -89,6 +89,31 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		 */
 		uchar* extract(size_t id, uint *strLen);
 
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID (see
+		    StringDictionary::prefetch): the first level of the
+		    DAC (stage 0) and the next level (stage 1).
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		void prefetch(size_t id, uint stage);
+
 		/** Locates all IDs of those elements prefixed by the given
 		    string.
 		    @param str: the prefix to be searched.
@@ -109,7 +134,7 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -132,7 +157,7 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 
 		/** Extracts all strings in the dictionary sorted in
 		    alphabetical order.
@@ -160,6 +185,12 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		~StringDictionaryHASHUFFDAC();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the hash table and the strings and 2 the Huffman decoder
+		static const uint SECTIONS = 3;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		HashDAC *hash;			//! Hash table
 		DAC_BVLS *dac;			//! DAC structure
 
@@ -177,10 +208,12 @@ class StringDictionaryHASHUFFDAC : public StringDictionary
 		 * representation.
 		 *  @param id: the ID to be extracted.
 		 *  @param strLen: pointer to the extracted string length.
+		 *  @param tmp: buffer for the decoding (of 4*maxlength chars),
+		      allocated if NULL.
 		 *  @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		 */
-		inline uchar* extractString(size_t id, uint *strLen);
+		inline uchar* extractString(size_t id, uint *strLen, uchar *tmp=NULL);
 };
 
 #endif  /* _STRINGDICTIONARY_HASHHUFFDAC_H */
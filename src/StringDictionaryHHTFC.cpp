@@ -369,10 +369,10 @@ StringDictionaryHHTFC::StringDictionaryHHTFC(IteratorDictString *it, uint bucket
 	tableHU = builderHU->getTable(); delete builderHU;
 }
 
-uint 
+size_t 
 StringDictionaryHHTFC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
 	// Encoding the string
 	uint encLen, offset;
 	uchar *encoded = coderHT->encodeString(str, strLen+1, &encLen, &offset);
@@ -458,6 +458,75 @@ StringDictionaryHHTFC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryHHTFC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint pos = ((id-1)%bucketsize);
+
+		// The bucket is decoded directly in the buffer
+		ChunkScan c = decodeHeader(idbucket, buf);
+
+		if (pos > 0)
+		{
+			resetScan(&c, idbucket);
+			for (uint i=1; i<=pos; i++) coderHU->decodeString(&c);
+		}
+
+		return c.strLen-1;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryHHTFC::extractCapacity()
+{
+	return 4*maxlength+tableHT->getK();
+}
+
+void
+StringDictionaryHHTFC::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	uchar *buffer = new uchar[extractCapacity()];
+	uint i = 0;
+
+	while (i < n)
+	{
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements))
+		{
+			callback(order[i], NULL, 0, data);
+			i++;
+			continue;
+		}
+
+		// The bucket is decoded once for all its IDs (sorted by position), in
+		// the same buffer for all the buckets
+		uint idbucket = 1+((id-1)/bucketsize);
+		ChunkScan c = decodeHeader(idbucket, buffer);
+		uint current = 0;
+
+		for (; (i < n) && (ids[order[i]] <= elements) && (1+((ids[order[i]]-1)/bucketsize) == idbucket); i++)
+		{
+			uint pos = ((ids[order[i]]-1)%bucketsize);
+
+			if ((current == 0) && (pos > 0)) resetScan(&c, idbucket);
+			for (; current < pos; current++) coderHU->decodeString(&c);
+
+			callback(order[i], c.str, c.strLen-1, data);
+		}
+	}
+
+	delete [] buffer;
+	delete [] order;
+}
+
 IteratorDictID*
 StringDictionaryHHTFC::locatePrefix(uchar *str, uint strLen)
 {
@@ -544,8 +613,8 @@ StringDictionaryHHTFC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint 
-StringDictionaryHHTFC::locateRank(uint rank)
+size_t 
+StringDictionaryHHTFC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -579,7 +648,7 @@ StringDictionaryHHTFC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHHTFC::extractRank(uint rank, uint *strLen)
+StringDictionaryHHTFC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -598,24 +667,12 @@ StringDictionaryHHTFC::getSize()
 	return bytesStrings*sizeof(uchar)+blStrings->getSize()+256*2*sizeof(Codeword)+tableHT->getSize()+tableHU->getSize()+sizeof(StringDictionaryHHTFC);
 }
 
-void 
+void
 StringDictionaryHHTFC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, maxcomplength);
-	saveValue<uint32_t>(out, buckets);
-	saveValue<uint32_t>(out, bucketsize);
-
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-	blStrings->save(out);	
-
-	saveValue<Codeword>(out, codewordsHT, 256);
-	tableHT->save(out);
-	saveValue<Codeword>(out, codewordsHU, 256);
-	tableHU->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
@@ -623,26 +680,90 @@ StringDictionaryHHTFC::load(ifstream &in)
 {
 	StringDictionaryHHTFC *dict = new StringDictionaryHHTFC();
 
-	dict->type = HHTFC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->maxcomplength = loadValue<uint32_t>(in);
-	dict->buckets = loadValue<uint32_t>(in);
-	dict->bucketsize = loadValue<uint32_t>(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, RePairOptions()))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->blStrings = new LogSequence(in);
+	return dict;
+}
 
-	dict->codewordsHT = loadValue<Codeword>(in, 256);
-	dict->tableHT = DecodingTable::load(in);
-	dict->coderHT = new StatCoder(dict->tableHT, dict->codewordsHT);
+uint
+StringDictionaryHHTFC::numSections()
+{
+	return SECTIONS;
+}
 
-	dict->codewordsHU = loadValue<Codeword>(in, 256);
-	dict->tableHU = DecodingTable::load(in);
-	dict->coderHU = new StatCoder(dict->tableHU, dict->codewordsHU);
+void
+StringDictionaryHHTFC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, maxcomplength);
+			saveValue<uint32_t>(out, buckets);
+			saveValue<uint32_t>(out, bucketsize);
+			break;
+		}
+		case 1:
+		{
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2: blStrings->save(out); break;
+		case 3:
+		{
+			saveValue<Codeword>(out, codewordsHT, 256);
+			tableHT->save(out);
+			saveValue<Codeword>(out, codewordsHU, 256);
+			tableHU->save(out);
+			break;
+		}
+	}
+}
 
-	return dict;
+bool
+StringDictionaryHHTFC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			maxcomplength = loadValue<uint32_t>(in);
+			buckets = loadValue<uint32_t>(in);
+			bucketsize = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			return in.good();
+		}
+		case 2: blStrings = new LogSequence(in); return in.good();
+		case 3:
+		{
+			codewordsHT = loadValue<Codeword>(in, 256);
+			tableHT = DecodingTable::load(in);
+			coderHT = new StatCoder(tableHT, codewordsHT);
+			codewordsHU = loadValue<Codeword>(in, 256);
+			tableHU = DecodingTable::load(in);
+			coderHU = new StatCoder(tableHU, codewordsHU);
+			return in.good();
+		}
+	}
+	return false;
 }
 
 uchar*
@@ -655,10 +776,11 @@ StringDictionaryHHTFC::getHeader(size_t idbucket)
 }
 
 ChunkScan
-StringDictionaryHHTFC::decodeHeader(size_t idbucket)
+StringDictionaryHHTFC::decodeHeader(size_t idbucket, uchar *buffer)
 {
 	uchar* ptr = textStrings+blStrings->getField(idbucket);
-	ChunkScan chunk = {0, 0, ptr, maxcomplength, new uchar[4*maxlength+tableHT->getK()], 0, 0, 1};
+	if (buffer == NULL) buffer = new uchar[4*maxlength+tableHT->getK()];
+	ChunkScan chunk = {0, 0, ptr, maxcomplength, buffer, 0, 0, 1};
 
 	// Variables used for adjusting purposes
 	uint plen = 0;
@@ -854,7 +976,7 @@ StringDictionaryHHTFC::resetScan(ChunkScan *c, size_t idbucket)
 
 StringDictionaryHHTFC::~StringDictionaryHHTFC()
 {
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (blStrings != NULL) delete blStrings;
 	if (coderHT != NULL) delete coderHT;
 	if (coderHU != NULL) delete coderHU;
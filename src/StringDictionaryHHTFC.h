@@ -88,7 +88,7 @@ class StringDictionaryHHTFC : public StringDictionary
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 		
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -97,6 +97,36 @@ class StringDictionaryHHTFC : public StringDictionary
 		      dictionary).
 		 */
 		uchar* extract(size_t id, uint *strLen);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Decodes the strings associated with a batch of IDs, grouping
+		    the IDs by bucket and decoding each bucket once, in a single
+		    forward pass, for all its IDs.
+		    @param ids: the IDs to be extracted.
+		    @param n: number of IDs.
+		    @param callback: function called for each ID (in increasing
+		      order of ID) with its string, which is only valid during
+		      the call.
+		    @param data: user data given to the callback.
+		*/
+		void extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data);
+		using StringDictionary::extractBatch;
 		
 		/** Locates all IDs of those elements prefixed by the given 
 		    string.
@@ -118,7 +148,7 @@ class StringDictionaryHHTFC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 		
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -141,7 +171,7 @@ class StringDictionaryHHTFC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 		
 		/** Extracts all strings in the dictionary sorted in 
 		    alphabetical order. 
@@ -169,6 +199,12 @@ class StringDictionaryHHTFC : public StringDictionary
 		~StringDictionaryHHTFC();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the strings, 2 their positions and 3 the Hu-Tucker and Huffman decoders
+		static const uint SECTIONS = 4;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		uint32_t maxcomplength;	//! The largest compressed header
 
 		uint32_t buckets;		//! Number of total buckets in the dictionary
@@ -193,9 +229,11 @@ class StringDictionaryHHTFC : public StringDictionary
 
 		/** Decodes the first string in the bucket. 
 		    @idbucket: the bucket storing the required header.
+		    @buffer: buffer for the decoded strings (of
+		      extractCapacity() chars), allocated if NULL.
 		    @returns the scanning data
 		*/
-		inline ChunkScan decodeHeader(size_t idbucket);
+		inline ChunkScan decodeHeader(size_t idbucket, uchar *buffer=NULL);
 
 		/** Locates the candidate bucket in which the given string can
 		    be represented.
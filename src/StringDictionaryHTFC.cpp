@@ -313,10 +313,10 @@ StringDictionaryHTFC::StringDictionaryHTFC(IteratorDictString *it, uint bucketsi
 	delete builder;
 }
 
-uint 
+size_t 
 StringDictionaryHTFC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
 
 	// Encoding the string
 	uint encLen, offset;
@@ -402,6 +402,75 @@ StringDictionaryHTFC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryHTFC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint pos = ((id-1)%bucketsize);
+
+		// The bucket is decoded directly in the buffer
+		ChunkScan c = decodeHeader(idbucket, buf);
+
+		if (pos > 0)
+		{
+			resetScan(&c, idbucket);
+			for (uint i=1; i<=pos; i++) coder->decodeString(&c);
+		}
+
+		return c.strLen-1;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryHTFC::extractCapacity()
+{
+	return 4*maxlength+table->getK();
+}
+
+void
+StringDictionaryHTFC::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	uchar *buffer = new uchar[extractCapacity()];
+	uint i = 0;
+
+	while (i < n)
+	{
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements))
+		{
+			callback(order[i], NULL, 0, data);
+			i++;
+			continue;
+		}
+
+		// The bucket is decoded once for all its IDs (sorted by position), in
+		// the same buffer for all the buckets
+		uint idbucket = 1+((id-1)/bucketsize);
+		ChunkScan c = decodeHeader(idbucket, buffer);
+		uint current = 0;
+
+		for (; (i < n) && (ids[order[i]] <= elements) && (1+((ids[order[i]]-1)/bucketsize) == idbucket); i++)
+		{
+			uint pos = ((ids[order[i]]-1)%bucketsize);
+
+			if ((current == 0) && (pos > 0)) resetScan(&c, idbucket);
+			for (; current < pos; current++) coder->decodeString(&c);
+
+			callback(order[i], c.str, c.strLen-1, data);
+		}
+	}
+
+	delete [] buffer;
+	delete [] order;
+}
+
 IteratorDictID*
 StringDictionaryHTFC::locatePrefix(uchar *str, uint strLen)
 {
@@ -488,8 +557,8 @@ StringDictionaryHTFC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint 
-StringDictionaryHTFC::locateRank(uint rank)
+size_t 
+StringDictionaryHTFC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -523,7 +592,7 @@ StringDictionaryHTFC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryHTFC::extractRank(uint rank, uint *strLen)
+StringDictionaryHTFC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -540,22 +609,12 @@ StringDictionaryHTFC::getSize()
 	return bytesStrings*sizeof(uchar)+blStrings->getSize()+256*sizeof(Codeword)+table->getSize()+sizeof(StringDictionaryHTFC);
 }
 
-void 
+void
 StringDictionaryHTFC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, maxcomplength);
-	saveValue<uint32_t>(out, buckets);
-	saveValue<uint32_t>(out, bucketsize);
-
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-	blStrings->save(out);	
-
-	saveValue<Codeword>(out, codewords, 256);
-	table->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
@@ -563,22 +622,85 @@ StringDictionaryHTFC::load(ifstream &in)
 {
 	StringDictionaryHTFC *dict = new StringDictionaryHTFC();
 
-	dict->type = HTFC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->maxcomplength = loadValue<uint32_t>(in);
-	dict->buckets = loadValue<uint32_t>(in);
-	dict->bucketsize = loadValue<uint32_t>(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, RePairOptions()))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->blStrings = new LogSequence(in);
+	return dict;
+}
 
-	dict->codewords = loadValue<Codeword>(in, 256);
-	dict->table = DecodingTable::load(in);
-	dict->coder = new StatCoder(dict->table, dict->codewords);
+uint
+StringDictionaryHTFC::numSections()
+{
+	return SECTIONS;
+}
 
-	return dict;
+void
+StringDictionaryHTFC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, maxcomplength);
+			saveValue<uint32_t>(out, buckets);
+			saveValue<uint32_t>(out, bucketsize);
+			break;
+		}
+		case 1:
+		{
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2: blStrings->save(out); break;
+		case 3:
+		{
+			saveValue<Codeword>(out, codewords, 256);
+			table->save(out);
+			break;
+		}
+	}
+}
+
+bool
+StringDictionaryHTFC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			maxcomplength = loadValue<uint32_t>(in);
+			buckets = loadValue<uint32_t>(in);
+			bucketsize = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			return in.good();
+		}
+		case 2: blStrings = new LogSequence(in); return in.good();
+		case 3:
+		{
+			codewords = loadValue<Codeword>(in, 256);
+			table = DecodingTable::load(in);
+			coder = new StatCoder(table, codewords);
+			return in.good();
+		}
+	}
+	return false;
 }
 
 uchar*
@@ -591,10 +713,11 @@ StringDictionaryHTFC::getHeader(size_t idbucket)
 }
 
 ChunkScan
-StringDictionaryHTFC::decodeHeader(size_t idbucket)
+StringDictionaryHTFC::decodeHeader(size_t idbucket, uchar *buffer)
 {
 	uchar* ptr = textStrings+blStrings->getField(idbucket);
-	ChunkScan chunk = {0, 0, ptr, maxcomplength, new uchar[4*maxlength+table->getK()], 0, 0, 1};
+	if (buffer == NULL) buffer = new uchar[4*maxlength+table->getK()];
+	ChunkScan chunk = {0, 0, ptr, maxcomplength, buffer, 0, 0, 1};
 
 	// Variables used for adjusting purposes
 	uint plen = 0;
@@ -786,7 +909,7 @@ StringDictionaryHTFC::resetScan(ChunkScan *c, size_t idbucket)
 
 StringDictionaryHTFC::~StringDictionaryHTFC()
 {
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (blStrings != NULL) delete blStrings;
 	if (codewords != NULL) delete [] codewords;
 	if (table != NULL) delete table;
@@ -125,10 +125,10 @@ StringDictionaryPFC::StringDictionaryPFC(IteratorDictString *it, uint bucketsize
 	blStrings = new LogSequence(&xblStrings, bits(bytesStrings));
 }
 
-uint
+size_t
 StringDictionaryPFC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
 
 	// Locating the candidate bucket for the string
 	size_t idbucket;
@@ -218,6 +218,81 @@ StringDictionaryPFC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryPFC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint pos = ((id-1)%bucketsize);
+
+		// The bucket is decoded directly in the buffer
+		uint decLen;
+		uchar *ptr = getHeader(idbucket, buf, &decLen);
+		uint lenPrefix;
+
+		for (uint i=1; i<=pos; i++)
+		{
+			ptr += VByte::decode(&lenPrefix, ptr);
+			decodeNextString(&ptr, lenPrefix, buf, &decLen);
+		}
+
+		return decLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryPFC::extractCapacity()
+{
+	return maxlength;
+}
+
+void
+StringDictionaryPFC::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	uchar *decoded = new uchar[extractCapacity()];
+	uint i = 0;
+
+	while (i < n)
+	{
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements))
+		{
+			callback(order[i], NULL, 0, data);
+			i++;
+			continue;
+		}
+
+		// The bucket is decoded once for all its IDs (sorted by position), in
+		// the same buffer for all the buckets
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint decLen;
+		uchar *ptr = getHeader(idbucket, decoded, &decLen);
+		uint lenPrefix, current = 0;
+
+		for (; (i < n) && (ids[order[i]] <= elements) && (1+((ids[order[i]]-1)/bucketsize) == idbucket); i++)
+		{
+			uint pos = ((ids[order[i]]-1)%bucketsize);
+
+			for (; current < pos; current++)
+			{
+				ptr += VByte::decode(&lenPrefix, ptr);
+				decodeNextString(&ptr, lenPrefix, decoded, &decLen);
+			}
+
+			callback(order[i], decoded, decLen, data);
+		}
+	}
+
+	delete [] decoded;
+	delete [] order;
+}
+
 IteratorDictID*
 StringDictionaryPFC::locatePrefix(uchar *str, uint strLen)
 {
@@ -294,8 +369,8 @@ StringDictionaryPFC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint
-StringDictionaryPFC::locateRank(uint rank)
+size_t
+StringDictionaryPFC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -332,7 +407,7 @@ StringDictionaryPFC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryPFC::extractRank(uint rank, uint *strLen)
+StringDictionaryPFC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -354,14 +429,9 @@ StringDictionaryPFC::getSize()
 void
 StringDictionaryPFC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, buckets);
-	saveValue<uint32_t>(out, bucketsize);
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-	blStrings->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 
@@ -370,18 +440,72 @@ StringDictionaryPFC::load(ifstream &in)
 {
 	StringDictionaryPFC *dict = new StringDictionaryPFC();
 
-	dict->type = PFC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->buckets = loadValue<uint32_t>(in);
-	dict->bucketsize = loadValue<uint32_t>(in);
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->blStrings = new LogSequence(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, RePairOptions()))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
 	return dict;
 }
 
+uint
+StringDictionaryPFC::numSections()
+{
+	return SECTIONS;
+}
+
+void
+StringDictionaryPFC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, buckets);
+			saveValue<uint32_t>(out, bucketsize);
+			break;
+		}
+		case 1:
+		{
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2: blStrings->save(out); break;
+	}
+}
+
+bool
+StringDictionaryPFC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			buckets = loadValue<uint32_t>(in);
+			bucketsize = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			return in.good();
+		}
+		case 2: blStrings = new LogSequence(in); return in.good();
+	}
+	return false;
+}
+
 inline uchar*
 StringDictionaryPFC::getHeader(size_t idbucket, uchar **str, uint *strLen)
 {
@@ -394,6 +518,17 @@ StringDictionaryPFC::getHeader(size_t idbucket, uchar **str, uint *strLen)
 	return ptr+(*strLen)+1;
 }
 
+inline uchar*
+StringDictionaryPFC::getHeader(size_t idbucket, uchar *str, uint *strLen)
+{
+	uchar *ptr = textStrings+blStrings->getField(idbucket);
+	*strLen = strlen((char*)ptr);
+
+	strncpy((char*)str, (char*)ptr, *strLen+1);
+
+	return ptr+(*strLen)+1;
+}
+
 void
 StringDictionaryPFC::decodeNextString(uchar **ptr, uint lenPrefix, uchar *str, uint *strLen)
 {
@@ -537,6 +672,6 @@ StringDictionaryPFC::searchDistinctPrefix(uchar *ptr, uint scanneable, uchar *de
 
 StringDictionaryPFC::~StringDictionaryPFC()
 {
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (blStrings != NULL) delete blStrings;
 }
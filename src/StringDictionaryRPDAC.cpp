@@ -37,7 +37,7 @@ StringDictionaryRPDAC::StringDictionaryRPDAC()
 	this->rp = NULL;
 }
 
-StringDictionaryRPDAC::StringDictionaryRPDAC(IteratorDictString *it)
+StringDictionaryRPDAC::StringDictionaryRPDAC(IteratorDictString *it, const RePairOptions &options)
 {
 	this->type = RPDAC;
 	this->elements = 0;
@@ -62,11 +62,20 @@ StringDictionaryRPDAC::StringDictionaryRPDAC(IteratorDictString *it)
 
 	delete it;
 
-	rp = new RePair(dict, processed, 0);
+	rp = new RePair(dict, processed, 0, options);
+	if (!rp->good())
+	{
+		// The strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] dict;
+		elements = 0;
+		return;
+	}
 
-	// Compacting the sequence (a -i value is inserted after the i-th string).
-	int *cdict = new int[processed];
-	uint io = 0, ic = 0, strings = 0;
+	// Compacting the sequence (a -1 value is inserted after each string).
+	// It is compacted in place: ic never overtakes io.
+	int *cdict = dict;
+	size_t io = 0, ic = 0;
 	uint maxseq = 0, currentseq = 0;
 
 	while (io<processed)
@@ -77,9 +86,7 @@ StringDictionaryRPDAC::StringDictionaryRPDAC(IteratorDictString *it)
 			{
 				if (currentseq > maxseq) maxseq = currentseq;
 
-				strings++;
-
-				cdict[ic] = -strings;
+				cdict[ic] = -1;
 				io++; ic++;
 				currentseq = 0;
 			}
@@ -92,19 +99,17 @@ StringDictionaryRPDAC::StringDictionaryRPDAC(IteratorDictString *it)
 		}
 		else
 		{
-			if (io < processed) io = -(dict[io]+1);
+			if (io < processed) io = RePair::skipReplaced(dict, io);
 		}
 	}
 
-	delete [] dict;
-
 	// Building the array for the sequence
 	rp->Cdac = new DAC_VLS(cdict, ic-2, bits(rp->rules+rp->terminals), maxseq);
 
-	delete [] cdict;
+	delete [] dict;
 }
 
-uint 
+size_t 
 StringDictionaryRPDAC::locate(uchar *str, uint strLen)
 {
 	// Binary search comparing s with respect to the corresponding
@@ -162,9 +167,62 @@ StringDictionaryRPDAC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryRPDAC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint *rules;
+		uint len = rp->Cdac->access(id, &rules);
+		uint strLen = 0;
+
+		for (uint i=0; i<len; i++)
+		{
+			if (rules[i] >= rp->terminals) strLen += rp->expandRule(rules[i]-rp->terminals, (buf+strLen));
+			else
+			{
+				buf[strLen] = (uchar)rules[i];
+				strLen++;
+			}
+		}
+
+		buf[strLen] = (uchar)'\0';
+		delete [] rules;
+		return strLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryRPDAC::extractCapacity()
+{
+	return maxlength+1;
+}
+
+void
+StringDictionaryRPDAC::prefetch(size_t id, uint stage)
+{
+	if (rp == NULL) return;
+
+	if (stage == 0) rp->Cdac->prefetch(id);
+	else
+	{
+		size_t pos = id;
+		uint rule = rp->Cdac->access_next(0, &pos);
+
+		if (rule >= rp->terminals) rp->prefetchRule(rule-rp->terminals);
+		if (pos != DAC_VLS::END) rp->Cdac->prefetch(pos);
+	}
+}
+
 IteratorDictID*
 StringDictionaryRPDAC::locatePrefix(uchar *str, uint strLen)
 {
+	// An empty dictionary has no strings with the required prefix
+	if (rp == NULL) return new IteratorDictIDContiguous(NORESULT, NORESULT);
+
 	// Binary search comparing s with respect to the corresponding
 	// pivot rule.
 	size_t left = 1, right = elements, center = 0;
@@ -234,8 +292,8 @@ StringDictionaryRPDAC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint 
-StringDictionaryRPDAC::locateRank(uint rank)
+size_t 
+StringDictionaryRPDAC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -243,6 +301,8 @@ StringDictionaryRPDAC::locateRank(uint rank)
 IteratorDictString*
 StringDictionaryRPDAC::extractPrefix(uchar *str, uint strLen)
 {
+	if (rp == NULL) return NULL;
+
 	IteratorDictIDContiguous *it = (IteratorDictIDContiguous*)locatePrefix(str, strLen);
 
 	size_t offset = it->getLeftLimit()-1;
@@ -260,7 +320,7 @@ StringDictionaryRPDAC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryRPDAC::extractRank(uint rank, uint *strLen)
+StringDictionaryRPDAC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -268,18 +328,32 @@ StringDictionaryRPDAC::extractRank(uint rank, uint *strLen)
 IteratorDictString*
 StringDictionaryRPDAC::extractTable()
 {
+	if (rp == NULL) return NULL;
 	return new IteratorDictStringRPDAC(rp->G, rp->terminals, rp->Cdac, 0, elements, maxlength);
 }
 
+bool
+StringDictionaryRPDAC::good()
+{
+	return rp != NULL;
+}
+
 size_t 
 StringDictionaryRPDAC::getSize()
 {
+	if (rp == NULL) return sizeof(StringDictionaryRPDAC);
 	return rp->getSize()+sizeof(StringDictionaryRPDAC);
 }
 
 void 
 StringDictionaryRPDAC::save(ofstream &out)
 {
+	if (rp == NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+
 	saveValue<uint32_t>(out, type);
 	saveValue<uint64_t>(out, elements);
 	saveValue<uint32_t>(out, maxlength);
@@ -288,14 +362,14 @@ StringDictionaryRPDAC::save(ofstream &out)
 
 
 StringDictionary*
-StringDictionaryRPDAC::load(ifstream &in)
+StringDictionaryRPDAC::load(ifstream &in, const RePairOptions &options)
 {
 	StringDictionaryRPDAC *dict = new StringDictionaryRPDAC();
 
 	dict->type = RPDAC;
 	dict->elements = loadValue<uint64_t>(in);
 	dict->maxlength = loadValue<uint32_t>(in);
-	dict->rp = RePair::load(in);
+	dict->rp = RePair::load(in, options);
 
 	return dict;
 }
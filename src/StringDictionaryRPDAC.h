@@ -66,15 +66,16 @@ class StringDictionaryRPDAC : public StringDictionary
 
 		/** Class Constructor.
 		    @param it: iterator containing the original set of strings.
+		    @param options: options of the RePair compression.
 		*/
-		StringDictionaryRPDAC(IteratorDictString *it);
+		StringDictionaryRPDAC(IteratorDictString *it, const RePairOptions &options=RePairOptions());
 		
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint strLen);
+		size_t locate(uchar *str, uint strLen);
 		
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -83,6 +84,32 @@ class StringDictionaryRPDAC : public StringDictionary
 		      dictionary).
 		 */
 		uchar* extract(size_t id, uint *strLen);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Prefetches the data read to extract an ID (see
+		    StringDictionary::prefetch): the first level of the
+		    DAC (stage 0) and, from its first symbol, the first rule and
+		    the next level (stage 1).
+		    @param id: the ID (valid).
+		    @param stage: the stage (0 or 1).
+		*/
+		void prefetch(size_t id, uint stage);
 		
 		/** Locates all IDs of those elements prefixed by the given 
 		    string.
@@ -104,7 +131,7 @@ class StringDictionaryRPDAC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 		
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -127,7 +154,7 @@ class StringDictionaryRPDAC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 		
 		/** Extracts all strings in the dictionary sorted in 
 		    alphabetical order. 
@@ -135,6 +162,12 @@ class StringDictionaryRPDAC : public StringDictionary
 		*/
 		IteratorDictString* extractTable();
 		
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes. 
 		    @returns the dictionary size in bytes.
 		*/
@@ -147,9 +180,11 @@ class StringDictionaryRPDAC : public StringDictionary
 		
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in);
+		static StringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Generic destructor. */
 		~StringDictionaryRPDAC();
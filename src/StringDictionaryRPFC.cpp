@@ -45,7 +45,7 @@ StringDictionaryRPFC::StringDictionaryRPFC()
 	this->rp = NULL;
 }
 
-StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsize)
+StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsize, const RePairOptions &options)
 {
 
 	this->type = RPFC;
@@ -99,7 +99,7 @@ StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsi
 				reservedInts = Reallocate(&rpdict, reservedInts);
 
 			// Stores the last position with 0 to avoid confusions with 0 values encoding VBytes.
-			uint zero = pbeg-1;
+			size_t zero = pbeg-1;
 
 			for (; pbeg < pend; pbeg++)
 			{
@@ -123,16 +123,27 @@ StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsi
 	delete dict;
 
 	// Obtaining the Re-Pair encoding
-	rp = new RePair(rpdict, ptrpdict, 255);
+	rp = new RePair(rpdict, ptrpdict, 255, options);
+	if (!rp->good())
+	{
+		// The strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] rpdict;
+		textStrings = NULL; blStrings = NULL;
+		elements = 0; buckets = 0;
+		return;
+	}
+
 	bitsrp = rp->getBits();
 
 	vector<size_t> intStrings;				// Encoded internal strings
 	vector<size_t> beginnings(buckets+2);	// Bucket beginnings
 
 	size_t ibytes = 0;
-	uint io = 0, strings = 0;
+	size_t io = 0;
+	size_t strings = 0;
 	beginnings[0] = 0;
-	uint zero = 0;
+	size_t zero = 0;
 
 	while (io<ptrpdict)
 	{
@@ -154,7 +165,7 @@ StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsi
 		}
 		else
 		{
-			if (io < ptrpdict) io = -(rpdict[io]+1);
+			if (io < ptrpdict) io = RePair::skipReplaced(rpdict, io);
 		}
 	}
 
@@ -214,10 +225,11 @@ StringDictionaryRPFC::StringDictionaryRPFC(IteratorDictString *it, uint bucketsi
 	}
 }
 
-uint 
+size_t 
 StringDictionaryRPFC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
+	if (rp == NULL) return id;
 
 	// Locating the candidate bucket for the string
 	size_t idbucket;
@@ -307,9 +319,85 @@ StringDictionaryRPFC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryRPFC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint pos = ((id-1)%bucketsize);
+
+		// The bucket is decoded directly in the buffer
+		uint decLen;
+		uchar *ptr = getHeader(idbucket, buf, &decLen);
+
+		if (pos > 0)
+		{
+			uint offset = 0;
+			for (uint i=1; i<=pos; i++)
+				decodeString(buf, &decLen, &ptr, &offset);
+			decLen--;
+		}
+
+		return decLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryRPFC::extractCapacity()
+{
+	return maxlength;
+}
+
+void
+StringDictionaryRPFC::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	uchar *decoded = new uchar[extractCapacity()];
+	uint i = 0;
+
+	while (i < n)
+	{
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements))
+		{
+			callback(order[i], NULL, 0, data);
+			i++;
+			continue;
+		}
+
+		// The bucket is decoded once for all its IDs (sorted by position), in
+		// the same buffer for all the buckets
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint decLen;
+		uchar *ptr = getHeader(idbucket, decoded, &decLen);
+		uint offset = 0, current = 0;
+
+		for (; (i < n) && (ids[order[i]] <= elements) && (1+((ids[order[i]]-1)/bucketsize) == idbucket); i++)
+		{
+			uint pos = ((ids[order[i]]-1)%bucketsize);
+
+			for (; current < pos; current++)
+				decodeString(decoded, &decLen, &ptr, &offset);
+
+			callback(order[i], decoded, (current > 0) ? decLen-1 : decLen, data);
+		}
+	}
+
+	delete [] decoded;
+	delete [] order;
+}
+
 IteratorDictID*
 StringDictionaryRPFC::locatePrefix(uchar *str, uint strLen)
 {
+	// An empty dictionary has no strings with the required prefix
+	if (rp == NULL) return new IteratorDictIDContiguous(NORESULT, NORESULT);
+
 	size_t leftBucket = 1, rightBucket = buckets;
 	size_t leftID = 0, rightID = 0;
 	uint offset=0;
@@ -391,8 +479,8 @@ StringDictionaryRPFC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint 
-StringDictionaryRPFC::locateRank(uint rank)
+size_t 
+StringDictionaryRPFC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -428,7 +516,7 @@ StringDictionaryRPFC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryRPFC::extractRank(uint rank, uint *strLen)
+StringDictionaryRPFC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -436,54 +524,120 @@ StringDictionaryRPFC::extractRank(uint rank, uint *strLen)
 IteratorDictString*
 StringDictionaryRPFC::extractTable()
 {
+	if (rp == NULL) return NULL;
 	return new IteratorDictStringRPFC(rp, bitsrp, textStrings, 0, bucketsize, elements, maxlength);
 }
 
+bool
+StringDictionaryRPFC::good()
+{
+	return rp != NULL;
+}
+
 size_t 
 StringDictionaryRPFC::getSize()
 {
+	if (rp == NULL) return sizeof(StringDictionaryRPFC);
 	return bytesStrings*sizeof(uchar)+blStrings->getSize()+rp->getSize()+sizeof(StringDictionaryRPFC);
 }
 
-void 
+void
 StringDictionaryRPFC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, buckets);
-	saveValue<uint32_t>(out, bucketsize);
-
-
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-	blStrings->save(out);
+	if (rp == NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
 
-	saveValue<uint32_t>(out, bitsrp);
-	rp->save(out);
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
-StringDictionaryRPFC::load(ifstream &in)
+StringDictionaryRPFC::load(ifstream &in, const RePairOptions &options)
 {
 	StringDictionaryRPFC *dict = new StringDictionaryRPFC();
 
-	dict->type = RPFC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->buckets = loadValue<uint32_t>(in);
-	dict->bucketsize = loadValue<uint32_t>(in);
-
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->blStrings = new LogSequence(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
-	dict->bitsrp = loadValue<uint32_t>(in);
-	dict->rp = RePair::loadNoSeq(in);
-	
 	return dict;
 }
 
+uint
+StringDictionaryRPFC::numSections()
+{
+	return SECTIONS;
+}
+
+void
+StringDictionaryRPFC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, buckets);
+			saveValue<uint32_t>(out, bucketsize);
+			break;
+		}
+		case 1:
+		{
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2: blStrings->save(out); break;
+		case 3:
+		{
+			saveValue<uint32_t>(out, bitsrp);
+			rp->save(out);
+			break;
+		}
+	}
+}
+
+bool
+StringDictionaryRPFC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			buckets = loadValue<uint32_t>(in);
+			bucketsize = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			return in.good();
+		}
+		case 2: blStrings = new LogSequence(in); return in.good();
+		case 3:
+		{
+			bitsrp = loadValue<uint32_t>(in);
+			rp = RePair::loadNoSeq(in, options);
+			return rp != NULL;
+		}
+	}
+	return false;
+}
+
 
 inline uchar*
 StringDictionaryRPFC::getHeader(size_t idbucket, uchar **str, uint *strLen)
@@ -497,6 +651,17 @@ StringDictionaryRPFC::getHeader(size_t idbucket, uchar **str, uint *strLen)
 	return ptr+(*strLen)+1;
 }
 
+inline uchar*
+StringDictionaryRPFC::getHeader(size_t idbucket, uchar *str, uint *strLen)
+{
+	uchar *ptr = textStrings+blStrings->getField(idbucket);
+	*strLen = strlen((char*)ptr);
+
+	strncpy((char*)str, (char*)ptr, *strLen+1);
+
+	return ptr+(*strLen)+1;
+}
+
 bool 
 StringDictionaryRPFC::locateBucket(uchar *str, size_t *idbucket)
 {
@@ -730,7 +895,7 @@ StringDictionaryRPFC::decodeString(uchar *str, uint *strLen, uchar **ptr, uint *
 
 StringDictionaryRPFC::~StringDictionaryRPFC()
 {
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (blStrings != NULL) delete blStrings;
 	if (rp != NULL) delete rp;
 }
@@ -78,8 +78,9 @@ class StringDictionaryRPFC : public StringDictionary
 		/** Class Constructor.
 		    @param it: iterator scanning the original set of strings.
 		    @param bucketsize: number of strings represented per bucket.
+		    @param options: options of the RePair compression.
 		*/
-		StringDictionaryRPFC(IteratorDictString *it, uint bucketsize);
+		StringDictionaryRPFC(IteratorDictString *it, uint bucketsize, const RePairOptions &options=RePairOptions());
 
 
 		StringDictionaryRPFC(uchar *file);
@@ -90,7 +91,7 @@ class StringDictionaryRPFC : public StringDictionary
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 		
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -99,6 +100,36 @@ class StringDictionaryRPFC : public StringDictionary
 		      dictionary).
 		 */
 		uchar* extract(size_t id, uint *strLen);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Decodes the strings associated with a batch of IDs, grouping
+		    the IDs by bucket and decoding each bucket once, in a single
+		    forward pass, for all its IDs.
+		    @param ids: the IDs to be extracted.
+		    @param n: number of IDs.
+		    @param callback: function called for each ID (in increasing
+		      order of ID) with its string, which is only valid during
+		      the call.
+		    @param data: user data given to the callback.
+		*/
+		void extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data);
+		using StringDictionary::extractBatch;
 		
 		/** Locates all IDs of those elements prefixed by the given 
 		    string.
@@ -120,7 +151,7 @@ class StringDictionaryRPFC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 		
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -143,7 +174,7 @@ class StringDictionaryRPFC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 		
 		/** Extracts all strings in the dictionary sorted in 
 		    alphabetical order. 
@@ -151,6 +182,12 @@ class StringDictionaryRPFC : public StringDictionary
 		*/
 		IteratorDictString* extractTable();
 		
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes. 
 		    @returns the dictionary size in bytes.
 		*/
@@ -163,14 +200,22 @@ class StringDictionaryRPFC : public StringDictionary
 		
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in);
+		static StringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Generic destructor. */
 		~StringDictionaryRPFC();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the strings, 2 their positions and 3 the RePair
+		static const uint SECTIONS = 4;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		uint32_t buckets;		//! Number of total buckets in the dictionary
 		uint32_t bucketsize;	//! Number of strings per bucket
 
@@ -189,6 +234,15 @@ class StringDictionaryRPFC : public StringDictionary
 		*/
 		inline uchar *getHeader(size_t idbucket, uchar **str, uint *strLen);
 
+		/** Obtaining the header string for the given bucket in a
+		    given buffer (of maxlength chars).
+		    @param idbucket: the bucket.
+		    @param str: the buffer for the header string.
+		    @param strLen: pointer to the header length.
+		    @returns pointer to the next unprocessed char.
+		*/
+		inline uchar *getHeader(size_t idbucket, uchar *str, uint *strLen);
+
 		/** Locates the candidate bucket in which the given string can
 		    be represented.
 		    @param str: the encoded string to be located.
@@ -49,7 +49,7 @@ StringDictionaryRPHTFC::StringDictionaryRPHTFC()
 	this->rp = NULL;
 }
 
-StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint bucketsize)
+StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint bucketsize, const RePairOptions &options)
 {
 	this->type = RPHTFC;
 
@@ -108,7 +108,7 @@ StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint buck
 			reservedInts = Reallocate(&rpdict, reservedInts);
 
 		// Stores the last position with 0 to avoid confusions with 0 values encoding VBytes.
-		uint zero = pbeg-1;
+		size_t zero = pbeg-1;
 
 		// Extracting the internal strings for Re-Pair compression
 		for (; pbeg < pend; pbeg++)
@@ -140,16 +140,28 @@ StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint buck
 	delete dict;
 
 	// Obtaining the Re-Pair encoding
-	rp = new RePair(rpdict, ptrpdict, 255);
+	rp = new RePair(rpdict, ptrpdict, 255, options);
+	if (!rp->good())
+	{
+		// The strings cannot be compressed: the dictionary is left empty
+		delete rp; rp = NULL;
+		delete [] rpdict; delete builderHT;
+		textStrings = NULL; blStrings = NULL;
+		coderHT = NULL; tableHT = NULL;
+		elements = 0; buckets = 0;
+		return;
+	}
+
 	bitsrp = rp->getBits();
 
 	vector<size_t> intStrings;				// Encoded internal strings
 	vector<size_t> beginnings(buckets+2);	// Bucket beginnings
 
 	size_t ibytes = 0;
-	uint io = 0, strings = 0;
+	size_t io = 0;
+	size_t strings = 0;
 	beginnings[0] = 0;
-	uint zero = 0;
+	size_t zero = 0;
 
 	while (io<ptrpdict)
 	{
@@ -171,7 +183,7 @@ StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint buck
 		}
 		else
 		{
-			if (io < ptrpdict) io = -(rpdict[io]+1);
+			if (io < ptrpdict) io = RePair::skipReplaced(rpdict, io);
 		}
 	}
 
@@ -314,10 +326,11 @@ StringDictionaryRPHTFC::StringDictionaryRPHTFC(IteratorDictString *it, uint buck
 }
 
 
-uint 
+size_t 
 StringDictionaryRPHTFC::locate(uchar *str, uint strLen)
 {
-	uint id = NORESULT;
+	size_t id = NORESULT;
+	if (rp == NULL) return id;
 
 	// Encoding the string
 	uint encLen, offset;
@@ -406,9 +419,82 @@ StringDictionaryRPHTFC::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryRPHTFC::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if (cap < extractCapacity()) return StringDictionary::extractInto(id, buf, cap);
+
+	if ((id > 0) && (id <= elements))
+	{
+		uint idbucket = 1+((id-1)/bucketsize);
+		uint pos = ((id-1)%bucketsize);
+
+		// The bucket is decoded directly in the buffer
+		ChunkScan c = decodeHeader(idbucket, buf);
+
+		if (pos > 0)
+		{
+			uint offset = 0;
+			for (uint i=1; i<=pos; i++)
+				decodeString(c.str, &c.strLen, &c.b_ptr, &offset);
+		}
+
+		return c.strLen-1;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryRPHTFC::extractCapacity()
+{
+	return 4*maxlength+tableHT->getK();
+}
+
+void
+StringDictionaryRPHTFC::extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data)
+{
+	uint *order = sortBatch(ids, n);
+	uchar *buffer = new uchar[extractCapacity()];
+	uint i = 0;
+
+	while (i < n)
+	{
+		size_t id = ids[order[i]];
+
+		if ((id == 0) || (id > elements))
+		{
+			callback(order[i], NULL, 0, data);
+			i++;
+			continue;
+		}
+
+		// The bucket is decoded once for all its IDs (sorted by position), in
+		// the same buffer for all the buckets
+		uint idbucket = 1+((id-1)/bucketsize);
+		ChunkScan c = decodeHeader(idbucket, buffer);
+		uint offset = 0, current = 0;
+
+		for (; (i < n) && (ids[order[i]] <= elements) && (1+((ids[order[i]]-1)/bucketsize) == idbucket); i++)
+		{
+			uint pos = ((ids[order[i]]-1)%bucketsize);
+
+			for (; current < pos; current++)
+				decodeString(c.str, &c.strLen, &c.b_ptr, &offset);
+
+			callback(order[i], c.str, c.strLen-1, data);
+		}
+	}
+
+	delete [] buffer;
+	delete [] order;
+}
+
 IteratorDictID*
 StringDictionaryRPHTFC::locatePrefix(uchar *str, uint strLen)
 {
+	// An empty dictionary has no strings with the required prefix
+	if (rp == NULL) return new IteratorDictIDContiguous(NORESULT, NORESULT);
+
 	// Encoding the string
 	uint encLen, offset=0;
 	uchar *encoded = coderHT->encodeString(str, strLen, &encLen, &offset);
@@ -493,8 +579,8 @@ StringDictionaryRPHTFC::locateSubstr(uchar *str, uint strLen)
 	return NULL;
 }
 
-uint 
-StringDictionaryRPHTFC::locateRank(uint rank)
+size_t 
+StringDictionaryRPHTFC::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -528,7 +614,7 @@ StringDictionaryRPHTFC::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryRPHTFC::extractRank(uint rank, uint *strLen)
+StringDictionaryRPHTFC::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -536,60 +622,133 @@ StringDictionaryRPHTFC::extractRank(uint rank, uint *strLen)
 IteratorDictString*
 StringDictionaryRPHTFC::extractTable()
 {
+	if (rp == NULL) return NULL;
 	return new IteratorDictStringRPHTFC(tableHT, codewordsHT, rp, bitsrp, textStrings, blStrings, 1, 0, bucketsize, elements, maxlength, maxcomplength);
 }
 
+bool
+StringDictionaryRPHTFC::good()
+{
+	return rp != NULL;
+}
+
 size_t 
 StringDictionaryRPHTFC::getSize()
 {
+	if (rp == NULL) return sizeof(StringDictionaryRPHTFC);
 	return bytesStrings*sizeof(uchar)+blStrings->getSize()+256*sizeof(Codeword)+tableHT->getSize()+rp->getSize()+sizeof(StringDictionaryRPHTFC);
 }
 
-void 
+void
 StringDictionaryRPHTFC::save(ofstream &out)
 {
-	saveValue<uint32_t>(out, type);
-	saveValue<uint64_t>(out, elements);
-	saveValue<uint32_t>(out, maxlength);
-	saveValue<uint32_t>(out, maxcomplength);
-	saveValue<uint32_t>(out, buckets);
-	saveValue<uint32_t>(out, bucketsize);
-
-	saveValue<uint64_t>(out, bytesStrings);
-	saveValue<uchar>(out, textStrings, bytesStrings);
-	blStrings->save(out);
-
-	saveValue<Codeword>(out, codewordsHT, 256);
-	tableHT->save(out);
-
-	saveValue<uint32_t>(out, bitsrp);
-	rp->save(out);
+	if (rp == NULL)
+	{
+		cerr << "[ERROR] The dictionary was not built and cannot be saved" << endl;
+		return;
+	}
+
+	//the sections are stored back to back
+	for (uint s=0; s<SECTIONS; s++)
+		saveSection(s, out);
 }
 
 StringDictionary*
-StringDictionaryRPHTFC::load(ifstream &in)
+StringDictionaryRPHTFC::load(ifstream &in, const RePairOptions &options)
 {
 	StringDictionaryRPHTFC *dict = new StringDictionaryRPHTFC();
 
-	dict->type = RPHTFC;
-	dict->elements = loadValue<uint64_t>(in);
-	dict->maxlength = loadValue<uint32_t>(in);
-	dict->maxcomplength = loadValue<uint32_t>(in);
-	dict->buckets = loadValue<uint32_t>(in);
-	dict->bucketsize = loadValue<uint32_t>(in);
+	for (uint s=0; s<SECTIONS; s++)
+	{
+		if (!dict->loadSection(s, in, options))
+		{
+			delete dict;
+			return NULL;
+		}
+	}
 
-	dict->bytesStrings = loadValue<uint64_t>(in);
-	dict->textStrings = loadValue<uchar>(in, dict->bytesStrings);
-	dict->blStrings = new LogSequence(in);
+	return dict;
+}
 
-	dict->codewordsHT = loadValue<Codeword>(in, 256);
-	dict->tableHT = DecodingTable::load(in);
-	dict->coderHT = new StatCoder(dict->tableHT, dict->codewordsHT);
+uint
+StringDictionaryRPHTFC::numSections()
+{
+	return SECTIONS;
+}
 
-	dict->bitsrp = loadValue<uint32_t>(in);
-	dict->rp = RePair::loadNoSeq(in);
-	
-	return dict;
+void
+StringDictionaryRPHTFC::saveSection(uint section, ofstream &out)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			saveValue<uint32_t>(out, type);
+			saveValue<uint64_t>(out, elements);
+			saveValue<uint32_t>(out, maxlength);
+			saveValue<uint32_t>(out, maxcomplength);
+			saveValue<uint32_t>(out, buckets);
+			saveValue<uint32_t>(out, bucketsize);
+			break;
+		}
+		case 1:
+		{
+			saveValue<uint64_t>(out, bytesStrings);
+			MappedFile::saveArray<uchar>(out, textStrings, bytesStrings);
+			break;
+		}
+		case 2: blStrings->save(out); break;
+		case 3:
+		{
+			saveValue<Codeword>(out, codewordsHT, 256);
+			tableHT->save(out);
+			break;
+		}
+		case 4:
+		{
+			saveValue<uint32_t>(out, bitsrp);
+			rp->save(out);
+			break;
+		}
+	}
+}
+
+bool
+StringDictionaryRPHTFC::loadSection(uint section, ifstream &in, const RePairOptions &options)
+{
+	switch (section)
+	{
+		case 0:
+		{
+			elements = loadValue<uint64_t>(in);
+			maxlength = loadValue<uint32_t>(in);
+			maxcomplength = loadValue<uint32_t>(in);
+			buckets = loadValue<uint32_t>(in);
+			bucketsize = loadValue<uint32_t>(in);
+			return in.good();
+		}
+		case 1:
+		{
+			bytesStrings = loadValue<uint64_t>(in);
+			textStrings = MappedFile::loadArray<uchar>(in, bytesStrings);
+			return in.good();
+		}
+		case 2: blStrings = new LogSequence(in); return in.good();
+		case 3:
+		{
+			codewordsHT = loadValue<Codeword>(in, 256);
+			tableHT = DecodingTable::load(in);
+			coderHT = new StatCoder(tableHT, codewordsHT);
+			return in.good();
+		}
+		case 4:
+		{
+			bitsrp = loadValue<uint32_t>(in);
+			rp = RePair::loadNoSeq(in, options);
+			return rp != NULL;
+		}
+	}
+	return false;
 }
 
 uchar*
@@ -602,10 +761,11 @@ StringDictionaryRPHTFC::getHeader(size_t idbucket)
 }
 
 ChunkScan
-StringDictionaryRPHTFC::decodeHeader(size_t idbucket)
+StringDictionaryRPHTFC::decodeHeader(size_t idbucket, uchar *buffer)
 {
 	uchar* ptr = textStrings+blStrings->getField(idbucket);
-	ChunkScan chunk = {0, 0, ptr, maxcomplength, new uchar[4*maxlength+tableHT->getK()], 0, 0, 1};
+	if (buffer == NULL) buffer = new uchar[4*maxlength+tableHT->getK()];
+	ChunkScan chunk = {0, 0, ptr, maxcomplength, buffer, 0, 0, 1};
 
 	// Variables used for adjusting purposes
 	uint plen = 0;
@@ -890,7 +1050,7 @@ StringDictionaryRPHTFC::decodeString(uchar *str, uint *strLen, uchar **ptr, uint
 
 StringDictionaryRPHTFC::~StringDictionaryRPHTFC()
 {
-	if (textStrings != NULL) delete [] textStrings;
+	MappedFile::deleteArray(textStrings);
 	if (blStrings != NULL) delete blStrings;
 	if (coderHT != NULL) delete coderHT;
 	if (codewordsHT != NULL) delete [] codewordsHT;
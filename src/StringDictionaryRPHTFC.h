@@ -80,15 +80,16 @@ class StringDictionaryRPHTFC : public StringDictionary
 		/** Class Constructor.
 		    @param it: iterator scanning the original set of strings.
 		    @param bucketsize: number of strings represented per bucket.
+		    @param options: options of the RePair compression.
 		*/
-		StringDictionaryRPHTFC(IteratorDictString *it, uint bucketsize);
+		StringDictionaryRPHTFC(IteratorDictString *it, uint bucketsize, const RePairOptions &options=RePairOptions());
 		
 		/** Retrieves the ID corresponding to the given string.
 		    @param str: the string to be searched.
 		    @param strLen: the string length.
 		    @returns the ID (or NORESULT if it is not in the bucket).
 		*/
-		uint locate(uchar *str, uint str_length);
+		size_t locate(uchar *str, uint str_length);
 		
 		/** Obtains the string associated with the given ID.
 		    @param id: the ID to be extracted.
@@ -97,6 +98,36 @@ class StringDictionaryRPHTFC : public StringDictionary
 		      dictionary).
 		 */
 		uchar* extract(size_t id, uint *strLen);
+
+		/** Obtains the string associated with the given ID into a
+		    buffer, decoding it in place if the buffer has (at least)
+		    extractCapacity() bytes.
+		    @param id: the ID to be extracted.
+		    @param buf: the buffer.
+		    @param cap: the buffer size.
+		    @returns the string length (0 if it is not in the
+		      dictionary).
+		*/
+		uint extractInto(size_t id, uchar *buf, size_t cap);
+
+		/** Retrieves the buffer size with which extractInto decodes
+		    any string in place.
+		    @returns the size in bytes.
+		*/
+		size_t extractCapacity();
+
+		/** Decodes the strings associated with a batch of IDs, grouping
+		    the IDs by bucket and decoding each bucket once, in a single
+		    forward pass, for all its IDs.
+		    @param ids: the IDs to be extracted.
+		    @param n: number of IDs.
+		    @param callback: function called for each ID (in increasing
+		      order of ID) with its string, which is only valid during
+		      the call.
+		    @param data: user data given to the callback.
+		*/
+		void extractBatch(size_t *ids, uint n, ExtractCallback callback, void *data);
+		using StringDictionary::extractBatch;
 		
 		/** Locates all IDs of those elements prefixed by the given 
 		    string.
@@ -118,7 +149,7 @@ class StringDictionaryRPHTFC : public StringDictionary
 		    @param rank: the alphabetical ranking.
 		    @returns the ID.
 		*/
-		uint locateRank(uint rank);
+		size_t locateRank(size_t rank);
 		
 		/** Extracts all elements prefixed by the given string.
 		    @param str: the prefix to be searched.
@@ -141,7 +172,7 @@ class StringDictionaryRPHTFC : public StringDictionary
 		    @returns the requested string (or NULL if it is not in the
 		      dictionary).
 		*/
-		uchar* extractRank(uint rank, uint *strLen);
+		uchar* extractRank(size_t rank, uint *strLen);
 		
 		/** Extracts all strings in the dictionary sorted in 
 		    alphabetical order. 
@@ -149,6 +180,12 @@ class StringDictionaryRPHTFC : public StringDictionary
 		*/
 		IteratorDictString* extractTable();
 		
+		/** Checks if the dictionary was built (the RePair compression
+		    of its strings can fail).
+		    @returns false if it could not be built.
+		*/
+		bool good();
+
 		/** Computes the size of the structure in bytes. 
 		    @returns the dictionary size in bytes.
 		*/
@@ -161,14 +198,22 @@ class StringDictionaryRPHTFC : public StringDictionary
 		
 		/** Loads a dictionary from an ifstream.
 		    @param in: the ifstream.
+		    @param options: options of the RePair encodings (only the
+		      summaries are used).
 		    @returns the loaded dictionary.
 		*/
-		static StringDictionary *load(ifstream &in);
+		static StringDictionary *load(ifstream &in, const RePairOptions &options=RePairOptions());
 
 		/** Generic destructor. */
 		~StringDictionaryRPHTFC();
 
 	protected:
+		//sections of the mapped layout: 0 the sizes, 1 the strings, 2 their positions, 3 the Hu-Tucker decoder and 4 the RePair
+		static const uint SECTIONS = 5;
+		uint numSections();
+		void saveSection(uint section, ofstream &out);
+		bool loadSection(uint section, ifstream &in, const RePairOptions &options);
+
 		uint32_t maxcomplength;	//! The largest compressed header
 
 		uint32_t buckets;		//! Number of total buckets in the dictionary
@@ -193,9 +238,11 @@ class StringDictionaryRPHTFC : public StringDictionary
 
 		/** Decodes the first string in the bucket. 
 		    @idbucket: the bucket storing the required header.
+		    @buffer: buffer for the decoded strings (of
+		      extractCapacity() chars), allocated if NULL.
 		    @returns the scanning data
 		*/
-		inline ChunkScan decodeHeader(size_t idbucket);
+		inline ChunkScan decodeHeader(size_t idbucket, uchar *buffer=NULL);
 
 		/** Locates the candidate bucket in which the given string can
 		    be represented.
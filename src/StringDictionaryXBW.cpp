@@ -124,7 +124,7 @@ StringDictionaryXBW::StringDictionaryXBW(IteratorDictString *it, bool sparse_bit
 	xbw->build(len, mapping, alpha, last, A, sparse_bitsequence, bparam);
 }
 
-uint 
+size_t 
 StringDictionaryXBW::locate(uchar *str, uint strLen)
 {
 	uchar *qry = new uchar[strLen+1];
@@ -158,6 +158,28 @@ StringDictionaryXBW::extract(size_t id, uint *strLen)
 	}
 }
 
+uint
+StringDictionaryXBW::extractInto(size_t id, uchar *buf, size_t cap)
+{
+	if ((id > 0) && (id <= elements))
+	{
+		// The path is written while it fits in the buffer
+		uint strLen;
+		xbw->idToStr(xbw->alpha->select(xbw->maxLabel, id), &strLen, buf, cap);
+		strLen--;
+		if (strLen < cap) buf[strLen] = 0;
+
+		return strLen;
+	}
+	else return 0;
+}
+
+size_t
+StringDictionaryXBW::extractCapacity()
+{
+	return maxlength+1;
+}
+
 IteratorDictID*
 StringDictionaryXBW::locatePrefix(uchar *str, uint strLen)
 {
@@ -186,8 +208,8 @@ StringDictionaryXBW::locateSubstr(uchar *str, uint strLen)
 	else return new IteratorDictIDContiguous(NORESULT, NORESULT);
 }
 
-uint 
-StringDictionaryXBW::locateRank(uint rank)
+size_t 
+StringDictionaryXBW::locateRank(size_t rank)
 {
 	return rank;
 }
@@ -218,7 +240,7 @@ StringDictionaryXBW::extractSubstr(uchar *str, uint strLen)
 }
 
 uchar *
-StringDictionaryXBW::extractRank(uint rank, uint *strLen)
+StringDictionaryXBW::extractRank(size_t rank, uint *strLen)
 {
 	return extract(rank, strLen);
 }
@@ -154,6 +154,18 @@ void XBW::idToStr(uint id, uint *pos, uchar ** v, uint cnt) const {
 	(*pos)++;
 }
 
+void XBW::idToStr(uint id, uint *pos, uchar * v, uint cap) const {
+	if(id==1) {
+		*pos = 0;
+		return;
+	}
+
+	idToStr(getParent(id),pos,v,cap);
+
+	if(*pos < cap) v[*pos] = unmap[alpha->access(id)];
+	(*pos)++;
+}
+
 void XBW::subPathSearch(const uchar * qry, const uint ql, uint *left, uint *right) const {
 	if (ql <= 1)
 	{
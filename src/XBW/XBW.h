@@ -82,6 +82,7 @@ public:
 
 	uint getId(const uchar * qry, const uint ql) const;
 	void idToStr(uint id, uint *pos, uchar ** v, uint cnt) const;
+	void idToStr(uint id, uint *pos, uchar * v, uint cap) const;
 
 	/** Returns the size of the XBW structure */
 	uint size() const;
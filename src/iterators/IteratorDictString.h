@@ -53,7 +53,7 @@ class IteratorDictString
 		virtual ~IteratorDictString() {} ;
 
 		/** Returns the remaining strings to be retrieved */
-		uint size() { return scanneable-processed; }
+		size_t size() { return scanneable-processed; }
 
 
 	protected:
@@ -63,6 +63,7 @@ class IteratorDictString
 };
 
 #include "IteratorDictStringPlain.h"
+#include "IteratorDictStringMapped.h"
 #include "IteratorDictStringVector.h"
 
 #include "IteratorDictStringPFC.h"
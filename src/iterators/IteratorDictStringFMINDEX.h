@@ -45,7 +45,7 @@ class IteratorDictStringFMINDEX : public IteratorDictString
 		    @last: the last valid id in the dictionary
 		    @maxlength: the length of the largest string in the dictionary
 		*/
-	    	IteratorDictStringFMINDEX(SSA *fm_index, uint first, size_t scanneable, uint last, uint maxlength)
+	    	IteratorDictStringFMINDEX(SSA *fm_index, size_t first, size_t scanneable, size_t last, uint maxlength)
 		{ 
 		    	this->fm_index = fm_index;
 		    	this->maxlength = maxlength;
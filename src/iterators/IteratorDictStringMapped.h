@@ -0,0 +1,95 @@
+/* IteratorDictStringMapped.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Iterator class for scanning a file of strings delimited by '\0' symbols
+ * without loading it: the file is mapped in memory, so its pages are read
+ * on demand and, being backed by the file, they can be evicted instead of
+ * counting against the memory of the build. The file is only read into
+ * memory when it cannot be mapped or its last string is not delimited.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _ITERATORDICTSTRINGMAPPED_H
+#define _ITERATORDICTSTRINGMAPPED_H
+
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+#include "../utils/MappedFile.h"
+
+class IteratorDictStringMapped : public IteratorDictStringPlain 
+{
+	public:
+		/** Constructor for the Mapped Iterator: 
+		    @path: the file of strings.
+		*/
+	    	IteratorDictStringMapped(const char *path) : IteratorDictStringPlain(NULL, 0)
+		{
+			this->file = NULL;
+			this->loaded = false;
+
+			MappedFile *mapping = new MappedFile(path);
+			if(mapping->good() && (mapping->getData()[mapping->getLength()-1] == '\0'))
+			{
+				//the strings are only read, so the read-only mapping is used as the array
+				this->file = mapping;
+				this->arr = (uchar*)mapping->getData();
+				this->scanneable = mapping->getLength();
+				return;
+			}
+			delete mapping;
+
+			ifstream in(path);
+			if(!in.good()) return;
+			in.seekg(0,ios_base::end);
+			this->scanneable = in.tellg()/sizeof(uchar);
+			in.seekg(0,ios_base::beg);
+			this->arr = loadValue<uchar>(in, scanneable+1);
+			this->arr[scanneable] = '\0';
+			in.close();
+			this->loaded = true;
+		}
+
+		/** Checks if the file could be read.
+		    @returns true if the strings are available.
+		*/
+		bool good()
+		{
+			return (file!=NULL) || loaded;
+		}
+
+		/** Generic destructor. */
+		~IteratorDictStringMapped() 
+		{
+			if(file!=NULL)
+			{
+				delete file;
+				arr = NULL; //the mapping is not released by IteratorDictStringPlain
+			}
+		}
+
+	protected:
+		MappedFile *file;	// The mapping of the file (NULL if it was read)
+		bool loaded;		// The file was read into memory
+};
+
+#endif  
@@ -0,0 +1,84 @@
+/* IteratorDictStringView.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Iterator class for scanning the strings of a stream of IDs without
+ * allocating them: each string is extracted (with extractInto) in a buffer
+ * of the iterator, which is reused by the next one.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _ITERATORDICTSTRINGVIEW_H
+#define _ITERATORDICTSTRINGVIEW_H
+
+#include "../StringDictionary.h"
+
+using namespace std;
+
+class IteratorDictStringView
+{
+	public:
+		/** Constructor for the View Iterator:
+		    @dict: the dictionary storing the strings.
+		    @ids: the iterator with the IDs to be extracted (it is deleted
+		      with this iterator).
+		*/
+		IteratorDictStringView(StringDictionary *dict, IteratorDictID *ids)
+		{
+			this->dict = dict;
+			this->ids = ids;
+			this->capacity = dict->extractCapacity();
+			this->buffer = new uchar[capacity];
+		}
+
+		/** Checks for non-processed strings in the stream.
+		    @returns if remains non-processed strings.
+		*/
+		bool hasNext()
+		{
+			return ids->hasNext();
+		}
+
+		/** Extracts the next string in the stream. It is only valid
+		    until the next call, and it must not be deleted.
+		    @param strLen pointer to the string length.
+		    @returns the next string.
+		*/
+		uchar* next(uint *strLen)
+		{
+			*strLen = dict->extractInto(ids->next(), buffer, capacity);
+			return buffer;
+		}
+
+		/** Generic destructor. */
+		~IteratorDictStringView()
+		{
+			delete ids;
+			delete [] buffer;
+		}
+
+	protected:
+		StringDictionary *dict;	// Dictionary holding the strings
+		IteratorDictID *ids;	// The IDs to be extracted
+		uchar *buffer;	// Buffer for the current string
+		size_t capacity;	// Buffer size
+};
+
+#endif
@@ -39,10 +39,12 @@ class IteratorRankedDictIDNoContiguous : public IteratorRankedDictID
 		/** ID Iterator Constructor for streams of contiguous elements.
 		    @param ids: the array of ids
 		    @param scanneable: the number of ids in the array
+		    @param owner: true if the array is freed with the iterator
 		*/
-		IteratorRankedDictIDNoContiguous(size_t *ids, size_t scanneable)
+		IteratorRankedDictIDNoContiguous(size_t *ids, size_t scanneable, bool owner=true)
 		{
 			this->ids = ids;
+			this->owner = owner;
 			this->scanneable = scanneable;
 
 			this->processed = 0;
@@ -54,10 +56,11 @@ class IteratorRankedDictIDNoContiguous : public IteratorRankedDictID
 	        size_t next() { return ids[processed++]; }
 
 		/** Generic destructor */
-		~IteratorRankedDictIDNoContiguous() { delete [] ids; }
+		~IteratorRankedDictIDNoContiguous() { if (owner) delete [] ids; }
 
 	protected:
 		size_t *ids;	// Array of ids
+		bool owner;	// If the array is freed with the iterator
 };
 
 #endif  
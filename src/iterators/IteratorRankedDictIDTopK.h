@@ -0,0 +1,98 @@
+/* IteratorRankedDictIDTopK.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Iterator class for scanning lazily the IDs of a top k query over the
+ * RankedStringDictionaryRPDAC: each ID is computed when it is requested, so
+ * k is not fixed in advance and the query can be resumed later.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _ITERATORRANKEDDICTIDTOPK_H
+#define _ITERATORRANKEDDICTIDTOPK_H
+
+
+#include <iostream>
+using namespace std;
+
+class IteratorRankedDictIDTopK : public IteratorRankedDictID
+{
+	public:
+		/** ID Iterator Constructor for lazy top k queries.
+		    @param dict: the dictionary queried.
+		    @param frontier: the state of the query (it is deleted with the iterator).
+		*/
+		IteratorRankedDictIDTopK(RankedStringDictionaryRPDAC *dict, RankedTopKFrontier *frontier)
+		{
+			this->dict = dict;
+			this->frontier = frontier;
+			this->processed = 0;
+			this->lastId = frontier->minId; //a token taken before the first ID resumes at the same point
+			this->lastPosition = 0;
+
+			//the next ID is always computed in advance, so scanneable is one more than processed while there are IDs
+			nextId = dict->nextTopK(frontier, &nextPosition);
+			this->scanneable = (nextId!=0) ? 1 : 0;
+		}
+
+		/** Extracts the next ID in the stream (the lowest ID not returned yet).
+		    @returns the next ID.
+		*/
+		size_t next()
+		{
+			lastId = nextId;
+			lastPosition = nextPosition;
+			processed++;
+
+			nextId = dict->nextTopK(frontier, &nextPosition);
+			if(nextId!=0) scanneable++;
+
+			return lastId;
+		}
+
+		/** Retrieves the position in the RPDAC of the last ID returned.
+		    @returns the position.
+		*/
+		size_t getPosition() { return lastPosition; }
+
+		/** Obtains the token for continuing the query after the last ID
+		    returned (e.g. for the next page of results).
+		    @returns the token.
+		*/
+		RankedTopKToken getToken()
+		{
+			RankedTopKToken token;
+			token.first = frontier->first;
+			token.last = frontier->last;
+			token.lastId = lastId;
+			return token;
+		}
+
+		/** Generic destructor */
+		~IteratorRankedDictIDTopK() { delete frontier; }
+
+	protected:
+		RankedStringDictionaryRPDAC *dict; // The dictionary queried
+		RankedTopKFrontier *frontier; // The state of the query
+		size_t nextId, nextPosition; // The next ID (0 if there are no more) and its position
+		size_t lastId, lastPosition; // The last ID returned and its position
+};
+
+#endif  
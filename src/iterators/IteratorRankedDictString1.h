@@ -51,6 +51,12 @@ class IteratorRankedDictString1 : public IteratorRankedDictString
 			this->iter = iter;
 			this->mDict = dict;
 			this->perm = perm;
+
+			this->window = new size_t[WINDOW];
+			this->windowStrings = new uchar*[WINDOW];
+			this->windowLens = new uint[WINDOW];
+			this->windowSize = 0;
+			this->windowPos = 0;
 		}
 
 
@@ -64,15 +70,13 @@ class IteratorRankedDictString1 : public IteratorRankedDictString
 		{
             processed++;
 
-            uint aux;
-
-            //get the position in the ordered iterator (the lexicographically position
-            uint orderedId = iter->next()-1;
-
-            //get the string from the dictionary taking the ranked ordered element (using the permutation)
-            uchar* result = mDict->extract(perm->pi(orderedId), &aux);
+            //the strings are extracted by windows, so the dictionary decodes each bucket once per window
+            if(windowPos==windowSize)
+            	fill();
 
-			*str_length = strlen((char*)(result));
+			uchar* result = windowStrings[windowPos];
+			*str_length = windowLens[windowPos];
+			windowPos++;
 
 			return result;
 		}
@@ -91,12 +95,47 @@ class IteratorRankedDictString1 : public IteratorRankedDictString
 
 
 
+		/** Generic destructor. */
+		~IteratorRankedDictString1()
+		{
+			//the strings prefetched and not returned are freed
+			for(uint i=windowPos; i<windowSize; i++)
+				delete [] windowStrings[i];
+			delete [] window;
+			delete [] windowStrings;
+			delete [] windowLens;
+		}
+
+
+
+
 
 
     protected:
         Permutation * perm; //The permutation saving the ranked order
         StringDictionary * mDict; //Dictionary holding the strings
         IteratorDictID * iter; //The lexicographically ordered ids
+
+        static const uint WINDOW = 64; //strings extracted together
+        size_t * window; //positions in the dictionary of the current window
+        uchar ** windowStrings; //strings of the current window
+        uint * windowLens; //their lengths
+        uint windowSize; //strings in the current window
+        uint windowPos; //next string of the window to return
+
+        //extracts the strings of the next window
+        void fill()
+        {
+        	windowSize = 0;
+        	windowPos = 0;
+        	while(windowSize<WINDOW && processed+windowSize<=scanneable)
+        	{
+        		//get the position in the ordered iterator (the lexicographically position) and the ranked element (using the permutation)
+        		window[windowSize] = perm->pi(iter->next()-1);
+        		windowSize++;
+        	}
+        	mDict->extractBatch(window, windowSize, windowStrings, windowLens);
+        }
 };
 
 #endif
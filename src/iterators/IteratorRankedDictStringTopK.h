@@ -0,0 +1,86 @@
+/* IteratorRankedDictStringTopK.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Iterator class for scanning lazily the strings of a top k query over the
+ * RankedStringDictionaryRPDAC (in increasing order of their IDs).
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _ITERATORRANKEDDICTSTRINGTOPK_H
+#define _ITERATORRANKEDDICTSTRINGTOPK_H
+
+#include <iostream>
+using namespace std;
+
+
+class IteratorRankedDictStringTopK : public IteratorRankedDictString
+{
+	public:
+		/** Constructor for the lazy top k Iterator:
+		    @dict: the dictionary queried.
+		    @ids: the lazy iterator of the IDs (it is deleted with this iterator).
+		*/
+		IteratorRankedDictStringTopK(RankedStringDictionaryRPDAC *dict, IteratorRankedDictIDTopK *ids)
+		{
+			this->dict = dict;
+			this->ids = ids;
+			this->processed = 0;
+			this->scanneable = ids->size();
+		}
+
+		/** Extracts the next string in the stream.
+		    @param strLen pointer to the string length.
+		    @returns the next string.
+		*/
+		unsigned char* next(uint *str_length)
+		{
+			size_t id = ids->next();
+			processed++;
+			scanneable = ids->size();
+
+			return dict->extractString(id, ids->getPosition(), str_length);
+		}
+
+		/** Checks for non-processed strings in the stream.
+		    @returns if remains non-processed strings.
+		*/
+		bool hasNext()
+		{
+			return ids->hasNext();
+		}
+
+		/** Obtains the token for continuing the query after the last
+		    string returned.
+		    @returns the token.
+		*/
+		RankedTopKToken getToken() { return ids->getToken(); }
+
+		~IteratorRankedDictStringTopK()
+		{
+			delete ids;
+		}
+
+	protected:
+		RankedStringDictionaryRPDAC *dict;
+		IteratorRankedDictIDTopK *ids;
+};
+
+#endif
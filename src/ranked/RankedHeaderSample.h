@@ -0,0 +1,183 @@
+/* RankedHeaderSample.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Class which keeps uncompressed the headers of one of every s buckets,
+ * in a contiguous array in Eytzinger (breadth-first) order, so the first
+ * steps of the bucket binary search run on plain memory and only the
+ * last ones (inside s buckets) decompress headers.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDHEADERSAMPLE_H
+#define _RANKEDHEADERSAMPLE_H
+
+#include <string.h>
+#include <fstream>
+#include <algorithm>
+
+#include <libcdsBasics.h>
+
+using namespace std;
+using namespace cds_utils;
+
+
+class RankedHeaderSample
+{
+	public:
+
+		/** Class Constructor.
+		    @param headers: the '\0'-terminated headers of the buckets 0, s, 2s... (sorted).
+		    @param n: number of sampled headers.
+		    @param rate: the sampling rate s.
+		*/
+		RankedHeaderSample(uchar **headers, uint n, uint rate)
+		{
+			this->n = n;
+			this->rate = rate;
+
+			//the slots of the Eytzinger layout start from 1 (0 is not used)
+			ranks = new uint[n+1];
+			ranks[0] = 0;
+			uint next = 0;
+			layout(1, &next);
+
+			offsets = new size_t[n+2];
+			offsets[0] = 0;
+			offsets[1] = 0;
+			for(uint k=1; k<=n; k++)
+				offsets[k+1] = offsets[k] + strlen((char*)headers[ranks[k]]) + 1;
+
+			textLen = offsets[n+1];
+			text = new uchar[textLen];
+			for(uint k=1; k<=n; k++)
+				memcpy(text+offsets[k], headers[ranks[k]], offsets[k+1]-offsets[k]);
+		}
+
+		/** Narrows the range of buckets of a binary search: counts the
+		    sampled headers lower than the string and those lower or equal.
+		    @param str: the string (or prefix) searched.
+		    @param strLen: its length.
+		    @param prefix: true if the headers prefixed by str are equal
+		      to it (as extractPrefixAndCompareDAC).
+		    @param less: number of sampled headers lower than str.
+		    @param lessEqual: number of sampled headers lower or equal than str.
+		*/
+		void bounds(uchar *str, uint strLen, bool prefix, uint *less, uint *lessEqual)
+		{
+			*less = countBelow(str, strLen, prefix, false);
+			*lessEqual = countBelow(str, strLen, prefix, true);
+		}
+
+		/** Retrieves the sampling rate.
+		    @returns one of every rate buckets is sampled.
+		*/
+		uint getRate() {return rate;}
+
+		/** Computes the size of the structure in bytes.
+		    @returns the sample size in bytes.
+		*/
+		size_t getSize()
+		{
+			return textLen*sizeof(uchar) + (n+2)*sizeof(size_t) + (n+1)*sizeof(uint) + sizeof(RankedHeaderSample);
+		}
+
+		/** Stores the sample into an ofstream.
+		    @param out: the oftstream.
+		*/
+		void save(ofstream &out)
+		{
+			saveValue<uint32_t>(out, rate);
+			saveValue<uint32_t>(out, n);
+			saveValue<size_t>(out, offsets, n+2);
+			saveValue<uchar>(out, text, textLen);
+			saveValue<uint>(out, ranks, n+1);
+		}
+
+		/** Loads a sample from an ifstream.
+		    @param in: the ifstream.
+		    @returns the loaded sample.
+		*/
+		static RankedHeaderSample *load(ifstream &in)
+		{
+			RankedHeaderSample *sample = new RankedHeaderSample();
+			sample->rate = loadValue<uint32_t>(in);
+			sample->n = loadValue<uint32_t>(in);
+			sample->offsets = loadValue<size_t>(in, sample->n+2);
+			sample->textLen = sample->offsets[sample->n+1];
+			sample->text = loadValue<uchar>(in, sample->textLen);
+			sample->ranks = loadValue<uint>(in, sample->n+1);
+			return sample;
+		}
+
+		~RankedHeaderSample()
+		{
+			delete [] text;
+			delete [] offsets;
+			delete [] ranks;
+		}
+
+	protected:
+		uint n; //number of sampled headers
+		uint rate; //one of every rate buckets is sampled
+		uchar *text; //the headers concatenated ('\0'-terminated) in Eytzinger order
+		size_t textLen; //length of the text
+		size_t *offsets; //position in text of the header of each slot
+		uint *ranks; //sorted position of the header of each slot
+
+		RankedHeaderSample() {}
+
+		//assigns the sorted positions to the slots of the subtree of k (in order)
+		void layout(uint k, uint *next)
+		{
+			if(k>n) return;
+			layout(2*k, next);
+			ranks[k] = (*next)++;
+			layout(2*k+1, next);
+		}
+
+		//compares the header of a slot with the string (<0, 0 or >0 as strcmp)
+		int compare(uint k, uchar *str, uint strLen, bool prefix)
+		{
+			uchar *header = text+offsets[k];
+			uint len = offsets[k+1]-offsets[k]-1;
+			int cmp = memcmp(header, str, min(len, strLen));
+			if(cmp!=0) return cmp;
+			if(len<strLen) return -1;
+			return (len==strLen || prefix) ? 0 : 1;
+		}
+
+		//number of sampled headers lower (or lower or equal) than str
+		uint countBelow(uchar *str, uint strLen, bool prefix, bool equal)
+		{
+			uint k = 1;
+			while(k<=n)
+			{
+				int cmp = compare(k, str, strLen, prefix);
+				k = 2*k + ((cmp<0 || (equal && cmp==0)) ? 1 : 0);
+			}
+			//the last left turn is the first header out of the count
+			k >>= __builtin_ffs(~k);
+			return (k==0) ? n : ranks[k];
+		}
+};
+
+
+#endif
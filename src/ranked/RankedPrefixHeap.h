@@ -0,0 +1,161 @@
+/* RankedPrefixHeap.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Auxiliar structure for the top k queries over a range of buckets: the
+ * nodes of the wavelet tree covering the range, stored level by level as an
+ * implicit heap (the father and the sons of a node are computed from its
+ * level and label) with one array per field. Each node keeps the position
+ * (in its wavelet tree node) of its next lowest candidate.
+ *
+ * Nodes are marked with the generation of the query which initialized them,
+ * so the structure is reused by consecutive queries without clearing it,
+ * and the nodes completely inside the range are only initialized when a
+ * query reaches them.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDPREFIXHEAP_H
+#define _RANKEDPREFIXHEAP_H
+
+#include <string.h>
+
+using namespace std;
+
+
+class RankedPrefixHeap
+{
+	static const uint MAXLEVELS = 33;
+
+	public:
+
+		RankedPrefixHeap()
+		{
+			ptr=NULL;
+			left=NULL;
+			right=NULL;
+			stamp=NULL;
+			capacity=0;
+			generation=0;
+			first=0;
+			last=0;
+			differentBits=0;
+			numNodes=0;
+		}
+
+		/** Prepares the heap for a new range of symbols (all the nodes
+		    become fresh; the arrays only grow when the range is bigger
+		    than any previous one).
+		    @param _first: the first symbol (bucket+1) of the range.
+		    @param _last: the last symbol (bucket+1) of the range.
+		*/
+		void reset(uint _first, uint _last)
+		{
+			first=_first;
+			last=_last;
+
+			//the levels go from the leaves (0) to the pivot (differentBits), the first common node of the range
+			differentBits=0;
+			while((first>>differentBits) != (last>>differentBits))
+				differentBits++;
+
+			numNodes=0;
+			for(uint i=0; i<=differentBits; i++)
+			{
+				offsets[i]=numNodes;
+				numNodes += (last>>i)-(first>>i)+1;
+			}
+
+			if(numNodes>capacity)
+			{
+				delete [] ptr;
+				delete [] left;
+				delete [] right;
+				delete [] stamp;
+				capacity = 2*numNodes;
+				ptr = new size_t[capacity];
+				left = new size_t[capacity];
+				right = new size_t[capacity];
+				stamp = new uint[capacity];
+				memset(stamp, 0, capacity*sizeof(uint));
+				generation=0;
+			}
+
+			generation++;
+			if(generation==0) //the stamps overflowed
+			{
+				memset(stamp, 0, capacity*sizeof(uint));
+				generation=1;
+			}
+		}
+
+		/** Position of a node in the arrays.
+		    @param level: the level of the node (0 for the leaves).
+		    @param label: the symbol prefix of the node (symbol>>level).
+		    @returns the position.
+		*/
+		uint node(uint level, uint label) {return offsets[level] + label - (first>>level);}
+
+		/** Checks if the node is in the range. */
+		bool exists(uint level, uint label) {return label>=(first>>level) && label<=(last>>level);}
+
+		/** Checks if all the symbols of the node are in the range. */
+		bool covered(uint level, uint label)
+		{
+			return ((size_t)label<<level)>=first && ((((size_t)label+1)<<level)-1)<=last;
+		}
+
+		/** Checks if the node has not been initialized in this generation. */
+		bool isFresh(uint pos) {return stamp[pos]!=generation;}
+
+		/** Marks the node as initialized in this generation. */
+		void touch(uint pos) {stamp[pos]=generation;}
+
+		/** A symbol of the range below the node (the one used for the wavelet tree operations). */
+		uint symbol(uint level, uint label) {return first + ((label-(first>>level))<<level);}
+
+		~RankedPrefixHeap()
+		{
+			delete [] ptr;
+			delete [] left;
+			delete [] right;
+			delete [] stamp;
+		}
+
+		size_t *ptr; //position of the next candidate in the node (0 if there are no more)
+		size_t *left, *right; //position in the node of the candidate of each son (0 if there is not)
+		uint first, last; //range of symbols
+		uint differentBits; //level of the pivot
+		uint numNodes;
+
+	protected:
+		uint *stamp; //generation in which each node was initialized
+		uint generation;
+		uint capacity; //size of the arrays
+		uint offsets[MAXLEVELS]; //position of the first node of each level
+
+	private:
+		//the heap owns its arrays, so it cannot be copied
+		RankedPrefixHeap(const RankedPrefixHeap&);
+		RankedPrefixHeap& operator=(const RankedPrefixHeap&);
+};
+
+
+#endif
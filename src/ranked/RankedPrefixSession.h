@@ -0,0 +1,90 @@
+/* RankedPrefixSession.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Class which keeps the bucket range of the last prefix searched, so
+ * incremental prefix top k queries (one per keystroke) narrow the previous
+ * range instead of searching the whole dictionary again.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDPREFIXSESSION_H
+#define _RANKEDPREFIXSESSION_H
+
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+
+class RankedPrefixSession
+{
+	public:
+
+		RankedPrefixSession()
+		{
+			first=0;
+			last=0;
+			empty=false;
+			valid=false;
+		}
+
+		/** Forgets the last prefix, so the next search starts from the whole dictionary. */
+		void reset() {valid=false;}
+
+		/** Checks if the given string extends (or repeats) the last prefix searched.
+		    @param str: the new prefix.
+		    @param strLen: the new prefix length.
+		    @returns true if the range of the last prefix can be narrowed.
+		*/
+		bool extends(uchar *str, uint strLen)
+		{
+			return valid && strLen>=prefix.size() && (prefix.empty() || memcmp(&prefix[0], str, prefix.size())==0);
+		}
+
+		/** Stores the result of a search.
+		    @param str: the prefix searched.
+		    @param strLen: the prefix length.
+		    @param _first: the first bucket that can contain the prefix.
+		    @param _last: the last bucket that can contain the prefix.
+		    @param _empty: true if no string has the prefix.
+		*/
+		void update(uchar *str, uint strLen, uint _first, uint _last, bool _empty)
+		{
+			prefix.assign(str, str+strLen);
+			first=_first;
+			last=_last;
+			empty=_empty;
+			valid=true;
+		}
+
+		uint getFirst() {return first;}
+		uint getLast() {return last;}
+		bool isEmpty() {return empty;}
+
+	protected:
+		vector<uchar> prefix; //the last prefix searched (a vector, so sessions can be copied)
+		uint first, last; //first and last buckets which can contain strings with the prefix
+		bool empty; //true if no string has the prefix (neither will any extension)
+		bool valid; //false if there is no previous search
+};
+
+
+#endif
@@ -0,0 +1,136 @@
+/* RankedQueryContext.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Reusable memory for the ranked queries: a bump arena from which the
+ * auxiliar structures and the results of a query are obtained, so
+ * consecutive queries do not call the allocator. A context must be used by
+ * only one thread at a time (e.g. one context per thread).
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDQUERYCONTEXT_H
+#define _RANKEDQUERYCONTEXT_H
+
+#include <vector>
+#include "RankedPrefixHeap.h"
+
+using namespace std;
+
+
+class RankedQueryContext
+{
+	static const size_t ALIGNMENT = 16; //every allocation is aligned to this size
+	static const size_t BLOCKSIZE = 1<<16; //default size of the arena
+
+	public:
+
+		/** Class Constructor.
+		    @param capacity: initial size (in bytes) of the arena.
+		*/
+		RankedQueryContext(size_t capacity=BLOCKSIZE)
+		{
+			this->capacity = (capacity>0) ? capacity : BLOCKSIZE;
+			this->block = new uchar[this->capacity];
+			this->used = 0;
+		}
+
+		/** Obtains memory for n elements from the arena (it is never freed individually).
+		    @param n: number of elements.
+		    @returns the memory (not initialized).
+		*/
+		template <typename T> T* allocate(size_t n)
+		{
+			size_t bytes = (n*sizeof(T)+ALIGNMENT-1) & ~(ALIGNMENT-1);
+			if(used+bytes > capacity) grow(bytes);
+
+			T *ptr = (T*)(block+used);
+			used += bytes;
+			return ptr;
+		}
+
+		/** Releases all the memory obtained from the arena (which is kept
+		    for the next queries). The results of the previous queries are
+		    not valid anymore.
+		*/
+		void reset()
+		{
+			for(uint i=0; i<retired.size(); i++)
+				delete [] retired[i];
+			retired.clear();
+			used = 0;
+		}
+
+		/** Obtains the auxiliar heap of the context (reused by its queries).
+		    @returns the heap.
+		*/
+		RankedPrefixHeap* getHeap() {return &heap;}
+
+		/** Obtains an array of n elements from the context or, if there is not, from the heap.
+		    @param context: the context (NULL for using the heap).
+		    @param n: number of elements.
+		    @returns the array.
+		*/
+		template <typename T> static T* alloc(RankedQueryContext *context, size_t n)
+		{
+			if(context!=NULL) return context->allocate<T>(n);
+			return new T[n];
+		}
+
+		/** Frees an array obtained with alloc (nothing is done for a context).
+		    @param context: the context the array was obtained from (NULL for the heap).
+		    @param ptr: the array.
+		*/
+		template <typename T> static void release(RankedQueryContext *context, T *ptr)
+		{
+			if(context==NULL) delete [] ptr;
+		}
+
+		~RankedQueryContext()
+		{
+			reset();
+			delete [] block;
+		}
+
+	protected:
+		uchar *block; //the current block of the arena
+		size_t capacity; //its size
+		size_t used; //bytes of the block already given
+		vector<uchar*> retired; //full blocks (still in use until the next reset)
+		RankedPrefixHeap heap; //auxiliar heap for the middle buckets
+
+		//replaces the current block with a bigger one (the old one is freed in the next reset)
+		void grow(size_t bytes)
+		{
+			retired.push_back(block);
+			capacity = 2*capacity;
+			if(capacity < bytes) capacity = bytes;
+			block = new uchar[capacity];
+			used = 0;
+		}
+
+	private:
+		//a context owns its blocks, so it cannot be copied (use one context per thread)
+		RankedQueryContext(const RankedQueryContext&);
+		RankedQueryContext& operator=(const RankedQueryContext&);
+};
+
+
+#endif
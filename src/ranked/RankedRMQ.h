@@ -0,0 +1,311 @@
+/* RankedRMQ.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Range minimum queries over a LogSequence. The values are stored anyway (the
+ * IDs of a ranked dictionary), so the index only locates the minima among
+ * them (a systematic RMQ) in less than 1 bit per value, below the 2n bits
+ * of a Cartesian tree which does not access the values:
+ *  - a sparse table over the superblocks (of SUPERSIZE values) stores the
+ *    positions of the minima, in log(n) bits each;
+ *  - within each superblock, a sparse table over its blocks (of BLOCKSIZE
+ *    values) stores the offset of the minimum of each block and, for each
+ *    range of 2^l blocks, which block holds its minimum (5 bits each);
+ *  - the partial blocks at the ends of a range are scanned.
+ * It also obtains the k smallest values of a range in increasing order,
+ * splitting the range around each minimum found (O(k log k) queries).
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDRMQ_H
+#define _RANKEDRMQ_H
+
+#include <queue>
+#include <vector>
+#include <fstream>
+
+#include <libcdsBasics.h>
+#include "../utils/LogSequence.h"
+#include "../utils/MappedFile.h"
+
+using namespace std;
+using namespace cds_utils;
+
+
+class RankedRMQ
+{
+	static const uint BLOCKSIZE = 32; //values per block
+	static const uint SUPERBLOCKS = 32; //blocks per superblock
+	static const uint SUPERSIZE = BLOCKSIZE*SUPERBLOCKS; //values per superblock
+	static const uint INNERLEVELS = 6; //levels of the sparse table of a superblock (2^l blocks, l<6)
+	static const uint INNERENTRIES = 135; //entries of the sparse table of a superblock (33-2^l for each level)
+	static const uint INNERBITS = 5; //bits of each entry (an offset in a block or a block in a superblock)
+
+	public:
+
+		/** Class Constructor.
+		    @param values: the sequence indexed (it is not copied, so it
+		      must live as long as the RMQ).
+		*/
+		RankedRMQ(LogSequence *values)
+		{
+			this->values = values;
+			n = values->getNumberOfElements();
+			numBlocks = (n+BLOCKSIZE-1)/BLOCKSIZE;
+			numSupers = (numBlocks+SUPERBLOCKS-1)/SUPERBLOCKS;
+
+			//the sparse table of each superblock: level 0 is the offset of the minimum of each block and level l the block with the minimum of 2^l blocks
+			inner = new LogSequence(INNERBITS, numSupers*INNERENTRIES);
+			for(size_t s=0; s<numSupers; s++)
+			{
+				uint count = superBlocks(s);
+				for(uint j=0; j<count; j++)
+				{
+					size_t begin = ((size_t)s*SUPERBLOCKS+j)*BLOCKSIZE;
+					inner->setField(s*INNERENTRIES+j, scan(begin, min(begin+BLOCKSIZE, n)-1)-begin);
+				}
+				for(uint l=1; l<INNERLEVELS; l++)
+				{
+					uint span = 1<<l;
+					for(uint j=0; j+span<=count; j++)
+					{
+						uint b1 = innerBlock(s, l-1, j), b2 = innerBlock(s, l-1, j+span/2);
+						inner->setField(s*INNERENTRIES+innerOffset(l)+j, (blockMin(s, b2)==lower(blockMin(s, b1), blockMin(s, b2))) ? b2 : b1);
+					}
+				}
+			}
+
+			//the sparse table over the superblocks: level t stores the position of the minimum of 2^t superblocks
+			levels = 1;
+			while(((size_t)1<<levels) <= numSupers) levels++;
+			size_t entries = 0;
+			for(uint t=0; t<levels; t++) entries += numSupers-((size_t)1<<t)+1;
+			top = new LogSequence(bits(n), entries);
+			for(size_t s=0; s<numSupers; s++)
+				top->setField(s, innerQuery(s, 0, superBlocks(s)-1));
+			for(uint t=1; t<levels; t++)
+			{
+				size_t span = (size_t)1<<t;
+				for(size_t s=0; s+span<=numSupers; s++)
+					top->setField(topOffset(t)+s, lower(top->getField(topOffset(t-1)+s), top->getField(topOffset(t-1)+s+span/2)));
+			}
+		}
+
+		/** Obtains the position of the minimum value in a range.
+		    @param left: first position of the range.
+		    @param right: last position of the range (included).
+		    @returns the position of the minimum.
+		*/
+		size_t query(size_t left, size_t right)
+		{
+			size_t lb = left/BLOCKSIZE, rb = right/BLOCKSIZE;
+			if(rb-lb<=1) //no complete block in the middle
+				return scan(left, right);
+
+			size_t best = scan(left, (lb+1)*BLOCKSIZE-1);
+			best = lower(best, blocks(lb+1, rb-1));
+			return lower(best, scan(rb*BLOCKSIZE, right));
+		}
+
+		/** Obtains the k smallest values of a range.
+		    @param left: first position of the range.
+		    @param right: last position of the range (included).
+		    @param k: number of values.
+		    @param result: array (of k positions) for the values, sorted.
+		    @param positions: array (of k positions) for their positions
+		      in the sequence (NULL if they are not needed).
+		    @returns the number of values obtained (less than k if the
+		      range is shorter).
+		*/
+		uint topK(size_t left, size_t right, uint k, size_t *result, size_t *positions=NULL)
+		{
+			if(k==0 || left>right) return 0;
+
+			//each candidate is the minimum of a range not explored yet
+			priority_queue<Candidate, vector<Candidate>, CandidateOrder> candidates;
+			candidates.push(candidate(left, right));
+
+			uint found = 0;
+			while(found<k && !candidates.empty())
+			{
+				Candidate best = candidates.top();
+				candidates.pop();
+				result[found] = best.value;
+				if(positions!=NULL) positions[found] = best.position;
+				found++;
+
+				if(best.position>best.left) candidates.push(candidate(best.left, best.position-1));
+				if(best.position<best.right) candidates.push(candidate(best.position+1, best.right));
+			}
+			return found;
+		}
+
+		/** Computes the size of the structure in bytes (without the
+		    sequence, which it only reads): less than 1 bit per value.
+		    @returns the RMQ size in bytes.
+		*/
+		size_t getSize()
+		{
+			return inner->getSize() + top->getSize() + sizeof(RankedRMQ);
+		}
+
+		/** Stores the RMQ (without the sequence) into an ofstream.
+		    @param out: the oftstream.
+		*/
+		void save(ofstream &out)
+		{
+			saveValue<uint64_t>(out, n);
+			saveValue<uint32_t>(out, levels);
+			inner->save(out);
+			top->save(out);
+		}
+
+		/** Loads an RMQ from an ifstream.
+		    @param in: the ifstream.
+		    @param values: the sequence indexed.
+		    @returns the loaded RMQ.
+		*/
+		static RankedRMQ *load(ifstream &in, LogSequence *values)
+		{
+			RankedRMQ *rmq = new RankedRMQ();
+			rmq->values = values;
+			rmq->n = loadValue<uint64_t>(in);
+			rmq->numBlocks = (rmq->n+BLOCKSIZE-1)/BLOCKSIZE;
+			rmq->numSupers = (rmq->numBlocks+SUPERBLOCKS-1)/SUPERBLOCKS;
+			rmq->levels = loadValue<uint32_t>(in);
+			rmq->inner = new LogSequence(in);
+			rmq->top = new LogSequence(in);
+			return rmq;
+		}
+
+		~RankedRMQ()
+		{
+			delete inner;
+			delete top;
+		}
+
+	protected:
+		LogSequence *values; //the sequence indexed
+		size_t n; //number of values
+		size_t numBlocks; //number of blocks
+		size_t numSupers; //number of superblocks
+		uint levels; //levels of the sparse table over the superblocks
+		LogSequence *inner; //sparse tables of the superblocks (INNERENTRIES per superblock)
+		LogSequence *top; //sparse table over the superblocks (position of the minimum of 2^t superblocks starting at each one)
+
+		struct Candidate
+		{
+			size_t value;
+			size_t position;
+			size_t left, right; //the range of which it is the minimum
+		};
+
+		struct CandidateOrder
+		{
+			bool operator()(const Candidate &c1, const Candidate &c2) {return c1.value > c2.value;}
+		};
+
+		RankedRMQ() {}
+
+		Candidate candidate(size_t left, size_t right)
+		{
+			Candidate c;
+			c.position = query(left, right);
+			c.value = values->getField(c.position);
+			c.left = left;
+			c.right = right;
+			return c;
+		}
+
+		//position of the lower value (the first one if they are equal)
+		size_t lower(size_t pos1, size_t pos2)
+		{
+			return (values->getField(pos2) < values->getField(pos1)) ? pos2 : pos1;
+		}
+
+		//position of the minimum in [left, right] reading every value
+		size_t scan(size_t left, size_t right)
+		{
+			size_t best = left, bestValue = values->getField(left);
+			for(size_t i=left+1; i<=right; i++)
+			{
+				size_t value = values->getField(i);
+				if(value<bestValue) {best = i; bestValue = value;}
+			}
+			return best;
+		}
+
+		//number of blocks of a superblock (the last one may be shorter)
+		uint superBlocks(size_t s)
+		{
+			return (uint)min((size_t)SUPERBLOCKS, numBlocks-s*SUPERBLOCKS);
+		}
+
+		//first entry of the level l in the sparse table of a superblock
+		static uint innerOffset(uint l)
+		{
+			return l*(SUPERBLOCKS+1)-((1<<l)-1);
+		}
+
+		//block (in the superblock s) with the minimum of the 2^l blocks starting at j
+		uint innerBlock(size_t s, uint l, uint j)
+		{
+			return (l==0) ? j : inner->getField(s*INNERENTRIES+innerOffset(l)+j);
+		}
+
+		//position of the minimum of the block j of the superblock s
+		size_t blockMin(size_t s, uint j)
+		{
+			return (s*SUPERBLOCKS+j)*BLOCKSIZE + inner->getField(s*INNERENTRIES+j);
+		}
+
+		//position of the minimum of the blocks [first, last] of the superblock s
+		size_t innerQuery(size_t s, uint first, uint last)
+		{
+			uint l = 0;
+			while((2u<<l) <= last-first+1) l++;
+			return lower(blockMin(s, innerBlock(s, l, first)), blockMin(s, innerBlock(s, l, last-(1<<l)+1)));
+		}
+
+		//first entry of the level t in the sparse table over the superblocks
+		size_t topOffset(uint t)
+		{
+			return t*(numSupers+1)-(((size_t)1<<t)-1);
+		}
+
+		//position of the minimum of the blocks [first, last]
+		size_t blocks(size_t first, size_t last)
+		{
+			size_t sf = first/SUPERBLOCKS, sl = last/SUPERBLOCKS;
+			if(sf==sl) return innerQuery(sf, first%SUPERBLOCKS, last%SUPERBLOCKS);
+
+			size_t best = innerQuery(sf, first%SUPERBLOCKS, SUPERBLOCKS-1);
+			if(sl-sf>1)
+			{
+				uint t = 0;
+				while(((size_t)2<<t) <= sl-sf-1) t++;
+				best = lower(best, lower(top->getField(topOffset(t)+sf+1), top->getField(topOffset(t)+sl-((size_t)1<<t))));
+			}
+			return lower(best, innerQuery(sl, 0, last%SUPERBLOCKS));
+		}
+};
+
+
+#endif
@@ -0,0 +1,146 @@
+/* RankedTableBlock.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Block of consecutive strings of a table export: the strings decoded by
+ * one thread are stored contiguously ('\0'-terminated) in a single array,
+ * in any order, and they are given to the sink in order once the thread
+ * ends. The memory is kept between blocks, so decoding a string allocates
+ * nothing.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDTABLEBLOCK_H
+#define _RANKEDTABLEBLOCK_H
+
+#include <string.h>
+#include <vector>
+
+#include <libcdsBasics.h>
+#include "../StringDictionary.h"
+
+using namespace std;
+using namespace cds_utils;
+
+
+class RankedTableBlock
+{
+	public:
+
+		RankedTableBlock()
+		{
+			first = 0;
+			count = 0;
+			end = 0;
+			valid = true;
+		}
+
+		/** Empties the block for a new range of strings.
+		    @param first: index (ID or alphabetical position) of the first string.
+		    @param count: number of strings.
+		*/
+		void reset(size_t first, size_t count)
+		{
+			this->first = first;
+			this->count = count;
+			this->end = 0;
+			this->valid = true;
+			starts.assign(count, 0);
+			lens.assign(count, (uint)-1);
+		}
+
+		/** Retrieves the index of the first string of the block.
+		    @returns the index.
+		*/
+		size_t getFirst() {return first;}
+
+		/** Retrieves the number of strings of the block.
+		    @returns the number of strings.
+		*/
+		size_t getCount() {return count;}
+
+		/** Obtains space for decoding a string at the end of the block.
+		    @param len: maximum length of the decoded string (with its '\0').
+		    @returns the space (only valid until the next call).
+		*/
+		uchar* reserve(size_t len)
+		{
+			if(text.size() < end+len) text.resize(max(2*text.size(), end+len));
+			return &text[end];
+		}
+
+		/** Stores the string decoded in the space given by reserve.
+		    @param slot: position of the string in the block.
+		    @param strLen: the string length.
+		*/
+		void commit(size_t slot, uint strLen)
+		{
+			text[end+strLen] = '\0';
+			starts[slot] = end;
+			lens[slot] = strLen;
+			end += strLen+1;
+		}
+
+		/** Copies a string to the block.
+		    @param slot: position of the string in the block.
+		    @param str: the string.
+		    @param strLen: the string length.
+		*/
+		void add(size_t slot, uchar *str, uint strLen)
+		{
+			memcpy(reserve(strLen+1), str, strLen);
+			commit(slot, strLen);
+		}
+
+		/** Gives the strings of the block to a sink, in order.
+		    @param callback: function called for each string (with its
+		      index), which is only valid during the call.
+		    @param data: user data given to the callback.
+		*/
+		void emit(ExtractCallback callback, void *data)
+		{
+			for(size_t slot=0; slot<count; slot++)
+			{
+				if(lens[slot]==(uint)-1) callback(first+slot, NULL, 0, data);
+				else callback(first+slot, &text[starts[slot]], lens[slot], data);
+			}
+		}
+
+		/** Callback for extractBatch which copies each string to the
+		    block given as data (in the slot of its position in the batch).
+		*/
+		static void store(size_t index, uchar *str, uint strLen, void *data)
+		{
+			if(str!=NULL) ((RankedTableBlock*)data)->add(index, str, strLen);
+		}
+
+		bool valid; //false if the dictionary could not decode the block
+
+	protected:
+		size_t first; //index of the first string
+		size_t count; //number of strings
+		vector<uchar> text; //the strings ('\0'-terminated)
+		size_t end; //used length of the text
+		vector<size_t> starts; //position in text of the string of each slot
+		vector<uint> lens; //length of the string of each slot ((uint)-1 if it is missing)
+};
+
+
+#endif
@@ -0,0 +1,93 @@
+/* RankedTopKFrontier.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * State of a lazy top k query over the RankedStringDictionaryRPDAC: the
+ * next candidate of each part of the bucket range (first and last buckets,
+ * and the middle ones through the auxiliar tree), so the next lowest ID is
+ * obtained on demand. It also defines the token to resume a query.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDTOPKFRONTIER_H
+#define _RANKEDTOPKFRONTIER_H
+
+#include "RankedPrefixHeap.h"
+
+using namespace std;
+
+
+struct RankedTopKToken //point where a top k query stopped, for continuing it later
+{
+	uint first; //first bucket of the query range
+	uint last; //last bucket of the query range
+	size_t lastId; //last ID returned (0 if none)
+};
+
+
+struct RankedTopKSide //a bucket scanned sequentially (its strings are sorted by ID)
+{
+	uint bucket; //the bucket (starting from 0)
+	uint startPoint; //number of inner positions already scanned
+	uint end; //last inner position of the range
+	bool check; //true if the strings must be compared with the prefix
+	size_t id; //the next ID (0 if there are no more)
+	size_t position; //its position in the RPDAC
+};
+
+
+class RankedTopKFrontier
+{
+	public:
+
+		RankedTopKFrontier()
+		{
+			prefix=NULL;
+			prefixLen=0;
+			numSides=0;
+			tree=NULL;
+			treeId=0;
+			treePosition=0;
+			first=0;
+			last=0;
+			minId=0;
+		}
+
+		~RankedTopKFrontier()
+		{
+			delete [] prefix;
+			delete tree;
+		}
+
+		uchar *prefix; //the prefix searched ('\0'-terminated; NULL for intervals)
+		uint prefixLen; //its length
+		uint first, last; //first and last buckets of the range
+		size_t minId; //the ID the query was resumed after (0 if it was not resumed)
+
+		RankedTopKSide sides[3]; //first and last buckets, and the middle one if it is alone
+		uint numSides;
+
+		RankedPrefixHeap * tree; //auxiliar heap for two or more middle buckets (NULL if there are not)
+		size_t treeId; //the next ID of the middle buckets (0 if there are no more)
+		size_t treePosition; //its position in the RPDAC
+};
+
+
+#endif
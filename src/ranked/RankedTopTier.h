@@ -0,0 +1,225 @@
+/* RankedTopTier.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Class which keeps the strings of the first T IDs (the most popular ones)
+ * uncompressed in a contiguous cache-aligned array, so the ranked
+ * dictionaries can answer them without touching the compressed structures.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _RANKEDTOPTIER_H
+#define _RANKEDTOPTIER_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <algorithm>
+
+#include <libcdsBasics.h>
+
+using namespace std;
+using namespace cds_utils;
+
+
+class RankedTopTier
+{
+	static const size_t ALIGNMENT = 64; //cache line size
+
+	public:
+
+		/** Class Constructor.
+		    @param strings: the '\0'-terminated strings of the IDs 1..n (strings[i] is the string of ID i+1).
+		    @param n: number of strings in the tier.
+		*/
+		RankedTopTier(uchar **strings, uint n)
+		{
+			this->n = n;
+			offsets = new size_t[n+1];
+			offsets[0] = 0;
+			for(uint i=0; i<n; i++)
+				offsets[i+1] = offsets[i] + strlen((char*)strings[i]) + 1;
+
+			textLen = offsets[n];
+			text = allocText(textLen);
+			for(uint i=0; i<n; i++)
+				memcpy(text+offsets[i], strings[i], offsets[i+1]-offsets[i]);
+
+			//the IDs sorted lexicographically for the prefix searches
+			lexIds = new uint[n];
+			for(uint i=0; i<n; i++)
+				lexIds[i] = i+1;
+			LexOrder order(this);
+			sort(lexIds, lexIds+n, order);
+		}
+
+		/** Checks if the string of the given ID is stored in the tier.
+		    @param id: the ID.
+		    @returns true if the ID is in the tier.
+		*/
+		bool contains(size_t id) {return id>0 && id<=n;}
+
+		/** Obtains the string of an ID stored in the tier (without copying it).
+		    @param id: the ID (it must be in the tier).
+		    @param strLen: pointer to the string length.
+		    @returns a pointer to the '\0'-terminated string inside the tier.
+		*/
+		uchar* access(size_t id, uint *strLen)
+		{
+			*strLen = offsets[id]-offsets[id-1]-1;
+			return text+offsets[id-1];
+		}
+
+		/** Obtains a copy of the string of an ID stored in the tier.
+		    @param id: the ID (it must be in the tier).
+		    @param strLen: pointer to the string length.
+		    @returns the requested string.
+		*/
+		uchar* extract(size_t id, uint *strLen)
+		{
+			uchar *str = access(id, strLen);
+			uchar *s = new uchar[*strLen+1];
+			memcpy(s, str, *strLen+1);
+			return s;
+		}
+
+		/** Finds the first k IDs prefixed by the given string when all
+		    of them are stored in the tier.
+		    @param str: the prefix to be searched.
+		    @param strLen: the prefix length.
+		    @param k: the number of elements to return.
+		    @param ids: array (of k positions) for the IDs found, sorted.
+		    @returns true if the tier contains at least k strings with the
+		      prefix (the IDs out of the tier are always bigger, so they
+		      are the answer); false if the compressed path is needed.
+		*/
+		bool topKprefix(uchar *str, uint strLen, uint k, size_t *ids)
+		{
+			if(k==0 || k>n) return false;
+
+			//binary search of the first and the last strings with the prefix
+			uint left = 0, right = n;
+			while(left<right)
+			{
+				uint center = left+(right-left)/2;
+				if(comparePrefix(lexIds[center], str, strLen) < 0) left = center+1;
+				else right = center;
+			}
+			uint first = left;
+			right = n;
+			while(left<right)
+			{
+				uint center = left+(right-left)/2;
+				if(comparePrefix(lexIds[center], str, strLen) <= 0) left = center+1;
+				else right = center;
+			}
+
+			if(left-first < k) return false;
+
+			partial_sort_copy(lexIds+first, lexIds+left, ids, ids+k);
+			return true;
+		}
+
+		/** Retrieves the number of strings in the tier.
+		    @returns the number of strings.
+		*/
+		uint size() {return n;}
+
+		/** Computes the size of the structure in bytes.
+		    @returns the tier size in bytes.
+		*/
+		size_t getSize()
+		{
+			return textLen*sizeof(uchar) + (n+1)*sizeof(size_t) + n*sizeof(uint) + sizeof(RankedTopTier);
+		}
+
+		/** Stores the tier into an ofstream.
+		    @param out: the oftstream.
+		*/
+		void save(ofstream &out)
+		{
+			saveValue<uint32_t>(out, n);
+			saveValue<size_t>(out, offsets, n+1);
+			saveValue<uchar>(out, text, textLen);
+			saveValue<uint>(out, lexIds, n);
+		}
+
+		/** Loads a tier from an ifstream.
+		    @param in: the ifstream.
+		    @returns the loaded tier.
+		*/
+		static RankedTopTier *load(ifstream &in)
+		{
+			RankedTopTier *tier = new RankedTopTier();
+			tier->n = loadValue<uint32_t>(in);
+			tier->offsets = loadValue<size_t>(in, tier->n+1);
+			tier->textLen = tier->offsets[tier->n];
+			tier->text = allocText(tier->textLen);
+			in.read((char*)tier->text, tier->textLen*sizeof(uchar));
+			tier->lexIds = loadValue<uint>(in, tier->n);
+			return tier;
+		}
+
+		~RankedTopTier()
+		{
+			free(text);
+			delete [] offsets;
+			delete [] lexIds;
+		}
+
+	protected:
+		uint n; //number of strings (IDs 1..n)
+		uchar *text; //the strings concatenated ('\0'-terminated) in ID order
+		size_t textLen; //length of the text
+		size_t *offsets; //position in text of the string of each ID (offsets[id-1]); offsets[n]=textLen
+		uint *lexIds; //the IDs sorted lexicographically by their strings
+
+		RankedTopTier() {}
+
+		static uchar* allocText(size_t len)
+		{
+			void *ptr = NULL;
+			if(posix_memalign(&ptr, ALIGNMENT, len>0 ? len : 1) != 0) return NULL;
+			return (uchar*)ptr;
+		}
+
+		//compares the string of the ID with the prefix (0 if the string is prefixed by it)
+		int comparePrefix(uint id, uchar *str, uint strLen)
+		{
+			uchar *s = text+offsets[id-1];
+			uint len = offsets[id]-offsets[id-1]-1;
+			int cmp = memcmp(s, str, min(len, strLen));
+			if(cmp!=0) return cmp;
+			return (len<strLen) ? -1 : 0;
+		}
+
+		struct LexOrder
+		{
+			RankedTopTier *tier;
+			LexOrder(RankedTopTier *_tier) : tier(_tier) {}
+			bool operator()(uint id1, uint id2)
+			{
+				return strcmp((char*)(tier->text+tier->offsets[id1-1]), (char*)(tier->text+tier->offsets[id2-1])) < 0;
+			}
+		};
+};
+
+
+#endif
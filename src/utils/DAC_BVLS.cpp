@@ -103,6 +103,11 @@ uint DAC_BVLS::access_next(uint l, uint *pos) const{
 	return seq;
 }
 
+void DAC_BVLS::prefetch(uint pos) const{
+	__builtin_prefetch(&levels[pos-1]);
+	__builtin_prefetch(&((BitSequenceRG *)bS)->data[(pos-1)/W]);
+}
+
 uint DAC_BVLS::getSize() const
 {
 	uint mem = sizeof(DAC_BVLS);
@@ -60,6 +60,9 @@ class DAC_BVLS
 		/*Return the value stored in position pos in the level l. It also store in pos the position of the 
 		 * next value in the next level (if not exist next value return (uint)-1 in pos*/
 		virtual uint access_next(uint l, uint *pos) const;
+
+		/*Prefetches the first level of the sequence that starts at pos (pos start from 1 to n)*/
+		void prefetch(uint pos) const;
 			
 		/*Return the size, in bytes, used for DAC_BVLS structure*/
 		virtual uint getSize() const;
@@ -34,6 +34,7 @@
 
 
 #include "DAC_VLS.h"
+#include "MappedFile.h"
 
 DAC_VLS::DAC_VLS(){
 	tamCode = 0;
@@ -42,23 +43,24 @@ DAC_VLS::DAC_VLS(){
 	nLevels = 0;      
 	levelsIndex = NULL; 
 	levels = NULL;   
-	bS = NULL; 
 	rankLevels = NULL;
+	bitsLength = 0;
+	bitmap = NULL;
+	bitmapRank = NULL;
 }
 
-DAC_VLS::DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length){
-	uint *levelSizeAux;
-	uint *contB;
-	uint bits_BS_len = 0;
+DAC_VLS::DAC_VLS(int *list, size_t l_Length, uint log_r, uint max_seq_length){
+	uint64_t *levelSizeAux;
+	uint64_t *contB;
 	listLength =0;
 	nLevels = max_seq_length;
-	levelSizeAux = new uint[nLevels];
+	levelSizeAux = new uint64_t[nLevels];
 	
 	for(uint i=0;i<nLevels;i++)
 		levelSizeAux[i]=0;
 
 	//Space needed for each level
-	for(uint i=0;i<l_Length;i++){
+	for(size_t i=0;i<l_Length;i++){
 		for(uint j=0; j < nLevels;j++){
 			if(list[i] >= 0){
 				levelSizeAux[j]++;
@@ -70,17 +72,16 @@ DAC_VLS::DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length){
 		listLength++;
 	}
 
-	levelsIndex = new uint[nLevels+1];
-	bits_BS_len =0;
+	levelsIndex = new uint64_t[nLevels+1];
 	base_bits = log_r;
 	//space needed for levels in bits
-	uint tamLevels =0;
+	uint64_t tamLevels =0;
 	for(uint i=0;i<nLevels;i++)
 		tamLevels+=base_bits*levelSizeAux[i];	
 	tamCode=tamLevels;
 
 	levelsIndex[0]=0;
-	contB = new uint[nLevels];
+	contB = new uint64_t[nLevels];
 	for(uint j=0;j<nLevels;j++){
 		levelsIndex[j+1]=levelsIndex[j] + levelSizeAux[j];
 		contB[j]=levelsIndex[j];
@@ -88,18 +89,18 @@ DAC_VLS::DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length){
 
 	//init levels
 	levels = new uint[tamLevels/W+1];		
-	for(uint i=0; i< (tamLevels/W+1); i++)
+	for(uint64_t i=0; i< (tamLevels/W+1); i++)
 		levels[i] = 0;
 
 	//size of the bitmap
-	bits_BS_len = levelsIndex[nLevels-1]+1; 
+	bitsLength = levelsIndex[nLevels-1]+1; 
 	//tha last position is 0. this save us time later in the queries
 	//init bitmap
-	uint * bits_BS = new uint[bits_BS_len/W+1];
-	for(uint i=0; i<((bits_BS_len)/W+1);i++)
-		bits_BS[i]=0;
+	bitmap = new uint[bitsLength/W+1];
+	for(uint64_t i=0; i<((bitsLength)/W+1);i++)
+		bitmap[i]=0;
 
-	for(uint i=0;i<l_Length;i++){
+	for(size_t i=0;i<l_Length;i++){
 
 		for(uint j=0; j<nLevels; j++){
 			if(list[i]>=0){
@@ -107,7 +108,7 @@ DAC_VLS::DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length){
 				contB[j]++;
 				i++;
 				if(j>0)
-					bitset(bits_BS, contB[j-1]-1);
+					bitset(bitmap, contB[j-1]-1);
 			}
 			else
 				break;
@@ -115,31 +116,40 @@ DAC_VLS::DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length){
 	}
 
 	//set the bitmap data structure
-	bitset(bits_BS,bits_BS_len-1);
-	bS = new BitSequenceRG(bits_BS, bits_BS_len , 4);
+	bitset(bitmap,bitsLength-1);
+	buildRank();
 
-	rankLevels = new uint[nLevels];
+	rankLevels = new uint64_t[nLevels];
 	rankLevels[0]=0;
 	for(uint j=1;j<nLevels;j++)
-		rankLevels[j]= bS->rank1(levelsIndex[j]-1);
+		rankLevels[j]= rank1(levelsIndex[j]-1);
 	
 	delete [] contB;
 	delete [] levelSizeAux;
-	delete [] bits_BS;
 }
 
-uint DAC_VLS::access(uint pos, uint **seq) const{
+void DAC_VLS::buildRank(){
+	bitmapRank = new uint64_t[bitsLength/RANKBITS+1];
+	uint64_t rank = 0;
+	for(uint64_t w=0; w<bitsLength/W+1; w++){
+		if((w%(RANKBITS/W))==0)
+			bitmapRank[w/(RANKBITS/W)] = rank;
+		rank += __builtin_popcount(bitmap[w]);
+	}
+}
+
+uint DAC_VLS::access(size_t pos, uint **seq) const{
 	uint *sequence = new uint[nLevels];
 	uint l_seq =0;
-	uint ini = pos-1; 
+	uint64_t ini = pos-1; 
 	uint j=0;
-	uint rankini;
+	uint64_t rankini;
 
 	sequence[j] = get_field(levels, base_bits, ini); 
 	l_seq =1;
 
-	while(bitget(((BitSequenceRG *)bS)->data,ini)){
-		rankini = bS->rank1(ini) - rankLevels[j];
+	while(bitget(bitmap,ini)){
+		rankini = rank1(ini) - rankLevels[j];
 		j++;
 			
 		ini = levelsIndex[j]+rankini -1;
@@ -153,67 +163,104 @@ uint DAC_VLS::access(uint pos, uint **seq) const{
 	return l_seq;
 }
 
-uint DAC_VLS::access_next(uint l, uint *pos) const{
-	uint ini=*pos-1; 
-	uint rankini;
+uint DAC_VLS::access_next(uint l, size_t *pos) const{
+	uint64_t ini=*pos-1; 
+	uint64_t rankini;
 	uint seq = get_field(levels, base_bits, ini);
 		
 	if(l==(uint)nLevels-1){
-		*pos = (uint)-1;
+		*pos = END;
 		return seq;
 	}
-	if(bitget(((BitSequenceRG *)bS)->data,ini)){
-		rankini = bS->rank1(ini) - rankLevels[l];
+	if(bitget(bitmap,ini)){
+		rankini = rank1(ini) - rankLevels[l];
 		*pos = levelsIndex[l+1]+rankini;
 	}
 	else
-		*pos = (uint)-1;
+		*pos = END;
 	return seq;
 }
 
-uint DAC_VLS::getListLength() const{
+void DAC_VLS::prefetch(size_t pos) const{
+	__builtin_prefetch(&levels[((uint64_t)(pos-1)*base_bits)/W]);
+	__builtin_prefetch(&bitmap[(pos-1)/W]);
+}
+
+size_t DAC_VLS::getListLength() const{
 	return listLength;
 }
 
-uint DAC_VLS::getSize() const{
-	uint mem = sizeof(DAC_VLS);
-	mem += sizeof(uint)*(nLevels+1);
+size_t DAC_VLS::getSize() const{
+	size_t mem = sizeof(DAC_VLS);
+	mem += sizeof(uint64_t)*(nLevels+1);
 	mem += sizeof(uint)*(tamCode/W+1);
-	mem += bS->getSize();   
-	mem += sizeof(uint)*nLevels; 
+	mem += sizeof(uint)*(bitsLength/W+1);
+	mem += sizeof(uint64_t)*(bitsLength/RANKBITS+1);
+	mem += sizeof(uint64_t)*nLevels; 
 	return mem;
 }
 
 void DAC_VLS::save(ofstream & fp) const{
-	saveValue(fp, tamCode);
-	saveValue(fp, listLength);
-	saveValue(fp, nLevels);
-	saveValue(fp, base_bits);
-	saveValue(fp, levelsIndex, nLevels+1);
-	saveValue(fp, levels, tamCode/W+1);
-	saveValue(fp, rankLevels, nLevels);
-	bS->save(fp);
+	saveValue<uint32_t>(fp, WIDE);
+	saveValue<uint64_t>(fp, tamCode);
+	saveValue<uint64_t>(fp, listLength);
+	saveValue<uint32_t>(fp, nLevels);
+	saveValue<ushort>(fp, base_bits);
+	saveValue<uint64_t>(fp, levelsIndex, nLevels+1);
+	MappedFile::saveArray(fp, levels, tamCode/W+1);
+	saveValue<uint64_t>(fp, rankLevels, nLevels);
+	saveValue<uint64_t>(fp, bitsLength);
+	MappedFile::saveArray(fp, bitmap, bitsLength/W+1);
+	MappedFile::saveArray(fp, bitmapRank, bitsLength/RANKBITS+1);
 }
 
 DAC_VLS* DAC_VLS::load(ifstream & fp){
 	DAC_VLS *rep = new DAC_VLS();
-	rep->tamCode = loadValue<uint>(fp);
+	uint32_t first = loadValue<uint32_t>(fp);
+
+	if(first == WIDE){
+		rep->tamCode = loadValue<uint64_t>(fp);
+		rep->listLength = loadValue<uint64_t>(fp);
+		rep->nLevels = loadValue<uint32_t>(fp);
+		rep->base_bits = loadValue<ushort>(fp);
+		rep->levelsIndex = loadValue<uint64_t>(fp, rep->nLevels+1); 
+		rep->levels = MappedFile::loadArray<uint>(fp, rep->tamCode/W+1);
+		rep->rankLevels = loadValue<uint64_t>(fp, rep->nLevels);
+		rep->bitsLength = loadValue<uint64_t>(fp);
+		rep->bitmap = MappedFile::loadArray<uint>(fp, rep->bitsLength/W+1);
+		rep->bitmapRank = MappedFile::loadArray<uint64_t>(fp, rep->bitsLength/RANKBITS+1);
+		return rep;
+	}
+
+	//the 32-bit format: its bitmap is a libcds BitSequenceRG
+	rep->tamCode = first;
 	rep->listLength = loadValue<uint>(fp);
 	rep->nLevels = loadValue<uint>(fp);
 	rep->base_bits = loadValue<ushort>(fp);
-	rep->levelsIndex = loadValue<uint>(fp, rep->nLevels+1); 
-	rep->levels = loadValue<uint>(fp, rep->tamCode/W+1);
-	rep->rankLevels = loadValue<uint>(fp, rep->nLevels);
-	rep->bS = BitSequence::load(fp);
+	uint *index = loadValue<uint>(fp, rep->nLevels+1);
+	rep->levelsIndex = new uint64_t[rep->nLevels+1];
+	for(uint i=0; i<=rep->nLevels; i++) rep->levelsIndex[i] = index[i];
+	delete [] index;
+	rep->levels = MappedFile::loadArray<uint>(fp, rep->tamCode/W+1);
+	uint *ranks = loadValue<uint>(fp, rep->nLevels);
+	rep->rankLevels = new uint64_t[rep->nLevels];
+	for(uint i=0; i<rep->nLevels; i++) rep->rankLevels[i] = ranks[i];
+	delete [] ranks;
+
+	BitSequenceRG *bS = (BitSequenceRG *)BitSequence::load(fp);
+	rep->bitsLength = bS->getLength();
+	rep->bitmap = new uint[rep->bitsLength/W+1];
+	memcpy(rep->bitmap, bS->data, sizeof(uint)*(rep->bitsLength/W+1));
+	delete bS;
+	rep->buildRank();
 
 	return rep;
 }
 
 DAC_VLS::~DAC_VLS(){
 	if (levelsIndex != NULL) delete [] levelsIndex;
-	if (levels != NULL) delete [] levels;
+	MappedFile::deleteArray(levels);
 	if (rankLevels != NULL) delete [] rankLevels;
-	delete (BitSequenceRG *)bS;
+	MappedFile::deleteArray(bitmap);
+	MappedFile::deleteArray(bitmapRank);
 }
-
-
@@ -34,6 +34,7 @@
 #ifndef _DAC_VLS
 #define _DAC_VLS
 
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
@@ -53,20 +54,26 @@ class DAC_VLS
 		 * @param log_r Number of bits used for each block 
 		 * @param max_seq_length Maximum length that a sequence can have
 		 * */
-		DAC_VLS(int *list, uint l_Length, uint log_r, uint max_seq_length);
+		DAC_VLS(int *list, size_t l_Length, uint log_r, uint max_seq_length);
+		
+		/*Position returned by access_next after the last value of a sequence*/
+		static const size_t END = (size_t)-1;
 		
 		/*Return the length of the sequence that start at pos (pos start from 1 to n) and in seq store the sequence*/
-		virtual uint access(uint pos, uint **seq) const;
+		virtual uint access(size_t pos, uint **seq) const;
 			
 		/*Return the value stored in position pos in the level l. It also store in pos the position of the 
-		 * next value in the next level (if not exist next value return (uint)-1 in pos*/
-		virtual uint access_next(uint l, uint *pos) const;
+		 * next value in the next level (if not exist next value return END in pos*/
+		virtual uint access_next(uint l, size_t *pos) const;
+
+		/*Prefetches the first level of the sequence that starts at pos (pos start from 1 to n)*/
+		void prefetch(size_t pos) const;
 		
 		/*Return the number of elements stored*/
-		virtual uint getListLength() const;
+		virtual size_t getListLength() const;
 			
 		/*Return the size, in bytes, used for DAC_VLS structure*/
-		virtual uint getSize() const;
+		virtual size_t getSize() const;
 			
 		virtual void save(ofstream & fp) const;
 			
@@ -76,14 +83,39 @@ class DAC_VLS
 
 	private:
 		DAC_VLS();
-		uint tamCode;
+
+		/*Marks the 64-bit format (it replaces tamCode, which is never 2^32-1 in the 32-bit one)*/
+		static const uint32_t WIDE = 0xFFFFFFFF;
+		/*Bits of the bitmap covered by each rank sample*/
+		static const uint RANKBITS = 256;
+
+		/*levels, bitmap and bitmapRank may point into a read-only mapping
+		 *(see MappedFile::loadArray), so they are only written while they are built*/
+		uint64_t tamCode;
 		ushort base_bits;
-		uint listLength;
+		uint64_t listLength;
 		uint nLevels;
-		uint * levelsIndex;
+		uint64_t * levelsIndex;
 		uint * levels;
-		BitSequence * bS;
-		uint * rankLevels;
+		uint64_t * rankLevels;
+
+		/*The bitmap marking the values with a next level, with a rank
+		 *sample every RANKBITS bits (libcds samples its ranks in 32
+		 *bits, which overflow past 2^32 values)*/
+		uint64_t bitsLength;
+		uint * bitmap;
+		uint64_t * bitmapRank;
+
+		/*Builds the rank samples of the bitmap*/
+		void buildRank();
+		
+		/*Number of ones in the positions [0, i] of the bitmap*/
+		uint64_t rank1(uint64_t i) const
+		{
+			uint64_t rank = bitmapRank[i/RANKBITS];
+			for (uint64_t w=(i/RANKBITS)*(RANKBITS/W); w<i/W; w++) rank += __builtin_popcount(bitmap[w]);
+			return rank + __builtin_popcount(bitmap[i/W] & (uint)((2ULL << (i%W))-1));
+		}
 };
 
 #endif
@@ -30,9 +30,11 @@
  */
 
 #include "LogSequence.h"
+#include "MappedFile.h"
 
 LogSequence::LogSequence()
 {
+  mapped = false;
 }
 
 LogSequence::LogSequence(unsigned int numbits, size_t capacity)
@@ -40,6 +42,7 @@ LogSequence::LogSequence(unsigned int numbits, size_t capacity)
   this->numbits = numbits;
   this->numentries = capacity;
   this->maxval = maxVal(numbits);
+  this->mapped = false;
 
   arraysize = numElementsFor(numbits, numentries);
   array = new size_t[arraysize];
@@ -51,6 +54,7 @@ LogSequence::LogSequence(vector<size_t> *v, unsigned int numbits)
   this->numbits = numbits;
   this->numentries = v->size();
   this->maxval = maxVal(numbits);
+  this->mapped = false;
 
   arraysize = numElementsFor(numbits, numentries);
   array = new size_t[arraysize];
@@ -69,7 +73,8 @@ LogSequence::LogSequence(ifstream &in)
   if ((numbytes % 8) != 0) numbytes += 8-(numbytes%8);
 
   arraysize = numElementsFor(numbits, numentries);
-  array = (size_t*)loadValue<uchar>(in, numbytes);
+  array = MappedFile::loadArray<size_t>(in, numbytes/sizeof(size_t));
+  mapped = MappedFile::isMapped(array);
 }
 
 size_t LogSequence::getField(size_t position)
@@ -94,6 +99,9 @@ void LogSequence::setField(size_t position, size_t value)
   if(value>maxval) {
     throw "Trying to insert a value bigger that expected. Please increase numbits when creating the data structure.";
   }
+  if(mapped) {
+    throw "Trying to modify a sequence mapped from a file, which is read only.";
+  }
 
   set_field(array, numbits, position, value);
 }
@@ -112,10 +120,10 @@ void LogSequence::save(ofstream &out)
 	size_t numbytes = numBytesFor(numbits, numentries);
 
 	if ((numbytes % 8) != 0) numbytes += 8-(numbytes%8);
-	saveValue<uchar>(out, (uchar*)array, numbytes);
+	MappedFile::saveArray<uchar>(out, (uchar*)array, numbytes);
 }
 
 LogSequence::~LogSequence() 
 {
-	delete [] array;
+	MappedFile::deleteArray(array);
 }
@@ -66,12 +66,18 @@ public:
 	 */
 	size_t getField(size_t position);
 
+	/** Prefetches the word holding an element (to read it later).
+	 *  @param position: the position of the element.
+	 */
+	void prefetch(size_t position) { __builtin_prefetch(&array[((uint64_t)numbits*position)/WLS]); }
+
 	/** Gets the total number of elements in the stream
 	 *  @return int
 	 */
 	size_t getNumberOfElements();
 
-	/** Sets the element in a specific position
+	/** Sets the element in a specific position (the sequence must not
+	 *  be mapped from a file, which is read only)
 	 *  @param position: the position of the new element
 	 *  @param value Value to be inserted.
 	 */
@@ -98,6 +104,7 @@ private:
 	size_t numentries;
 	size_t maxval;
 	size_t *array;
+	bool mapped;	// The array points into a read-only mapping
 
 	static const unsigned int WLS = sizeof(size_t)*8;
 
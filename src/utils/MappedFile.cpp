@@ -0,0 +1,173 @@
+/* MappedFile.cpp
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Read-only memory mapping of a dictionary file stored in the mapped layout.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+
+//a stream registered in the mapped layout
+struct MappedStream
+{
+	bool aligned;		// its header has been read (or written)
+	MappedFile *file;	// the mapping of its file (NULL if it is not mapped)
+};
+
+static mutex mappedLock;
+static map<ios*, MappedStream> mappedStreams;
+static vector<pair<const uchar*, const uchar*> > mappedRanges;
+
+
+
+MappedFile::MappedFile(const char *path)
+{
+	data = NULL;
+	length = 0;
+
+	int fd = open(path, O_RDONLY);
+	if(fd<0)
+	{
+		cerr << "The file " << path << " cannot be opened" << endl;
+		return;
+	}
+
+	struct stat st;
+	if((fstat(fd, &st)==0) && (st.st_size>0))
+	{
+		void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(addr!=MAP_FAILED)
+		{
+			data = (uchar*)addr;
+			length = st.st_size;
+
+			lock_guard<mutex> guard(mappedLock);
+			mappedRanges.push_back(make_pair(data, data+length));
+		}
+	}
+	close(fd);
+
+	if(data==NULL) cerr << "The file " << path << " cannot be mapped" << endl;
+}
+
+void
+MappedFile::writeHeader(ofstream &out)
+{
+	saveValue<uint32_t>(out, MAGIC);
+	saveValue<uint32_t>(out, VERSION);
+
+	lock_guard<mutex> guard(mappedLock);
+	mappedStreams[&out].aligned = true;
+	mappedStreams[&out].file = NULL;
+}
+
+uint32_t
+MappedFile::readHeader(ifstream &in)
+{
+	uint32_t version = loadValue<uint32_t>(in);
+	if((version==0) || (version>VERSION))
+	{
+		cerr << "Version " << version << " of the mapped layout is not supported" << endl;
+		return 0;
+	}
+	if(version==1)
+	{
+		size_t pos = (size_t)in.tellg();
+		in.seekg(pos+(PAGESIZE-pos%PAGESIZE)%PAGESIZE);
+	}
+
+	lock_guard<mutex> guard(mappedLock);
+	mappedStreams[&in].aligned = true; //keeping the mapping attached (NULL if none)
+	return version;
+}
+
+void
+MappedFile::attach(ifstream &in, MappedFile *file)
+{
+	lock_guard<mutex> guard(mappedLock);
+	mappedStreams[&in].aligned = false;
+	mappedStreams[&in].file = file;
+}
+
+void
+MappedFile::follow(ifstream &in, ifstream &from)
+{
+	lock_guard<mutex> guard(mappedLock);
+	map<ios*, MappedStream>::iterator it = mappedStreams.find(&from);
+	if(it!=mappedStreams.end()) mappedStreams[&in] = it->second;
+}
+
+const uchar*
+MappedFile::view(ifstream &in, size_t offset, size_t len)
+{
+	MappedFile *file = NULL;
+	if(!layout(in, &file) || (file==NULL) || (offset+len > file->length)) return NULL;
+	return file->data+offset;
+}
+
+void
+MappedFile::detach(ios &stream)
+{
+	lock_guard<mutex> guard(mappedLock);
+	mappedStreams.erase(&stream);
+}
+
+bool
+MappedFile::layout(ios &stream, MappedFile **file)
+{
+	lock_guard<mutex> guard(mappedLock);
+	map<ios*, MappedStream>::iterator it = mappedStreams.find(&stream);
+	if((it==mappedStreams.end()) || !it->second.aligned) return false;
+
+	if(file!=NULL) *file = it->second.file;
+	return true;
+}
+
+bool
+MappedFile::isMapped(const void *array)
+{
+	const uchar *ptr = (const uchar*)array;
+
+	lock_guard<mutex> guard(mappedLock);
+	for(size_t i=0; i<mappedRanges.size(); i++)
+		if((ptr>=mappedRanges[i].first) && (ptr<=mappedRanges[i].second)) return true;
+	return false;
+}
+
+MappedFile::~MappedFile()
+{
+	if(data==NULL) return;
+
+	{
+		lock_guard<mutex> guard(mappedLock);
+		mappedRanges.erase(find(mappedRanges.begin(), mappedRanges.end(), make_pair((const uchar*)data, (const uchar*)data+length)));
+	}
+	munmap(data, length);
+}
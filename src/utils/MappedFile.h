@@ -0,0 +1,193 @@
+/* MappedFile.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Read-only memory mapping of a dictionary file stored in the mapped layout:
+ * a header (magic number and version) followed by the serialization of the
+ * dictionary, in which the large arrays start at 8-byte aligned offsets. In
+ * version 1 the dictionary starts at the next page; in version 2 it is split
+ * in page-aligned sections listed after the header (see SectionTable).
+ * When a dictionary is loaded from a mapped file, these arrays point into the
+ * mapping instead of being read, so they are loaded almost immediately and
+ * their pages are shared by all the processes mapping the file. The libcds
+ * structures (bitmaps, wavelet trees, permutations) are still read from the
+ * stream onto the heap, as libcds cannot use external memory.
+ *
+ * The streams being saved or loaded in the mapped layout are registered
+ * (with the mapping of the file, if any), so saveArray and loadArray know
+ * how to lay out each array without changing the save/load signatures.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <iostream>
+
+#include <libcdsBasics.h>
+
+using namespace std;
+using namespace cds_utils;
+
+
+class MappedFile
+{
+	public:
+		static const uint32_t MAGIC = 0x4C445343;	// Mapped layout ("CSDL"), distinct from every dictionary type
+		static const uint32_t VERSION = 2;		// Version of the mapped layout (1: a single dictionary; 2: sections)
+		static const size_t PAGESIZE = 4096;		// The dictionary starts at a page boundary
+		static const size_t ALIGNMENT = 8;		// Alignment of the arrays
+
+		/** Maps a file (read only, shared with other processes).
+		    @param path: the file.
+		*/
+		MappedFile(const char *path);
+
+		/** Checks if the file was mapped.
+		    @returns true if the mapping is valid.
+		*/
+		bool good() {return data!=NULL;}
+
+		/** Retrieves the mapping of the file.
+		    @returns the bytes of the file (NULL if it was not mapped).
+		*/
+		const uchar* getData() {return data;}
+
+		/** Retrieves the length of the file.
+		    @returns the length in bytes.
+		*/
+		size_t getLength() {return length;}
+
+		/** Writes the header of the mapped layout (after which the
+		    section directory is written) and registers the stream, so
+		    the arrays saved next are aligned.
+		    @param out: the ofstream.
+		*/
+		static void writeHeader(ofstream &out);
+
+		/** Reads the rest of the header (the magic number has been
+		    read) and registers the stream, so the arrays loaded next
+		    skip their alignment. In version 1 the stream is moved to the
+		    dictionary; in version 2, to the section directory.
+		    @param in: the ifstream.
+		    @returns the version (0 if it is not supported).
+		*/
+		static uint32_t readHeader(ifstream &in);
+
+		/** Registers the mapping of the file read by a stream: the
+		    arrays loaded from it (once its header is read) point into
+		    the mapping.
+		    @param in: the ifstream.
+		    @param file: the mapping.
+		*/
+		static void attach(ifstream &in, MappedFile *file);
+
+		/** Registers a stream reading the same file as another one (with
+		    its layout and mapping), to load a section in parallel.
+		    @param in: the new ifstream.
+		    @param from: the ifstream registered.
+		*/
+		static void follow(ifstream &in, ifstream &from);
+
+		/** Retrieves a range of the mapping of the file read by a stream.
+		    @param in: the ifstream.
+		    @param offset: position of the range in the file.
+		    @param len: length of the range.
+		    @returns the range (NULL if the file is not mapped or the
+		      range is out of it).
+		*/
+		static const uchar* view(ifstream &in, size_t offset, size_t len);
+
+		/** Unregisters a stream (when its dictionary is saved or loaded).
+		    @param stream: the stream.
+		*/
+		static void detach(ios &stream);
+
+		/** Checks if an array points into a mapping.
+		    @param array: the array.
+		    @returns true if it must not be deleted.
+		*/
+		static bool isMapped(const void *array);
+
+		/** Stores an array which may be mapped on loading.
+		    @param out: the ofstream.
+		    @param array: the array.
+		    @param n: number of values.
+		*/
+		template <typename T> static void saveArray(ofstream &out, T *array, size_t n)
+		{
+			if(layout(out, NULL))
+			{
+				size_t pad = padding((size_t)out.tellp());
+				for(size_t i=0; i<pad; i++) out.put(0);
+			}
+			saveValue<T>(out, array, n);
+		}
+
+		/** Loads an array stored by saveArray (pointing into the mapping
+		    if the stream has one). A mapped array is read only: the
+		    structures which modify their arrays check isMapped first.
+		    @param in: the ifstream.
+		    @param n: number of values.
+		    @returns the array (to be released with deleteArray).
+		*/
+		template <typename T> static T* loadArray(ifstream &in, size_t n)
+		{
+			MappedFile *file = NULL;
+			if(layout(in, &file))
+			{
+				size_t pos = (size_t)in.tellg();
+				pos += padding(pos);
+				if((file!=NULL) && (pos+n*sizeof(T) <= file->length))
+				{
+					in.seekg(pos+n*sizeof(T));
+					return (T*)(file->data+pos);
+				}
+				in.seekg(pos);
+			}
+			return loadValue<T>(in, n);
+		}
+
+		/** Releases an array loaded by loadArray (nothing is done if it
+		    points into a mapping).
+		    @param array: the array.
+		*/
+		template <typename T> static void deleteArray(T *array)
+		{
+			if((array!=NULL) && !isMapped(array)) delete [] array;
+		}
+
+		/** Unmaps the file. */
+		~MappedFile();
+
+	protected:
+		uchar *data;	// The mapping (NULL if the file could not be mapped)
+		size_t length;	// Length of the file
+
+		// Checks if a stream uses the mapped layout (and retrieves its mapping)
+		static bool layout(ios &stream, MappedFile **file);
+
+		// Bytes to skip from a position to the next aligned one
+		static size_t padding(size_t pos) {return (ALIGNMENT-pos%ALIGNMENT)%ALIGNMENT;}
+};
+
+#endif
@@ -0,0 +1,93 @@
+/* MemoryUsage.cpp
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Resident memory of the process (read from /proc/self/status), reported
+ * by phases while a dictionary is built.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#include "MemoryUsage.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool MemoryUsage::report = false;
+
+
+
+size_t
+MemoryUsage::current()
+{
+	return status("VmRSS:");
+}
+
+size_t
+MemoryUsage::peak()
+{
+	return status("VmHWM:");
+}
+
+void
+MemoryUsage::resetPeak()
+{
+	//writing 5 to clear_refs resets the peak resident memory (Linux 4.0 and later)
+	FILE *refs = fopen("/proc/self/clear_refs", "w");
+	if(refs==NULL) return;
+	fputs("5", refs);
+	fclose(refs);
+}
+
+void
+MemoryUsage::setReport(bool enabled)
+{
+	report = enabled;
+	if(report) resetPeak();
+}
+
+void
+MemoryUsage::phase(const char *name)
+{
+	if(!report) return;
+
+	cerr << "[MEM] " << name << ": peak " << (peak()>>20) << " MB, current " << (current()>>20) << " MB" << endl;
+	resetPeak();
+}
+
+size_t
+MemoryUsage::status(const char *field)
+{
+	FILE *file = fopen("/proc/self/status", "r");
+	if(file==NULL) return 0;
+
+	char line[256];
+	size_t len = strlen(field), kb = 0;
+	while(fgets(line, sizeof(line), file)!=NULL)
+	{
+		if(strncmp(line, field, len)==0)
+		{
+			kb = strtoull(line+len, NULL, 10);
+			break;
+		}
+	}
+	fclose(file);
+	return kb<<10;
+}
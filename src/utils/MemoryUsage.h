@@ -0,0 +1,74 @@
+/* MemoryUsage.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Resident memory of the process (read from /proc/self/status), reported
+ * by phases while a dictionary is built: each report gives the peak since
+ * the previous one, so the phase dominating the memory of a build can be
+ * identified.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _MEMORYUSAGE_H
+#define _MEMORYUSAGE_H
+
+#include <stddef.h>
+#include <iostream>
+
+using namespace std;
+
+
+class MemoryUsage
+{
+	public:
+		/** Retrieves the resident memory of the process.
+		    @returns the memory in bytes (0 if it is not available).
+		*/
+		static size_t current();
+
+		/** Retrieves the peak resident memory since the last reset
+		    (since the start of the process if the peak cannot be reset).
+		    @returns the memory in bytes (0 if it is not available).
+		*/
+		static size_t peak();
+
+		/** Resets the peak to the current resident memory. */
+		static void resetPeak();
+
+		/** Enables or disables the reports of the phases (disabled by
+		    default).
+		    @param enabled: true for reporting them.
+		*/
+		static void setReport(bool enabled);
+
+		/** Ends a phase: if the reports are enabled, writes its peak and
+		    the current memory to cerr and resets the peak.
+		    @param name: name of the phase.
+		*/
+		static void phase(const char *name);
+
+	protected:
+		static bool report;	// The phases are reported
+
+		// Retrieves a field (in kB) of /proc/self/status, in bytes
+		static size_t status(const char *field);
+};
+
+#endif
@@ -0,0 +1,244 @@
+/* SectionTable.cpp
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Directory of the sections of a dictionary stored in the mapped layout.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#include "SectionTable.h"
+#include "MappedFile.h"
+
+#include <string.h>
+
+//buffer which forwards the bytes to the buffer of the stream, computing their checksum
+class ChecksumBuf : public streambuf
+{
+	public:
+		ChecksumBuf(streambuf *target) {this->target = target;}
+
+		SectionChecksum checksum;
+
+	protected:
+		streambuf *target;
+
+		int overflow(int c)
+		{
+			if(c == EOF) return 0;
+			uchar byte = (uchar)c;
+			if(target->sputc(byte) == EOF) return EOF;
+			checksum.update(&byte, 1);
+			return c;
+		}
+
+		streamsize xsputn(const char *s, streamsize n)
+		{
+			streamsize written = target->sputn(s, n);
+			checksum.update((const uchar*)s, written);
+			return written;
+		}
+
+		//only the current position can be asked (tellp)
+		pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which)
+		{
+			if((off == 0) && (dir == ios_base::cur)) return target->pubseekoff(0, ios_base::cur, which);
+			return pos_type(off_type(-1));
+		}
+
+		int sync() {return target->pubsync();}
+};
+
+
+
+void
+SectionChecksum::update(const uchar *data, size_t len)
+{
+	//complete the pending word
+	while((len > 0) && (pending > 0))
+	{
+		word |= (uint32_t)(*data) << (8*pending);
+		data++; len--;
+		if(++pending == 4) {add(word); word = 0; pending = 0;}
+	}
+
+	for(; len >= 4; data += 4, len -= 4)
+	{
+		uint32_t w;
+		memcpy(&w, data, 4);
+		add(w);
+	}
+
+	for(; len > 0; data++, len--)
+		word |= (uint32_t)(*data) << (8*pending++);
+}
+
+uint64_t
+SectionChecksum::value()
+{
+	uint64_t s1 = sum1, s2 = sum2;
+	if(pending > 0)
+	{
+		s1 += word; if(s1 >= MOD) s1 -= MOD;
+		s2 += s1; if(s2 >= MOD) s2 -= MOD;
+	}
+	return (s2 << 32) | s1;
+}
+
+
+
+SectionTable::SectionTable(uint sections)
+{
+	entries.resize(sections);
+	position = 0;
+	target = NULL;
+	filter = NULL;
+}
+
+void
+SectionTable::reserve(ofstream &out)
+{
+	position = (uint64_t)out.tellp();
+	write(out);
+}
+
+void
+SectionTable::begin(ofstream &out, uint section)
+{
+	while(((size_t)out.tellp())%MappedFile::PAGESIZE != 0) out.put(0);
+	entries[section].offset = (uint64_t)out.tellp();
+
+	//ofstream hides the rdbuf of ios which replaces the buffer
+	target = out.rdbuf();
+	filter = new ChecksumBuf(target);
+	static_cast<ostream&>(out).rdbuf(filter);
+}
+
+void
+SectionTable::end(ofstream &out, uint section)
+{
+	out.flush();
+	static_cast<ostream&>(out).rdbuf(target);
+
+	entries[section].length = (uint64_t)out.tellp()-entries[section].offset;
+	entries[section].checksum = ((ChecksumBuf*)filter)->checksum.value();
+	delete filter;
+	filter = NULL;
+}
+
+void
+SectionTable::write(ofstream &out)
+{
+	streampos last = out.tellp();
+	out.seekp(position);
+
+	saveValue<uint32_t>(out, entries.size());
+	for(size_t i=0; i<entries.size(); i++)
+	{
+		saveValue<uint64_t>(out, entries[i].offset);
+		saveValue<uint64_t>(out, entries[i].length);
+		saveValue<uint64_t>(out, entries[i].checksum);
+	}
+
+	if(last > (streampos)position) out.seekp(last);
+}
+
+bool
+SectionTable::read(ifstream &in)
+{
+	uint32_t sections = loadValue<uint32_t>(in);
+	if(!in.good() || (sections == 0) || (sections > MappedFile::PAGESIZE/sizeof(Entry)))
+	{
+		cerr << "The section directory of the dictionary is not valid" << endl;
+		return false;
+	}
+
+	entries.resize(sections);
+	for(size_t i=0; i<entries.size(); i++)
+	{
+		entries[i].offset = loadValue<uint64_t>(in);
+		entries[i].length = loadValue<uint64_t>(in);
+		entries[i].checksum = loadValue<uint64_t>(in);
+	}
+	return in.good();
+}
+
+bool
+SectionTable::verify(ifstream &in, uint section)
+{
+	Entry &entry = entries[section];
+	SectionChecksum checksum;
+
+	const uchar *mapped = MappedFile::view(in, entry.offset, entry.length);
+	if(mapped != NULL) checksum.update(mapped, entry.length);
+	else
+	{
+		//read the section in chunks
+		in.clear();
+		in.seekg(entry.offset);
+		uchar *chunk = new uchar[1<<20];
+		uint64_t left = entry.length;
+		while(left > 0 && in.good())
+		{
+			size_t len = (left < (1<<20)) ? left : (1<<20);
+			in.read((char*)chunk, len);
+			checksum.update(chunk, in.gcount());
+			left -= in.gcount();
+		}
+		delete [] chunk;
+		if(left > 0)
+		{
+			cerr << "The section " << section << " of the dictionary is truncated" << endl;
+			return false;
+		}
+	}
+
+	if(checksum.value() != entry.checksum)
+	{
+		cerr << "The section " << section << " of the dictionary is corrupt (checksum mismatch)" << endl;
+		return false;
+	}
+
+	in.clear();
+	in.seekg(entry.offset);
+	return true;
+}
+
+bool
+SectionTable::open(ifstream &in, uint section, bool check)
+{
+	if(check) return verify(in, section);
+
+	Entry &entry = entries[section];
+	in.clear();
+	in.seekg(0, ios::end);
+	if((uint64_t)in.tellg() < entry.offset+entry.length)
+	{
+		cerr << "The section " << section << " of the dictionary is truncated" << endl;
+		return false;
+	}
+
+	in.seekg(entry.offset);
+	return true;
+}
+
+SectionTable::~SectionTable()
+{
+	if(filter != NULL) delete filter;
+}
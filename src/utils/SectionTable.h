@@ -0,0 +1,163 @@
+/* SectionTable.h
+ * Copyright (C) 2016, Álvaro Alonso
+ * all rights reserved.
+ *
+ * Directory of the sections of a dictionary stored in the mapped layout
+ * (version 2): after the header, the number of sections and the offset,
+ * length and checksum (Fletcher-64) of each one. Each section starts at a
+ * page boundary and holds independent components of the dictionary, so
+ * they are verified and loaded separately (in parallel when the file is
+ * mapped).
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ * Contacting the authors:
+ *   Álvaro Alonso:  	alvaro.alonso.isla@alumnos.uva.es
+ */
+
+#ifndef _SECTIONTABLE_H
+#define _SECTIONTABLE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <libcdsBasics.h>
+
+using namespace std;
+using namespace cds_utils;
+
+
+/** Fletcher-64 checksum of a sequence of bytes (taken as 32-bit words,
+    the last one padded with zeros), computed incrementally.
+*/
+class SectionChecksum
+{
+	public:
+		SectionChecksum() {sum1 = 0; sum2 = 0; word = 0; pending = 0;}
+
+		/** Adds bytes to the checksum.
+		    @param data: the bytes.
+		    @param len: number of bytes.
+		*/
+		void update(const uchar *data, size_t len);
+
+		/** Retrieves the checksum of the bytes added.
+		    @returns the checksum.
+		*/
+		uint64_t value();
+
+	protected:
+		static const uint64_t MOD = 0xFFFFFFFFULL;
+
+		uint64_t sum1, sum2;	// The two sums (mod 2^32-1)
+		uint32_t word;		// Bytes of the incomplete word
+		uint pending;		// Number of bytes of the incomplete word
+
+		void add(uint32_t w)
+		{
+			sum1 += w; if(sum1 >= MOD) sum1 -= MOD;
+			sum2 += sum1; if(sum2 >= MOD) sum2 -= MOD;
+		}
+};
+
+
+class SectionTable
+{
+	public:
+		/** Creates the directory for writing a dictionary.
+		    @param sections: number of sections.
+		*/
+		SectionTable(uint sections=0);
+
+		/** Retrieves the number of sections.
+		    @returns the number of sections.
+		*/
+		uint size() {return entries.size();}
+
+		/** Retrieves the position of a section in the file.
+		    @param section: the section.
+		    @returns the offset in bytes.
+		*/
+		uint64_t getOffset(uint section) {return entries[section].offset;}
+
+		/** Writes the directory (with empty entries, which are filled in
+		    by write once the sections are stored).
+		    @param out: the ofstream, after the header of the layout.
+		*/
+		void reserve(ofstream &out);
+
+		/** Starts a section: moves to the next page and computes the
+		    checksum of everything saved until end is called.
+		    @param out: the ofstream.
+		    @param section: the section.
+		*/
+		void begin(ofstream &out, uint section);
+
+		/** Ends the section started by begin.
+		    @param out: the ofstream.
+		    @param section: the section.
+		*/
+		void end(ofstream &out, uint section);
+
+		/** Fills in the directory written by reserve (and moves to the
+		    end of the file).
+		    @param out: the ofstream.
+		*/
+		void write(ofstream &out);
+
+		/** Reads the directory.
+		    @param in: the ifstream, after the header of the layout.
+		    @returns false if it is not valid.
+		*/
+		bool read(ifstream &in);
+
+		/** Checks the checksum of a section (in the mapping of the file
+		    if the stream has one) and moves the stream to its start.
+		    @param in: the ifstream.
+		    @param section: the section.
+		    @returns false if the section is corrupt.
+		*/
+		bool verify(ifstream &in, uint section);
+
+		/** Moves the stream to the start of a section, verifying it
+		    first if requested. Otherwise only its bounds are checked, so
+		    its pages are not read.
+		    @param in: the ifstream.
+		    @param section: the section.
+		    @param check: true to verify its checksum.
+		    @returns false if the section is corrupt or truncated.
+		*/
+		bool open(ifstream &in, uint section, bool check);
+
+		~SectionTable();
+
+	protected:
+		struct Entry
+		{
+			uint64_t offset;	// Position of the section in the file
+			uint64_t length;	// Length in bytes
+			uint64_t checksum;	// Fletcher-64 of its bytes
+		};
+
+		vector<Entry> entries;	// The directory
+		uint64_t position;	// Position of the directory in the file
+		streambuf *target;	// The buffer of the stream while a section is written
+		streambuf *filter;	// The buffer computing the checksum of the section
+};
+
+#endif
@@ -81,6 +81,7 @@ static const uint32_t DXBW = 5;			// XBW dictionary (with plain: RG and compress
 
 static const uint32_t RDS = 990;		//Ranked Dictionary Simple
 static const uint32_t RDRPDAC = 991;		//Ranked Dictionary RPDAC
+static const uint32_t RDRMQ = 992;		//Ranked Dictionary RMQ
 
 inline uint
 encodeVB2(uint c, uchar *r)